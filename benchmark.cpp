@@ -0,0 +1,200 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that time the image operations on images stored in rows and in tiles
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of times each operation is timed. The fastest time is reported.
+ */
+const int BENCH_RUNS = 3;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if two images have the same dimensions and the same pixels in every channel.
+  *
+  * @param[in] a - the first image.
+  * @param[in] b - the second image.
+  *
+  * @returns true if the images are the same
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    sameImage(img, img);
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool sameImage(image& a, image& b)
+{
+    size_t size = (size_t)a.rows * a.cols;
+
+    if (a.rows != b.rows || a.cols != b.cols)
+    {
+        return false;
+    }
+
+    return memcmp(a.redGray[0], b.redGray[0], size) == 0 && memcmp(a.green[0], b.green[0], size) == 0 &&
+        memcmp(a.blue[0], b.blue[0], size) == 0;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the number of milliseconds since start.
+  *
+  * @param[in] start - the time to measure from.
+  *
+  * @returns the elapsed time in milliseconds
+  *
+  * @par Example:
+    @verbatim
+
+    auto start = chrono::steady_clock::now();
+
+    rotateClockWise(img);
+
+    double ms = elapsedMs(start);
+
+    @endverbatim
+
+  ***********************************************************************/
+static double elapsedMs(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads an image and times every operation in imageOperations.cpp on it, once with the image
+  * stored in rows and once with it stored in tiles. Each operation is run BENCH_RUNS times on a
+  * fresh copy of the image and the fastest time is kept. The time to convert the image to tiles and
+  * back is measured separately, since a chain of operations only pays for it once. The results of
+  * the two layouts are compared, and a table with one line per operation is outputted.
+  *
+  * @param[in] filename - the image to time the operations on.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    c:\> thpExam1.exe --benchmark big.ppm
+
+    Operation      Rows (ms)  Tiles (ms)  Convert (ms)  Same
+    --rotateCW         41.20       12.85          9.71  yes
+    ...
+
+    @endverbatim
+
+  ***********************************************************************/
+void runBenchmark(string filename)
+{
+    //loop variables
+    int k = 0;
+    int run = 0;
+
+    ifstream fin;
+    image img;
+    image rowWork;
+    image tileWork;
+    tiledImage t;
+    int max_pix_val = 0;
+    bool grayOutput = false;
+
+    double rowMs, tileMs, convertMs, ms;
+    chrono::steady_clock::time_point start;
+
+    const char* names[6] = { "--rotateCW", "--rotateCCW", "--flipX", "--flipY", "--grayscale", "--sepia" };
+    operation op;
+
+    if (!(openInputFile(fin, filename)))
+    {
+        cout << "Unable to open input file: " << filename << endl;
+        exit(0);
+    }
+
+    readMagicNum(fin, img, max_pix_val);
+
+    //only the colors are timed
+    free2D(img.alpha, img.rows);
+
+    fin.clear();
+    fin.close();
+
+    cout << img.cols << " x " << img.rows << ", " << threadCount() << " threads" << endl;
+    cout << left << setw(15) << "Operation" << right << setw(10) << "Rows (ms)" << setw(12) << "Tiles (ms)"
+        << setw(14) << "Convert (ms)" << "  Same" << endl;
+
+    for (k = 0; k < 6; k++)
+    {
+        op.option = names[k];
+
+        rowMs = tileMs = convertMs = 1e300;
+
+        for (run = 0; run < BENCH_RUNS; run++)
+        {
+            //stored in rows
+            copyImage(img, rowWork);
+
+            start = chrono::steady_clock::now();
+            applyOperation(rowWork, op, grayOutput);
+            rowMs = min(rowMs, elapsedMs(start));
+
+            //stored in tiles
+            copyImage(img, tileWork);
+
+            start = chrono::steady_clock::now();
+            toTiled(tileWork, t);
+            ms = elapsedMs(start);
+
+            start = chrono::steady_clock::now();
+            applyTiledOperation(t, op, grayOutput);
+            tileMs = min(tileMs, elapsedMs(start));
+
+            start = chrono::steady_clock::now();
+            fromTiled(t, tileWork);
+            convertMs = min(convertMs, ms + elapsedMs(start));
+
+            if (run < BENCH_RUNS - 1)
+            {
+                free2D(rowWork.redGray, rowWork.rows);
+                free2D(rowWork.green, rowWork.rows);
+                free2D(rowWork.blue, rowWork.rows);
+
+                free2D(tileWork.redGray, tileWork.rows);
+                free2D(tileWork.green, tileWork.rows);
+                free2D(tileWork.blue, tileWork.rows);
+            }
+        }
+
+        cout << left << setw(15) << names[k] << right << fixed << setprecision(2) << setw(10) << rowMs
+            << setw(12) << tileMs << setw(14) << convertMs << (sameImage(rowWork, tileWork) ? "  yes" : "  no") << endl;
+
+        free2D(rowWork.redGray, rowWork.rows);
+        free2D(rowWork.green, rowWork.rows);
+        free2D(rowWork.blue, rowWork.rows);
+
+        free2D(tileWork.redGray, tileWork.rows);
+        free2D(tileWork.green, tileWork.rows);
+        free2D(tileWork.blue, tileWork.rows);
+    }
+
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+}
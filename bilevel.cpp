@@ -0,0 +1,425 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that make black and white images and pack and unpack them 8 pixels to a byte
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the bits are packed and unpacked one pixel at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BILEVEL_SSE2
+#endif
+
+/**
+ * @brief Number of pixels of black and white image data decoded or encoded at a time.
+ */
+const size_t BILEVEL_BATCH = 1 << 22;
+
+/**
+ * @brief Number of bytes of P1 text read at a time.
+ */
+const size_t BILEVEL_TEXT_CHUNK = 1 << 20;
+
+/**
+ * @brief A P1 line is broken after this many digits, the longest line the format allows.
+ */
+const int BILEVEL_LINE = 70;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if the image is black and white, which is the case once it has been read from a
+  * P1 or P4 file or converted with thresholdImage. Its pixels are then 0 for black and 255 for white,
+  * and it is written as P1 or P4.
+  *
+  * @param[in] img - a strucutre of type image.
+  *
+  * @returns true if the image is black and white
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    img.magicNumber = "P4";
+
+    isBilevel(img);
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+bool isBilevel(const image& img)
+{
+    return img.magicNumber == "P1" || img.magicNumber == "P4";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Turns a grayscale image black and white. Pixels at or above level become 255, the others 0, and
+  * the result is stored in all three channels the way a grayscale file is read. The image is marked
+  * as a P4 image so that it is written with 8 pixels to a byte. The rows are split across threads.
+  *
+  * @param[in,out] img - the grayscale image, in img.redGray.
+  * @param[in] level - the lowest value that becomes white.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    convertGrayScale(img);
+    thresholdImage(img, 128);
+
+    //every pixel of img is 0 or 255
+
+    @endverbatim
+
+  ***********************************************************************/
+void thresholdImage(image& img, int level)
+{
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i = 0;
+        int j = 0;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            for (j = 0; j < img.cols; j++)
+            {
+                img.redGray[i][j] = img.green[i][j] = img.blue[i][j] = img.redGray[i][j] >= level ? 255 : 0;
+            }
+        }
+    });
+
+    img.magicNumber = "P4";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Packs a row of grayscale pixels into bits, 8 pixels to a byte with the first pixel in the highest
+  * bit, as P4 stores them. A bit is 1 for black, which is any value below 128. The top bit of a byte is
+  * set exactly when it is 128 or more, so with SSE2 a movemask of 16 pixels gives their white bits at
+  * once, which are inverted and put in file order with a table. The last byte is padded with 0 bits.
+  *
+  * @param[in] gray - the pixels.
+  * @param[in] cols - the number of pixels.
+  * @param[out] out - the (cols + 7) / 8 packed bytes.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel gray[3] = { 0, 255, 0 };
+    unsigned char packed;
+
+    packBits(gray, 3, &packed);
+
+    //packed is 10100000 in binary
+
+    @endverbatim
+
+  ***********************************************************************/
+static void packBits(const pixel* gray, int cols, unsigned char* out)
+{
+    //loop variables
+    int j = 0;
+    int k = 0;
+
+    unsigned char bits = 0;
+
+    //the black bits of 8 white bits, in file order
+    static const vector<unsigned char> black = []()
+    {
+        int m = 0;
+        int b = 0;
+        vector<unsigned char> values(256);
+
+        for (m = 0; m < 256; m++)
+        {
+            for (b = 0; b < 8; b++)
+            {
+                if (!(m & (1 << b)))
+                {
+                    values[m] |= (unsigned char)(0x80 >> b);
+                }
+            }
+        }
+
+        return values;
+    }();
+
+#ifdef BILEVEL_SSE2
+    int mask = 0;
+
+    for (j = 0; j + 16 <= cols; j += 16)
+    {
+        mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(gray + j)));
+
+        out[j / 8] = black[mask & 0xff];
+        out[j / 8 + 1] = black[mask >> 8];
+    }
+#endif
+
+    for (; j < cols; j += 8)
+    {
+        bits = 0;
+
+        for (k = 0; k < 8 && j + k < cols; k++)
+        {
+            if (gray[j + k] < 128)
+            {
+                bits |= (unsigned char)(0x80 >> k);
+            }
+        }
+
+        out[j / 8] = bits;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Unpacks a row of P4 bits into grayscale pixels, 0 for a 1 bit and 255 for a 0 bit. With SSE2 two
+  * bytes are spread over 16 lanes, each lane keeps its own bit, and a compare against zero turns the
+  * bits into 0 or 255 for 16 pixels at once.
+  *
+  * @param[in] in - the (cols + 7) / 8 packed bytes.
+  * @param[in] cols - the number of pixels.
+  * @param[out] gray - the pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned char packed = 0xa0;
+    pixel gray[3];
+
+    unpackBits(&packed, 3, gray);
+
+    //gray is 0, 255, 0
+
+    @endverbatim
+
+  ***********************************************************************/
+static void unpackBits(const unsigned char* in, int cols, pixel* gray)
+{
+    //loop variable
+    int j = 0;
+
+#ifdef BILEVEL_SSE2
+    const __m128i lanes = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10, 8, 4, 2, 1, (char)0x80, 0x40, 0x20, 0x10, 8, 4, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes;
+
+    for (j = 0; j + 16 <= cols; j += 16)
+    {
+        bytes = _mm_unpacklo_epi64(_mm_set1_epi8((char)in[j / 8]), _mm_set1_epi8((char)in[j / 8 + 1]));
+        _mm_storeu_si128((__m128i*)(gray + j), _mm_cmpeq_epi8(_mm_and_si128(bytes, lanes), zero));
+    }
+#endif
+
+    for (; j < cols; j++)
+    {
+        gray[j] = in[j / 8] & (0x80 >> (j % 8)) ? 0 : 255;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the image data of a P1 or P4 file a batch of rows at a time and hands each batch to consume
+  * as grayscale pixels, 0 for black and 255 for white. P4 rows are (cols + 7) / 8 bytes and are unpacked
+  * in parallel. P1 data is the digits 0 and 1, with or without whitespace between them. If the file ends
+  * early, the missing pixels are white, as if the file held 0 bits.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the image data.
+  * @param[in] img - the image with the size from the header.
+  * @param[in] ascii - true for P1, false for P4.
+  * @param[in] consume - called with the pixels of each batch and its number of rows.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readHeader(fin, img, max_pix_val);
+
+    streamBilevelRows(fin, img, false, [&](const pixel* rows, int n)
+    {
+        //rows holds n * img.cols pixels
+    });
+
+    @endverbatim
+
+  ***********************************************************************/
+void streamBilevelRows(ifstream& bfin, const image& img, bool ascii, const function<void(const pixel*, int)>& consume)
+{
+    //loop variables
+    int i = 0;
+    size_t k = 0;
+
+    int batchRows = (int)max<size_t>(1, BILEVEL_BATCH / img.cols);
+    int n = 0;
+    size_t rowBytes = ((size_t)img.cols + 7) / 8;
+    size_t filled = 0;
+    size_t length = 0;
+
+    vector<pixel> gray;
+    vector<unsigned char> packed;
+    vector<char> text;
+
+    if (ascii)
+    {
+        text.resize(BILEVEL_TEXT_CHUNK);
+    }
+
+    for (i = 0; i < img.rows; i += n)
+    {
+        n = min(batchRows, img.rows - i);
+        gray.assign((size_t)n * img.cols, 255);
+
+        //digits until the batch is full, the rest of a chunk waits for the next batch
+        if (ascii)
+        {
+            filled = 0;
+
+            while (filled < gray.size())
+            {
+                if (k == length)
+                {
+                    bfin.read(text.data(), text.size());
+                    length = (size_t)bfin.gcount();
+                    k = 0;
+
+                    if (length == 0)
+                    {
+                        break;
+                    }
+                }
+
+                for (; k < length && filled < gray.size(); k++)
+                {
+                    if (text[k] == '0' || text[k] == '1')
+                    {
+                        gray[filled++] = text[k] == '1' ? 0 : 255;
+                    }
+                }
+            }
+        }
+
+        //packed rows, unpacked in parallel
+        else
+        {
+            packed.assign((size_t)n * rowBytes, 0);
+            bfin.read((char*)packed.data(), packed.size());
+
+            parallelFor(0, n, [&](int rowStart, int rowEnd)
+            {
+                int r = 0;
+
+                for (r = rowStart; r < rowEnd; r++)
+                {
+                    unpackBits(packed.data() + r * rowBytes, img.cols, gray.data() + (size_t)r * img.cols);
+                }
+            });
+        }
+
+        consume(gray.data(), n);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes rows of grayscale pixels as P1 or P4 image data, with any value below 128 black. For P4 the
+  * rows are packed into bits in parallel and written at once. For P1 each pixel is a digit, 1 for black,
+  * with a line break after every BILEVEL_LINE digits and at the end of each row.
+  *
+  * @param[in,out] fout - the output file stream, after the header.
+  * @param[in] gray - the pixels, rows * cols of them.
+  * @param[in] cols - the width of the image.
+  * @param[in] rows - the number of rows.
+  * @param[in] ascii - true for P1, false for P4.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fout << "P4\n" << img.cols << " " << img.rows << "\n";
+
+    writeBilevelRows(fout, band.data(), img.cols, img.rows, false);
+
+    @endverbatim
+
+  ***********************************************************************/
+void writeBilevelRows(ostream& fout, const pixel* gray, int cols, int rows, bool ascii)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    size_t rowBytes = ((size_t)cols + 7) / 8;
+
+    vector<unsigned char> packed;
+    string text;
+
+    if (!ascii)
+    {
+        packed.resize((size_t)rows * rowBytes);
+
+        parallelFor(0, rows, [&](int rowStart, int rowEnd)
+        {
+            int r = 0;
+
+            for (r = rowStart; r < rowEnd; r++)
+            {
+                packBits(gray + (size_t)r * cols, cols, packed.data() + r * rowBytes);
+            }
+        });
+
+        fout.write((char*)packed.data(), packed.size());
+        return;
+    }
+
+    text.reserve((size_t)rows * (cols + cols / BILEVEL_LINE + 1));
+
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < cols; j++)
+        {
+            text += gray[(size_t)i * cols + j] < 128 ? '1' : '0';
+
+            if (j % BILEVEL_LINE == BILEVEL_LINE - 1 && j != cols - 1)
+            {
+                text += '\n';
+            }
+        }
+
+        text += '\n';
+    }
+
+    fout.write(text.data(), text.size());
+}
@@ -0,0 +1,572 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the functions of the --cache option, which keeps the output files of earlier
+ *          runs on disk and copies them out again when the same input, options, and output type
+ *          come back
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Most bytes of output files the cache keeps. Past it the least recently used are removed.
+ */
+const unsigned long long CACHE_BYTES = 1ULL << 30;
+
+/**
+ * @brief Number of bytes of the input file hashed at a time.
+ */
+const size_t CACHE_CHUNK = 1 << 20;
+
+
+/**
+ * @brief One output file kept in the cache.
+ */
+struct cacheEntry
+{
+    string key;                     /**< The key of the run, also the name of the file in the cache. */
+    string extension;               /**< The extension the output file was written with. */
+    unsigned long long bytes = 0;   /**< Size of the file. */
+    unsigned long long lastUse = 0; /**< The clock of the index when the file was last stored or copied out. */
+};
+
+
+/**
+ * @brief The index of a cache directory, kept in the file "index" in it.
+ */
+struct cacheIndex
+{
+    unsigned long long hits = 0;    /**< Number of runs whose output was copied out of the cache. */
+    unsigned long long misses = 0;  /**< Number of runs whose output was not in the cache. */
+    unsigned long long clock = 0;   /**< Counts every use, so a larger lastUse is more recent. */
+    vector<cacheEntry> entries;     /**< The files in the cache. */
+};
+
+
+/**
+ * @brief Guards the index of the cache between the threads of a --batch run.
+ */
+static mutex cacheLock;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the index of a cache directory. A directory without an index is an empty cache.
+  *
+  * @param[in] dir - the cache directory.
+  * @param[out] index - the index.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    cacheIndex index;
+
+    readCacheIndex("cache", index);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void readCacheIndex(string dir, cacheIndex& index)
+{
+    ifstream fin;
+    string word;
+    cacheEntry entry;
+
+    index = cacheIndex();
+
+    fin.open((filesystem::path(dir) / "index").string());
+
+    if (!fin.is_open())
+    {
+        return;
+    }
+
+    fin >> word >> index.hits >> word >> index.misses >> word >> index.clock;
+
+    while (fin >> entry.key >> entry.extension >> entry.bytes >> entry.lastUse)
+    {
+        index.entries.push_back(entry);
+    }
+
+    fin.close();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes the index of a cache directory. The index is written to a file beside it and then
+  * renamed over it, so a run that stops part way through never leaves half an index behind.
+  *
+  * @param[in] dir - the cache directory.
+  * @param[in] index - the index.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    index.hits++;
+
+    writeCacheIndex("cache", index);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void writeCacheIndex(string dir, const cacheIndex& index)
+{
+    //loop variable
+    size_t k = 0;
+
+    ofstream fout;
+    error_code error;
+    filesystem::path name = filesystem::path(dir) / "index";
+
+    fout.open(name.string() + ".tmp", ios::out | ios::trunc);
+
+    if (!fout.is_open())
+    {
+        return;
+    }
+
+    fout << "hits " << index.hits << " misses " << index.misses << " clock " << index.clock << "\n";
+
+    for (k = 0; k < index.entries.size(); k++)
+    {
+        fout << index.entries[k].key << " " << index.entries[k].extension << " " << index.entries[k].bytes << " "
+             << index.entries[k].lastUse << "\n";
+    }
+
+    fout.close();
+
+    filesystem::rename(name.string() + ".tmp", name, error);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the xxHash64 of the bytes of a file, read CACHE_CHUNK bytes at a time.
+  *
+  * @param[in] filename - the file.
+  * @param[out] hash - the hash.
+  *
+  * @returns true if the file was read
+  * @returns false if it could not be opened
+  *
+  * @par Example:
+    @verbatim
+
+    hashFile("cats.ppm", hash);
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool hashFile(string filename, unsigned long long& hash)
+{
+    ifstream fin;
+    xxHashState state;
+    vector<char> buffer(CACHE_CHUNK);
+
+    fin.open(filename, ios::in | ios::binary);
+
+    if (!fin.is_open())
+    {
+        return false;
+    }
+
+    xxHashInit(state, 0);
+
+    while (fin.read(buffer.data(), buffer.size()) || fin.gcount() > 0)
+    {
+        xxHashUpdate(state, buffer.data(), (size_t)fin.gcount());
+    }
+
+    fin.close();
+
+    hash = xxHashFinal(state);
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Removes the --cache option from the operations, so that the rest of the program never sees it,
+  * and returns its directory. If --cache was given more than once the last one is used.
+  *
+  * @param[in,out] ops - the operations from the command line.
+  * @param[out] dir - the cache directory.
+  *
+  * @returns true if there was a --cache option
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --cache cache --sepia --binary old cats.ppm
+    takeCacheDir(ops, dir);
+
+    //returns true, dir is "cache" and ops only holds --sepia
+
+    @endverbatim
+
+  ***********************************************************************/
+bool takeCacheDir(vector<operation>& ops, string& dir)
+{
+    //loop variable
+    size_t i = 0;
+
+    bool found = false;
+
+    while (i < ops.size())
+    {
+        if (ops[i].option == "--cache")
+        {
+            dir = ops[i].args[0];
+            ops.erase(ops.begin() + i);
+            found = true;
+        }
+
+        else
+        {
+            i++;
+        }
+    }
+
+    return found;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the key of a run in the cache. The key is the xxHash64 of the bytes of the input file,
+  * followed by the xxHash64 of the operations, their arguments, the output type, and whether the
+  * output is compressed, one per line, each as 16 hex digits. An image stamped by --overlay is part
+  * of the result, so the hash of its bytes goes on its line. Two runs with the same key write the
+  * same bytes. Returns an empty string if a file cannot be read.
+  *
+  * @param[in] filename - the input file.
+  * @param[in] ops - the operations, without --cache.
+  * @param[in] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[in] basename - the basename of the output file, which may end in .gz.
+  *
+  * @returns the key, 32 hex digits
+  *
+  * @par Example:
+    @verbatim
+
+    cacheKey("cats.ppm", ops, "--binary", "old");
+
+    //returns "5c3a90e1d2f7b648a41f07c5e9d3b210"
+
+    @endverbatim
+
+  ***********************************************************************/
+string cacheKey(string filename, const vector<operation>& ops, string opType, string basename)
+{
+    //loop variables
+    size_t i = 0;
+    size_t k = 0;
+
+    unsigned long long input = 0;
+    unsigned long long stamp = 0;
+    string chain;
+    ostringstream key;
+
+    if (!hashFile(filename, input))
+    {
+        return "";
+    }
+
+    //the options as one line each, the same however they were spaced on the command line
+    for (i = 0; i < ops.size(); i++)
+    {
+        chain += ops[i].option;
+
+        for (k = 0; k < ops[i].args.size(); k++)
+        {
+            chain += " " + ops[i].args[k];
+        }
+
+        if (ops[i].option == "--overlay")
+        {
+            if (!hashFile(ops[i].args[0], stamp))
+            {
+                return "";
+            }
+
+            chain += " " + to_string(stamp);
+        }
+
+        chain += "\n";
+    }
+
+    chain += opType + "\n";
+
+    if (basename.size() > 3 && basename.compare(basename.size() - 3, 3, ".gz") == 0)
+    {
+        chain += ".gz\n";
+    }
+
+    key << hex << setfill('0') << setw(16) << input << setw(16) << xxHash64(chain.data(), chain.size(), 0);
+
+    return key.str();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Looks a run up in the cache. On a hit the output file kept for the key is copied to the output
+  * file of this run, with the extension it was written with, so the image is not read, manipulated,
+  * or written at all. The copy is written through fout, so it gets a checksum file if setChecksum
+  * is on for fout. The hit or miss is counted, and a hit makes the file the most recently used. The
+  * directory is made if it does not exist.
+  *
+  * @param[in] dir - the cache directory.
+  * @param[in] key - the key of the run, from cacheKey.
+  * @param[in] basename - the basename of the output file.
+  * @param[in,out] fout - the stream to write the output file with.
+  *
+  * @returns true if the output file was copied out of the cache
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --cache cache --sepia --binary old cats.ppm, run a second time
+    cacheFetch("cache", key, "old", fout);
+
+    //returns true, old.ppm is copied out of cache
+
+    @endverbatim
+
+  ***********************************************************************/
+bool cacheFetch(string dir, string key, string basename, ofstream& fout)
+{
+    //loop variable
+    size_t k = 0;
+
+    cacheIndex index;
+    error_code error;
+    ifstream kept;
+    string name;
+    bool hit = false;
+
+    lock_guard<mutex> lock(cacheLock);
+
+    readCacheIndex(dir, index);
+
+    for (k = 0; k < index.entries.size(); k++)
+    {
+        if (index.entries[k].key == key)
+        {
+            name = outputFileName(basename, index.entries[k].extension);
+
+            kept.open(filesystem::path(dir) / key, ios::in | ios::binary);
+
+            if (kept.is_open())
+            {
+                fout.clear();
+                fout.open(name, ios::out | ios::trunc | ios::binary);
+                attachChecksumOutput(fout, name);
+
+                fout << kept.rdbuf();
+                hit = fout.good();
+
+                closeOutputFile(fout);
+                kept.close();
+            }
+
+            if (hit)
+            {
+                index.entries[k].lastUse = ++index.clock;
+            }
+
+            //the file is gone from the directory, so the entry goes too
+            else
+            {
+                index.entries.erase(index.entries.begin() + k);
+            }
+
+            break;
+        }
+    }
+
+    if (hit)
+    {
+        index.hits++;
+    }
+
+    else
+    {
+        index.misses++;
+    }
+
+    filesystem::create_directories(dir, error);
+    writeCacheIndex(dir, index);
+
+    return hit;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Keeps the output file of a run in the cache under its key, after it has been written. The file
+  * is found from the basename and the extension the writer opened fout with. The directory is made
+  * if it does not exist, and the file is copied in under a temporary name and renamed, so a half
+  * copied file is never used. Once it is added, the least recently used files are removed until the
+  * cache holds at most CACHE_BYTES bytes.
+  *
+  * @param[in] dir - the cache directory.
+  * @param[in] key - the key of the run, from cacheKey.
+  * @param[in] basename - the basename of the output file.
+  * @param[in] fout - the stream the output file was written with.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputImage(fout, img, opType, basename, max_pix_val, grayOutput, encodeOrient);
+
+    cacheStore("cache", key, basename, fout);
+
+    @endverbatim
+
+  ***********************************************************************/
+void cacheStore(string dir, string key, string basename, ios& fout)
+{
+    //loop variable
+    size_t k = 0;
+
+    cacheIndex index;
+    cacheEntry entry;
+    error_code error;
+    unsigned long long total = 0;
+    size_t oldest = 0;
+
+    string extension = outputExtension(fout);
+    filesystem::path kept = filesystem::path(dir) / key;
+
+    if (extension.empty())
+    {
+        return;
+    }
+
+    lock_guard<mutex> lock(cacheLock);
+
+    filesystem::create_directories(dir, error);
+
+    if (!filesystem::copy_file(outputFileName(basename, extension), kept.string() + ".tmp",
+        filesystem::copy_options::overwrite_existing, error))
+    {
+        return;
+    }
+
+    filesystem::rename(kept.string() + ".tmp", kept, error);
+
+    readCacheIndex(dir, index);
+
+    entry.key = key;
+    entry.extension = extension;
+    entry.bytes = filesystem::file_size(kept, error);
+    entry.lastUse = ++index.clock;
+
+    for (k = 0; k < index.entries.size(); k++)
+    {
+        if (index.entries[k].key == key)
+        {
+            index.entries.erase(index.entries.begin() + k);
+            break;
+        }
+    }
+
+    index.entries.push_back(entry);
+
+    for (k = 0; k < index.entries.size(); k++)
+    {
+        total += index.entries[k].bytes;
+    }
+
+    //the least recently used files go first
+    while (total > CACHE_BYTES && !index.entries.empty())
+    {
+        oldest = 0;
+
+        for (k = 1; k < index.entries.size(); k++)
+        {
+            if (index.entries[k].lastUse < index.entries[oldest].lastUse)
+            {
+                oldest = k;
+            }
+        }
+
+        filesystem::remove(filesystem::path(dir) / index.entries[oldest].key, error);
+
+        total -= index.entries[oldest].bytes;
+        index.entries.erase(index.entries.begin() + oldest);
+    }
+
+    writeCacheIndex(dir, index);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs the counters of a cache directory: the number of hits and misses, and the number of
+  * files and bytes it holds.
+  *
+  * @param[in] dir - the cache directory.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    c:\> thpExam1.exe --cache-stats cache
+
+    hits 12
+    misses 3
+    entries 3
+    bytes 1457190
+
+    @endverbatim
+
+  ***********************************************************************/
+void printCacheStats(string dir)
+{
+    //loop variable
+    size_t k = 0;
+
+    cacheIndex index;
+    unsigned long long total = 0;
+
+    readCacheIndex(dir, index);
+
+    for (k = 0; k < index.entries.size(); k++)
+    {
+        total += index.entries[k].bytes;
+    }
+
+    cout << "hits " << index.hits << "\n";
+    cout << "misses " << index.misses << "\n";
+    cout << "entries " << index.entries.size() << "\n";
+    cout << "bytes " << total << endl;
+}
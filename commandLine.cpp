@@ -0,0 +1,1368 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   Parses the command line options and applies them to the image.
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns how many arguments follow an option code on the command line. Options like
+  * --rotateCW take no arguments while --resize takes the new size, and --overlay takes the
+  * overlay file and its position. Returns -1 if the option code is not valid.
+  *
+  * @param[in] option - the option code.
+  *
+  * @returns the number of arguments of the option, -1 if it is invalid
+  *
+  * @par Example:
+    @verbatim
+
+    int n = optionArgCount("--resize");
+
+    //n is 1, since --resize is followed by the new size
+
+    @endverbatim
+
+  ***********************************************************************/
+int optionArgCount(string option)
+{
+    //options without arguments
+    if (option == "--flipX" || option == "--flipY" || option == "--rotateCW" || option == "--rotateCCW" ||
+        option == "--grayscale" || option == "--sepia" || option == "--stats" || option == "--autoLevels" ||
+        option == "--equalize" || option == "--tiled" || option == "--sobel" || option == "--scharr" ||
+        option == "--sobelX" || option == "--sobelY" || option == "--checksum")
+    {
+        return 0;
+    }
+
+    //options followed by a single argument
+    if (option == "--resize" || option == "--resizeBilinear" || option == "--resizeBox" ||
+        option == "--thumbnail" || option == "--downscale" || option == "--reduce" ||
+        option == "--rotate" || option == "--affine" || option == "--crop" || option == "--roi" ||
+        option == "--region" || option == "--threshold" || option == "--palette" || option == "--ditherBayer" ||
+        option == "--ditherFloyd" || option == "--median" || option == "--erode" || option == "--dilate" || option == "--cache")
+    {
+        return 1;
+    }
+
+    //options followed by two arguments
+    if (option == "--overlay")
+    {
+        return 2;
+    }
+
+    return -1;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Splits text at every separator character and converts each piece to an integer. Returns false
+  * if any piece is empty, contains anything other than digits and an optional leading minus sign, or
+  * does not fit in an int.
+  *
+  * @param[in] text - the text to split.
+  * @param[in] separator - the character between the numbers.
+  * @param[out] values - the numbers that were read.
+  *
+  * @returns true if every piece was a valid integer
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    vector<int> values;
+
+    parseIntList("640x480", 'x', values);
+
+    //values contains 640 and 480
+
+    @endverbatim
+
+  ***********************************************************************/
+bool parseIntList(string text, char separator, vector<int>& values)
+{
+    //loop variable
+    size_t i = 0;
+
+    string piece;
+    size_t start = 0;
+    size_t end = 0;
+    long long value = 0;
+
+    values.clear();
+
+    while (start <= text.size())
+    {
+        end = text.find(separator, start);
+
+        if (end == string::npos)
+        {
+            end = text.size();
+        }
+
+        piece = text.substr(start, end - start);
+
+        //at most a sign and 10 digits, which always fit in a long long
+        if (piece.empty() || piece.size() > 11)
+        {
+            return false;
+        }
+
+        for (i = 0; i < piece.size(); i++)
+        {
+            if (!isdigit((unsigned char)piece[i]) && !(i == 0 && piece[i] == '-' && piece.size() > 1))
+            {
+                return false;
+            }
+        }
+
+        value = stoll(piece);
+
+        if (value > INT_MAX || value < INT_MIN)
+        {
+            return false;
+        }
+
+        values.push_back((int)value);
+        start = end + 1;
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Splits text at every separator character and converts each piece to a floating point number.
+  * Returns false if any piece is empty or is not a complete number.
+  *
+  * @param[in] text - the text to split.
+  * @param[in] separator - the character between the numbers.
+  * @param[out] values - the numbers that were read.
+  *
+  * @returns true if every piece was a valid number
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    vector<double> values;
+
+    parseDoubleList("1,0.5,0,0,1,0", ',', values);
+
+    //values contains 1, 0.5, 0, 0, 1, and 0
+
+    @endverbatim
+
+  ***********************************************************************/
+bool parseDoubleList(string text, char separator, vector<double>& values)
+{
+    string piece;
+    size_t start = 0;
+    size_t end = 0;
+    size_t used = 0;
+
+    values.clear();
+
+    while (start <= text.size())
+    {
+        end = text.find(separator, start);
+
+        if (end == string::npos)
+        {
+            end = text.size();
+        }
+
+        piece = text.substr(start, end - start);
+
+        if (piece.empty() || isspace((unsigned char)piece[0]))
+        {
+            return false;
+        }
+
+        try
+        {
+            values.push_back(stod(piece, &used));
+        }
+
+        catch (...)
+        {
+            return false;
+        }
+
+        if (used != piece.size() || !isfinite(values.back()))
+        {
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Checks that the arguments of an operation are valid, so that a typing mistake is caught
+  * before the input file is read. Sizes are given as WIDTHxHEIGHT and factors as a single
+  * positive number. Angles are a single number and affine matrices are six numbers separated
+  * by commas. Regions are given as x,y,w,h, and the position of an overlay as x,y, which may be negative.
+  *
+  * @param[in] op - the operation to check.
+  *
+  * @returns true if the arguments are valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    operation op;
+
+    op.option = "--resize";
+    op.args.push_back("640x480");
+
+    checkOperation(op);
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool checkOperation(const operation& op)
+{
+    vector<int> values;
+    vector<double> numbers;
+
+    if (op.option == "--rotate")
+    {
+        return parseDoubleList(op.args[0], ',', numbers) && numbers.size() == 1;
+    }
+
+    if (op.option == "--affine")
+    {
+        return parseDoubleList(op.args[0], ',', numbers) && numbers.size() == 6;
+    }
+
+    if (op.option == "--crop" || op.option == "--roi" || op.option == "--region")
+    {
+        return parseIntList(op.args[0], ',', values) && values.size() == 4 && values[0] >= 0 && values[1] >= 0 &&
+            values[2] > 0 && values[3] > 0;
+    }
+
+    if (op.option == "--resize" || op.option == "--resizeBilinear" || op.option == "--resizeBox")
+    {
+        return parseIntList(op.args[0], 'x', values) && values.size() == 2 && values[0] > 0 && values[1] > 0;
+    }
+
+    if (op.option == "--thumbnail" || op.option == "--downscale" || op.option == "--reduce")
+    {
+        return parseIntList(op.args[0], ',', values) && values.size() == 1 && values[0] > 0;
+    }
+
+    if (op.option == "--palette" || op.option == "--ditherBayer" || op.option == "--ditherFloyd")
+    {
+        return parseIntList(op.args[0], ',', values) && values.size() == 1 && values[0] >= 2 && values[0] <= 256;
+    }
+
+    //the column histograms of the median count up to 2 * radius + 1 in 16 bits
+    if (op.option == "--median" || op.option == "--erode" || op.option == "--dilate")
+    {
+        return parseIntList(op.args[0], ',', values) && values.size() == 1 && values[0] > 0 && values[0] <= 32767;
+    }
+
+    if (op.option == "--overlay")
+    {
+        return parseIntList(op.args[1], ',', values) && values.size() == 2;
+    }
+
+    if (op.option == "--threshold")
+    {
+        return parseIntList(op.args[0], ',', values) && values.size() == 1 && values[0] >= 0 && values[0] <= 256;
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Checks whether an operation can be applied to the region given by a --roi option. Flips,
+  * grayscale, and sepia work on any region, while the 90 degree rotations need a square region
+  * so that the result fits back into it.
+  *
+  * @param[in] roi - the --roi operation with the region.
+  * @param[in] op - the operation that follows it.
+  *
+  * @returns true if op can be applied to the region
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --roi 0,0,64,32 --rotateCW --binary out cats.ppm
+    regionOperation(ops[0], ops[1]);
+
+    //returns false, since the region is not square
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool regionOperation(const operation& roi, const operation& op)
+{
+    vector<int> values;
+
+    if (op.option == "--flipX" || op.option == "--flipY" || op.option == "--grayscale" || op.option == "--sepia")
+    {
+        return true;
+    }
+
+    if (op.option == "--rotateCW" || op.option == "--rotateCCW")
+    {
+        parseIntList(roi.args[0], ',', values);
+        return values[2] == values[3];
+    }
+
+    return false;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the option codes in argv from index first up to but not including index last. Each option
+  * code may be followed by its own arguments, and the options are saved in the order they were given
+  * so that they can be applied one after another. Returns false if an option code is not valid, an
+  * option is missing its arguments or they are not valid, or a --roi is not followed by an operation
+  * that works on a region.
+  *
+  * @param[in] argv - a 2d array of characters containing the arguments.
+  * @param[in] first - the index of the first option code.
+  * @param[in] last - the index just after the last argument of the options.
+  * @param[out] ops - the operations in the order they were given.
+  *
+  * @returns true if the options are valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --thumbnail 256 --sepia --binary small cats.ppm
+    parseOperations(argv, 1, argc - 3, ops);
+
+    //ops contains --thumbnail 256 followed by --sepia
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool parseOperations(char** argv, int first, int last, vector<operation>& ops)
+{
+    //loop variables
+    int i = first;
+    int k = 0;
+
+    int count = 0;
+    operation op;
+
+    ops.clear();
+
+    while (i < last)
+    {
+        op.option = argv[i];
+        op.args.clear();
+
+        count = optionArgCount(op.option);
+
+        if (count < 0 || i + count >= last)
+        {
+            return false;
+        }
+
+        for (k = 1; k <= count; k++)
+        {
+            op.args.push_back(argv[i + k]);
+        }
+
+        if (!checkOperation(op))
+        {
+            return false;
+        }
+
+        ops.push_back(op);
+        i += count + 1;
+    }
+
+    //a region must be followed by an operation that works on a region
+    for (k = 0; k < (int)ops.size(); k++)
+    {
+        if (ops[k].option == "--roi" && (k + 1 == (int)ops.size() || !regionOperation(ops[k], ops[k + 1])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if the argument is one of the output types: --ascii, --binary, --qoi, or --pam.
+  *
+  * @param[in] arg - the argument from the command line.
+  *
+  * @returns true if the argument is an output type
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    isOutputType("--qoi");
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool isOutputType(string arg)
+{
+    return arg == "--ascii" || arg == "--binary" || arg == "--qoi" || arg == "--pam";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the command line arguments. The last three arguments are always the output type, the
+  * basename, and the name of the input file. Every argument before them is an option code,
+  * possibly followed by its own arguments, and is read by parseOperations. Returns false if there
+  * are too few arguments, the options are not valid, or the output type is not valid.
+  *
+  * @param[in] argc - the number of arguments from the command prompt.
+  * @param[in] argv - a 2d array of characters containing the arguments.
+  * @param[out] ops - the operations in the order they were given.
+  * @param[out] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[out] basename - the basename of the output file.
+  * @param[out] filename - the name of the input file.
+  *
+  * @returns true if the command line is valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --thumbnail 256 --sepia --binary small cats.ppm
+    parseCommandLine(argc, argv, ops, opType, basename, filename);
+
+    //ops contains --thumbnail 256 followed by --sepia
+    //opType is --binary, basename is small and filename is cats.ppm
+
+    @endverbatim
+
+  ***********************************************************************/
+bool parseCommandLine(int argc, char** argv, vector<operation>& ops, string& opType, string& basename, string& filename)
+{
+    int last = argc - 3;
+
+    if (argc < 4)
+    {
+        return false;
+    }
+
+    //reading the options
+    if (!parseOperations(argv, 1, last, ops))
+    {
+        return false;
+    }
+
+    //checking for valid output types
+    opType = argv[last];
+
+    if (!isOutputType(opType))
+    {
+        return false;
+    }
+
+    basename = argv[last + 1];
+    filename = argv[last + 2];
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the command line of the --fanout mode, which reads one file and writes several outputs
+  * from it. The name of the input file follows --fanout, and is followed by one or more branches.
+  * Each branch is a list of options ending in an output type and a basename, like the command line
+  * of a single output. --reduce and --region change how the shared file is read, so they are not
+  * allowed in a branch. Returns false if there is no branch or any branch is not valid.
+  *
+  * @param[in] argc - the number of arguments from the command prompt.
+  * @param[in] argv - a 2d array of characters containing the arguments.
+  * @param[out] filename - the name of the input file.
+  * @param[out] branches - the branches in the order they were given.
+  *
+  * @returns true if the command line is valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --fanout cats.ppm --ascii copy --grayscale --binary gray --rotateCW --sepia --binary old
+    parseFanout(argc, argv, filename, branches);
+
+    //filename is cats.ppm and there are three branches
+
+    @endverbatim
+
+  ***********************************************************************/
+bool parseFanout(int argc, char** argv, string& filename, vector<outputBranch>& branches)
+{
+    //loop variables
+    int i = 3;
+    int j = 0;
+    size_t k = 0;
+
+    outputBranch branch;
+
+    if (argc < 5 || string(argv[1]) != "--fanout")
+    {
+        return false;
+    }
+
+    filename = argv[2];
+    branches.clear();
+
+    while (i < argc)
+    {
+        //the output type ends the branch
+        for (j = i; j < argc && !isOutputType(argv[j]); j++);
+
+        if (j + 1 >= argc || !parseOperations(argv, i, j, branch.ops))
+        {
+            return false;
+        }
+
+        for (k = 0; k < branch.ops.size(); k++)
+        {
+            if (branch.ops[k].option == "--reduce" || branch.ops[k].option == "--region")
+            {
+                return false;
+            }
+        }
+
+        branch.opType = argv[j];
+        branch.basename = argv[j + 1];
+        branches.push_back(branch);
+
+        i = j + 2;
+    }
+
+    return !branches.empty();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the command line of the --batch mode, which applies the same options to several files.
+  * --batch is followed by the options, an output type, a suffix, and the input files. The output of
+  * each file is named after it, with its extension replaced by the suffix. Returns false if there
+  * is no input file or the options are not valid.
+  *
+  * @param[in] argc - the number of arguments from the command prompt.
+  * @param[in] argv - a 2d array of characters containing the arguments.
+  * @param[out] ops - the options in the order they were given.
+  * @param[out] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[out] suffix - added to the name of each input file.
+  * @param[out] files - the names of the input files.
+  *
+  * @returns true if the command line is valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --batch --grayscale --binary _gray a.ppm b.ppm
+    parseBatch(argc, argv, ops, opType, suffix, files);
+
+    //ops holds --grayscale, suffix is _gray, and files holds a.ppm and b.ppm
+
+    @endverbatim
+
+  ***********************************************************************/
+bool parseBatch(int argc, char** argv, vector<operation>& ops, string& opType, string& suffix, vector<string>& files)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    if (argc < 5 || string(argv[1]) != "--batch")
+    {
+        return false;
+    }
+
+    //the output type ends the options
+    for (j = 2; j < argc && !isOutputType(argv[j]); j++);
+
+    if (j + 2 >= argc || !parseOperations(argv, 2, j, ops))
+    {
+        return false;
+    }
+
+    opType = argv[j];
+    suffix = argv[j + 1];
+    files.clear();
+
+    for (i = j + 2; i < argc; i++)
+    {
+        files.push_back(argv[i]);
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies a single operation from the command line to the image by calling the matching function
+  * in imageOperations.cpp, imageResize.cpp, imageWarp.cpp, imageView.cpp, imageQuantize.cpp,
+  * imageStats.cpp, imageFilter.cpp, imageEdges.cpp, bilevel.cpp, or pam.cpp. grayOutput is set to
+  * true once the image has been converted to grayscale, so that it is written to a .pgm file, or to
+  * a .pbm file once --threshold has made it black and white. --reduce and --region are applied
+  * while the file is read, so they are skipped here.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated.
+  * @param[in] op - the operation to apply.
+  * @param[in,out] grayOutput - set to true if the image should be written as grayscale.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    operation op;
+    bool grayOutput = false;
+
+    op.option = "--grayscale";
+
+    applyOperation(img, op, grayOutput);
+
+    //img is now grayscale and grayOutput is true
+
+    @endverbatim
+
+  ***********************************************************************/
+void applyOperation(image& img, const operation& op, bool& grayOutput)
+{
+    vector<int> values;
+    vector<double> numbers;
+    imageStats stats;
+
+    //rotating clockwise
+    if (op.option == "--rotateCW")
+    {
+        rotateClockWise(img);
+    }
+
+    //rotate counter clockwise
+    else if (op.option == "--rotateCCW")
+    {
+        rotateCounterClockWise(img);
+    }
+
+    // flipX
+    else if (op.option == "--flipX")
+    {
+        flipAxisX(img);
+    }
+
+    //flipY
+    else if (op.option == "--flipY")
+    {
+        flipAxisY(img);
+    }
+
+    //sepia
+    else if (op.option == "--sepia")
+    {
+        convertSepia(img);
+    }
+
+    //grayscale, a black and white image becomes a grayscale image of 0s and 255s
+    else if (op.option == "--grayscale")
+    {
+        convertGrayScale(img);
+        grayOutput = true;
+
+        if (isBilevel(img))
+        {
+            img.magicNumber = "P5";
+        }
+    }
+
+    //black and white, pixels at or above the level are white
+    else if (op.option == "--threshold")
+    {
+        if (!grayOutput)
+        {
+            convertGrayScale(img);
+        }
+
+        thresholdImage(img, stoi(op.args[0]));
+        grayOutput = true;
+    }
+
+    //printing the statistics of the image so far
+    else if (op.option == "--stats")
+    {
+        computeStats(img, stats, grayOutput ? 1 : 3);
+        printStats(stats);
+    }
+
+    //reducing to a palette, mapped to the closest color or dithered
+    else if (op.option == "--palette")
+    {
+        quantizeImage(img, stoi(op.args[0]), DITHER_NONE, grayOutput ? 1 : 3);
+    }
+
+    else if (op.option == "--ditherBayer")
+    {
+        quantizeImage(img, stoi(op.args[0]), DITHER_BAYER, grayOutput ? 1 : 3);
+    }
+
+    else if (op.option == "--ditherFloyd")
+    {
+        quantizeImage(img, stoi(op.args[0]), DITHER_FLOYD, grayOutput ? 1 : 3);
+    }
+
+    //median filter and morphology over a square window
+    else if (op.option == "--median")
+    {
+        medianFilter(img, stoi(op.args[0]), grayOutput ? 1 : 3);
+    }
+
+    else if (op.option == "--erode" || op.option == "--dilate")
+    {
+        morphImage(img, stoi(op.args[0]), op.option == "--dilate", grayOutput ? 1 : 3);
+    }
+
+    //stretching the channels to the full range
+    else if (op.option == "--autoLevels")
+    {
+        autoLevels(img, grayOutput ? 1 : 3);
+    }
+
+    //histogram equalization
+    else if (op.option == "--equalize")
+    {
+        equalizeHistogram(img, grayOutput ? 1 : 3);
+    }
+
+    //resizing, the argument is WIDTHxHEIGHT
+    else if (op.option == "--resize" || op.option == "--resizeBilinear" || op.option == "--resizeBox")
+    {
+        parseIntList(op.args[0], 'x', values);
+
+        if (op.option == "--resizeBox")
+        {
+            resizeImage(img, values[1], values[0], FILTER_BOX);
+        }
+
+        else if (op.option == "--resizeBilinear")
+        {
+            resizeImage(img, values[1], values[0], FILTER_BILINEAR);
+        }
+
+        else
+        {
+            resizeImage(img, values[1], values[0], FILTER_LANCZOS3);
+        }
+    }
+
+    //thumbnail with the longest side given
+    else if (op.option == "--thumbnail")
+    {
+        thumbnail(img, stoi(op.args[0]));
+    }
+
+    //integer factor downscale
+    else if (op.option == "--downscale")
+    {
+        downscaleBox(img, stoi(op.args[0]));
+    }
+
+    //rotating by any angle
+    else if (op.option == "--rotate")
+    {
+        rotateAngle(img, stod(op.args[0]));
+    }
+
+    //affine warp, the argument is the matrix a,b,c,d,e,f
+    else if (op.option == "--affine")
+    {
+        parseDoubleList(op.args[0], ',', numbers);
+        affineTransform(img, numbers.data());
+    }
+
+    //cropping, the argument is x,y,w,h
+    else if (op.option == "--crop")
+    {
+        parseIntList(op.args[0], ',', values);
+        cropImage(img, values[0], values[1], values[2], values[3]);
+    }
+
+    //edge detection, the gradient magnitude or one of its components
+    else if (op.option == "--sobel" || op.option == "--scharr")
+    {
+        detectEdges(img, op.option == "--scharr", EDGE_MAGNITUDE, grayOutput);
+    }
+
+    else if (op.option == "--sobelX" || op.option == "--sobelY")
+    {
+        detectEdges(img, false, op.option == "--sobelX" ? EDGE_X : EDGE_Y, grayOutput);
+    }
+
+    //stamping an overlay file at x,y
+    else if (op.option == "--overlay")
+    {
+        parseIntList(op.args[1], ',', values);
+        overlayImage(img, op.args[0], values[0], values[1], grayOutput);
+    }
+
+    //reduce and region are handled by the reader, tiled by applyOperations
+    else if (op.option == "--reduce" || op.option == "--region" || op.option == "--tiled" || op.option == "--cache" ||
+        op.option == "--checksum")
+    {
+        return;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the factor given with the --reduce option, which tells the reader to shrink the image
+  * while it is decoded. If --reduce was given more than once the factors are multiplied, and the
+  * product stops at INT_MAX, which shrinks any image to a single pixel. Returns 1 if there is no
+  * --reduce option.
+  *
+  * @param[in] ops - the operations from the command line.
+  *
+  * @returns the factor that the image is shrunk by while it is read
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --reduce 4 --binary preview cats.ppm
+    int reduce = decodeReduce(ops);
+
+    //reduce is 4
+
+    @endverbatim
+
+  ***********************************************************************/
+int decodeReduce(const vector<operation>& ops)
+{
+    //loop variable
+    size_t i = 0;
+
+    //the product can pass INT_MAX, which already shrinks any image to 1 x 1
+    long long reduce = 1;
+
+    for (i = 0; i < ops.size(); i++)
+    {
+        if (ops[i].option == "--reduce")
+        {
+            reduce = min(reduce * stoi(ops[i].args[0]), (long long)INT_MAX);
+        }
+    }
+
+    return (int)reduce;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies an operation to the region x,y,w,h of the image only, using the view versions of the
+  * functions in imageOperations.cpp. Grayscale and sepia are done in place on a view of the region.
+  * Flips and rotations need the original pixels while they write, so the region is first copied
+  * into a temporary image the size of the region, and the operation then writes from a view of the
+  * copy straight back into the region. The rest of the image is never copied.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated.
+  * @param[in] op - the operation to apply.
+  * @param[in] region - the region as x, y, w, and h.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --roi 10,10,100,50 --sepia --binary out cats.ppm
+    applyRegionOperation(img, ops[1], region);
+
+    //only the 100 x 50 region at column 10 and row 10 is antiqued
+
+    @endverbatim
+
+  ***********************************************************************/
+static void applyRegionOperation(image& img, const operation& op, const vector<int>& region)
+{
+    imageView roi = cropView(makeView(img), region[0], region[1], region[2], region[3]);
+    image temp;
+
+    //in place operations
+    if (op.option == "--grayscale")
+    {
+        convertGrayScale(roi, roi);
+        return;
+    }
+
+    if (op.option == "--sepia")
+    {
+        convertSepia(roi, roi);
+        return;
+    }
+
+    //copy the region so it can be written back
+    temp.rows = roi.rows;
+    temp.cols = roi.cols;
+    temp.redGray = alloc2D(temp.rows, temp.cols);
+    temp.green = alloc2D(temp.rows, temp.cols);
+    temp.blue = alloc2D(temp.rows, temp.cols);
+
+    //if memory allocation fails
+    if ((temp.redGray == nullptr) || (temp.green == nullptr) || (temp.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    copyView(roi, makeView(temp));
+
+    if (op.option == "--flipX")
+    {
+        flipAxisX(makeView(temp), roi);
+    }
+
+    else if (op.option == "--flipY")
+    {
+        flipAxisY(makeView(temp), roi);
+    }
+
+    else if (op.option == "--rotateCW")
+    {
+        rotateClockWise(makeView(temp), roi);
+    }
+
+    else
+    {
+        rotateCounterClockWise(makeView(temp), roi);
+    }
+
+    free2D(temp.redGray, temp.rows);
+    free2D(temp.green, temp.rows);
+    free2D(temp.blue, temp.rows);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Moves the alpha channel of an image along with its pixels for the operation at index i. Operations
+  * that change the shape or the position of the pixels, such as rotations, flips, crops, resizes, and
+  * warps, are applied to the alpha channel with applyToAlpha before they are applied to the colors,
+  * along with the --roi before them if there is one. Operations that only change the colors leave the
+  * alpha channel as it is. Does nothing for an image without an alpha channel.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated.
+  * @param[in] ops - the operations in the order they were given.
+  * @param[in] i - the index of the operation about to be applied.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --rotateCW --sepia --pam out logo.pam
+    followAlpha(img, ops, 0);
+
+    //img.alpha is rotated clockwise, the colors are not changed yet
+
+    @endverbatim
+
+  ***********************************************************************/
+static void followAlpha(image& img, const vector<operation>& ops, size_t i)
+{
+    vector<operation> moved;
+    bool gray = true;
+
+    //the operations that move pixels
+    auto moves = [](const operation& op)
+    {
+        return orientationOf(op) >= 0 || op.option == "--resize" || op.option == "--resizeBilinear" ||
+            op.option == "--resizeBox" || op.option == "--thumbnail" || op.option == "--downscale" ||
+            op.option == "--rotate" || op.option == "--affine" || op.option == "--crop";
+    };
+
+    if (img.alpha == nullptr)
+    {
+        return;
+    }
+
+    if (ops[i].option == "--roi" && i + 1 < ops.size() && moves(ops[i + 1]))
+    {
+        moved.assign(ops.begin() + i, ops.begin() + i + 2);
+    }
+
+    else if (moves(ops[i]))
+    {
+        moved.push_back(ops[i]);
+    }
+
+    if (!moved.empty())
+    {
+        applyToAlpha(img, [&](image& a) { applyOperations(a, moved, gray); });
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies all of the operations from the command line to the image in order. A --roi option
+  * limits the operation that follows it to a region of the image, and is handled by
+  * applyRegionOperation. Every other operation is handled by applyOperation.
+  *
+  * If --tiled was given anywhere on the command line, every run of operations that have a tiled
+  * version is applied to a tiled copy of the image instead. The image is converted to tiles before
+  * the first operation of the run and back to rows before the next operation that needs rows, or
+  * before the image is outputted. An image with an alpha channel is never tiled, and followAlpha moves
+  * its alpha channel along with the pixels.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated.
+  * @param[in] ops - the operations in the order they were given.
+  * @param[in,out] grayOutput - set to true if the image should be written as grayscale.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --crop 0,0,640,480 --roi 0,0,64,64 --sepia --binary out cats.ppm
+    applyOperations(img, ops, grayOutput);
+
+    //img is cropped to 640 x 480 and its top left 64 x 64 pixels are antiqued
+
+    @endverbatim
+
+  ***********************************************************************/
+void applyOperations(image& img, const vector<operation>& ops, bool& grayOutput)
+{
+    //loop variable
+    size_t i = 0;
+
+    vector<int> region;
+
+    tiledImage t;
+    bool tiled = false;
+    bool inTiles = false;
+
+    //an image with an alpha channel stays in rows, where followAlpha can move the alpha channel
+    for (i = 0; i < ops.size(); i++)
+    {
+        if (ops[i].option == "--tiled" && img.alpha == nullptr)
+        {
+            tiled = true;
+        }
+    }
+
+    for (i = 0; i < ops.size(); i++)
+    {
+        followAlpha(img, ops, i);
+
+        if (tiled && tiledOperation(ops[i]))
+        {
+            if (!inTiles)
+            {
+                toTiled(img, t);
+                inTiles = true;
+            }
+
+            applyTiledOperation(t, ops[i], grayOutput);
+
+            //a black and white image becomes grayscale, as in applyOperation
+            if (ops[i].option == "--grayscale" && isBilevel(img))
+            {
+                img.magicNumber = "P5";
+            }
+
+            continue;
+        }
+
+        //back to rows for everything else
+        if (inTiles)
+        {
+            fromTiled(t, img);
+            inTiles = false;
+        }
+
+        if (ops[i].option == "--roi" && i + 1 < ops.size())
+        {
+            parseIntList(ops[i].args[0], ',', region);
+            applyRegionOperation(img, ops[i + 1], region);
+            i++;
+        }
+
+        else
+        {
+            applyOperation(img, ops[i], grayOutput);
+        }
+    }
+
+    if (inTiles)
+    {
+        fromTiled(t, img);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Finds the --region option, which tells the reader to read only part of the file. The region
+  * x,y,w,h is stored in region. If --region was given more than once the last one is used.
+  *
+  * @param[in] ops - the operations from the command line.
+  * @param[out] region - the region as x, y, w, and h.
+  *
+  * @returns true if there is a --region option
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --region 100,200,640,480 --binary part cats.ppm
+    int region[4];
+
+    decodeRegion(ops, region);
+
+    //returns true, region contains 100, 200, 640, and 480
+
+    @endverbatim
+
+  ***********************************************************************/
+bool decodeRegion(const vector<operation>& ops, int region[4])
+{
+    //loop variables
+    size_t i = 0;
+    int k = 0;
+
+    vector<int> values;
+    bool found = false;
+
+    for (i = 0; i < ops.size(); i++)
+    {
+        if (ops[i].option == "--region")
+        {
+            parseIntList(ops[i].args[0], ',', values);
+
+            for (k = 0; k < 4; k++)
+            {
+                region[k] = values[k];
+            }
+
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the orientation of a flip or 90 degree rotation from the command line. A clockwise
+  * rotation is a transpose followed by a flip on the Y axis, and a counter clockwise rotation is
+  * a transpose followed by a flip on the X axis. Returns -1 for every other operation.
+  *
+  * @param[in] op - the operation.
+  *
+  * @returns the orientation of the operation, -1 if it does not only change the orientation
+  *
+  * @par Example:
+    @verbatim
+
+    int orient = orientationOf(op);
+
+    //orient is ORIENT_FLIP_X if op is --flipX
+
+    @endverbatim
+
+  ***********************************************************************/
+int orientationOf(const operation& op)
+{
+    if (op.option == "--flipX")
+    {
+        return ORIENT_FLIP_X;
+    }
+
+    if (op.option == "--flipY")
+    {
+        return ORIENT_FLIP_Y;
+    }
+
+    if (op.option == "--rotateCW")
+    {
+        return ORIENT_TRANSPOSE | ORIENT_FLIP_Y;
+    }
+
+    if (op.option == "--rotateCCW")
+    {
+        return ORIENT_TRANSPOSE | ORIENT_FLIP_X;
+    }
+
+    return -1;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Removes the flips and 90 degree rotations at the start of the operations and returns them as a
+  * single orientation, which the reader applies while it stores the rows of the file. The options that
+  * are handled by the reader or by applyOperations, --reduce, --region, and --tiled, are skipped over.
+  * A job that only flips and rotates is then one pass over the file in and one pass out.
+  *
+  * @param[in,out] ops - the operations from the command line. The leading orientations are removed.
+  *
+  * @returns the orientation to read the file in, ORIENT_NONE if there is none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --rotateCW --flipX --sepia --binary out cats.ppm
+    int orient = fuseDecodeOrientation(ops);
+
+    //orient is ORIENT_TRANSPOSE, ops only holds --sepia
+
+    @endverbatim
+
+  ***********************************************************************/
+int fuseDecodeOrientation(vector<operation>& ops)
+{
+    //loop variable
+    size_t i = 0;
+
+    int orient = ORIENT_NONE;
+
+    while (i < ops.size())
+    {
+        if (ops[i].option == "--reduce" || ops[i].option == "--region" || ops[i].option == "--tiled")
+        {
+            i++;
+        }
+
+        else if (orientationOf(ops[i]) >= 0)
+        {
+            orient = combineOrientation(orient, orientationOf(ops[i]));
+            ops.erase(ops.begin() + i);
+        }
+
+        else
+        {
+            break;
+        }
+    }
+
+    return orient;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Removes the flips and 90 degree rotations at the end of the operations and returns them as a
+  * single orientation, which the writer applies by outputting the pixels in that order. An orientation
+  * that follows --roi belongs to the region and is left alone. The options --reduce, --region, and
+  * --tiled are skipped over.
+  *
+  * @param[in,out] ops - the operations from the command line. The trailing orientations are removed.
+  *
+  * @returns the orientation to write the image in, ORIENT_NONE if there is none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --sepia --rotateCCW --binary out cats.ppm
+    int orient = fuseEncodeOrientation(ops);
+
+    //orient is ORIENT_TRANSPOSE | ORIENT_FLIP_X, ops only holds --sepia
+
+    @endverbatim
+
+  ***********************************************************************/
+int fuseEncodeOrientation(vector<operation>& ops)
+{
+    //loop variable
+    size_t i = ops.size();
+
+    int orient = ORIENT_NONE;
+
+    while (i > 0)
+    {
+        if (ops[i - 1].option == "--reduce" || ops[i - 1].option == "--region" || ops[i - 1].option == "--tiled")
+        {
+            i--;
+        }
+
+        else if (orientationOf(ops[i - 1]) >= 0 && !(i > 1 && ops[i - 2].option == "--roi"))
+        {
+            orient = combineOrientation(orientationOf(ops[i - 1]), orient);
+            ops.erase(ops.begin() + (i - 1));
+            i--;
+        }
+
+        else
+        {
+            break;
+        }
+    }
+
+    return orient;
+}
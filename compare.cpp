@@ -0,0 +1,372 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that compare two images and report how far apart they are
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Width and height of the square window the SSIM is measured over.
+ */
+const int SSIM_WINDOW = 7;
+
+/**
+ * @brief The fractions of the largest value that keep the SSIM stable on flat windows.
+ */
+const double SSIM_K1 = 0.01;
+const double SSIM_K2 = 0.03;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the mean structural similarity (SSIM) of one channel of two images of the same size. The
+  * SSIM of a window compares the means, variances, and covariance of the two images in it, and is 1
+  * when the windows are the same. It is measured for every position of a SSIM_WINDOW square window
+  * that fits in the image, or a smaller window for a smaller image. The rows of window positions are
+  * split across threads. Each strip keeps the sums of x, y, x * x, y * y, and x * y down every column
+  * of the window, updated by one row out and one row in as the window moves down, and slides the
+  * window sums along the row by one column out and one column in, so the cost per pixel does not
+  * depend on the size of the window. The sums are exact integers, and so are the products of them in
+  * double precision. The SSIM of each row is added up separately and the rows are added in order, so
+  * the result is the same for any number of threads.
+  *
+  * @param[in] a - the channel of the first image.
+  * @param[in] b - the channel of the second image.
+  * @param[in] rows - the number of rows.
+  * @param[in] cols - the number of columns.
+  * @param[in] peak - the largest value a pixel can have.
+  *
+  * @returns the mean SSIM, from -1 to 1
+  *
+  * @par Example:
+    @verbatim
+
+    double s = ssimChannel(img.redGray, img.redGray, img.rows, img.cols, 255);
+
+    //s is 1
+
+    @endverbatim
+
+  ***********************************************************************/
+static double ssimChannel(pixel** a, pixel** b, int rows, int cols, int peak)
+{
+    //loop variable
+    int i = 0;
+
+    int window = min(SSIM_WINDOW, min(rows, cols));
+    int outRows = rows - window + 1;
+    int outCols = cols - window + 1;
+    double total = 0;
+    double c1 = SSIM_K1 * peak * SSIM_K1 * peak;
+    double c2 = SSIM_K2 * peak * SSIM_K2 * peak;
+
+    vector<double> rowSsim(outRows);
+
+    parallelFor(0, outRows, [&](int rowStart, int rowEnd)
+    {
+        //loop variables
+        int r = 0;
+        int j = 0;
+
+        double n = (double)window * window;
+        double c1n = c1 * n * n;
+        double c2n = c2 * n * n;
+        double x, y, luminance, contrast, acc;
+        int sx, sy, sxx, syy, sxy;
+
+        vector<int> colX(cols), colY(cols), colXX(cols), colYY(cols), colXY(cols);
+
+        //adds the pixels of a row to the column sums, or takes them away
+        auto addRow = [&](int row, int sign)
+        {
+            int jj = 0;
+            int pa = 0;
+            int pb = 0;
+
+            for (jj = 0; jj < cols; jj++)
+            {
+                pa = a[row][jj];
+                pb = b[row][jj];
+
+                colX[jj] += sign * pa;
+                colY[jj] += sign * pb;
+                colXX[jj] += sign * pa * pa;
+                colYY[jj] += sign * pb * pb;
+                colXY[jj] += sign * pa * pb;
+            }
+        };
+
+        for (r = rowStart; r < rowStart + window; r++)
+        {
+            addRow(r, 1);
+        }
+
+        for (r = rowStart; r < rowEnd; r++)
+        {
+            //the window moves down a row
+            if (r > rowStart)
+            {
+                addRow(r - 1, -1);
+                addRow(r + window - 1, 1);
+            }
+
+            sx = sy = sxx = syy = sxy = 0;
+            acc = 0;
+
+            for (j = 0; j < window; j++)
+            {
+                sx += colX[j];
+                sy += colY[j];
+                sxx += colXX[j];
+                syy += colYY[j];
+                sxy += colXY[j];
+            }
+
+            for (j = 0; j < outCols; j++)
+            {
+                //the window moves right a column
+                if (j > 0)
+                {
+                    sx += colX[j + window - 1] - colX[j - 1];
+                    sy += colY[j + window - 1] - colY[j - 1];
+                    sxx += colXX[j + window - 1] - colXX[j - 1];
+                    syy += colYY[j + window - 1] - colYY[j - 1];
+                    sxy += colXY[j + window - 1] - colXY[j - 1];
+                }
+
+                //the means, variances, and covariance, each times n * n, with a single division
+                x = sx;
+                y = sy;
+                luminance = 2 * x * y + c1n;
+                contrast = 2 * (n * sxy - x * y) + c2n;
+
+                acc += luminance * contrast / ((x * x + y * y + c1n) * (n * (sxx + syy) - x * x - y * y + c2n));
+            }
+
+            rowSsim[r] = acc;
+        }
+    });
+
+    for (i = 0; i < outRows; i++)
+    {
+        total += rowSsim[i];
+    }
+
+    return total / ((double)outRows * outCols);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the peak signal to noise ratio in decibels for a sum of squared differences over a number
+  * of values, with peak as the largest value. Identical images have no noise, so infinity is returned.
+  *
+  * @param[in] squared - the sum of the squared differences.
+  * @param[in] count - the number of values that were compared.
+  * @param[in] peak - the largest value a pixel can have.
+  *
+  * @returns the PSNR in decibels
+  *
+  * @par Example:
+    @verbatim
+
+    double db = psnr(100, 100, 255);
+
+    //db is 48.13, a mean squared error of 1
+
+    @endverbatim
+
+  ***********************************************************************/
+static double psnr(unsigned long long squared, unsigned long long count, int peak)
+{
+    if (squared == 0)
+    {
+        return INFINITY;
+    }
+
+    return 10.0 * log10((double)peak * peak * count / (double)squared);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads two images and outputs how far apart they are: the number of pixels that differ in any
+  * channel, and for each channel the largest absolute difference, the PSNR, and the SSIM, followed by
+  * the PSNR and SSIM of all the channels together. Grayscale images are compared in one channel. The
+  * two files are read at the same time, on two threads. The differences are counted in parallel
+  * strips that each keep their own totals, like computeStats, and the SSIM is measured by ssimChannel
+  * with sliding sums, so the comparison takes about as long as reading the images. The images must
+  * have the same size and maximum value.
+  *
+  * @param[in] first - the first image.
+  * @param[in] second - the second image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    c:\> thpExam1.exe --compare sepia.ppm sepiaFast.ppm
+
+    pixels 161910
+    mismatched 2311
+    red max 1 psnr 66.02 ssim 0.999995
+    ...
+    all psnr 66.64 ssim 0.999996
+
+    @endverbatim
+
+  ***********************************************************************/
+void runCompare(string first, string second)
+{
+    //loop variable
+    int c = 0;
+
+    image img[2];
+    int max_pix_val[2] = { 0, 0 };
+    string filenames[2] = { first, second };
+    bool gray = false;
+    int channels = 3;
+
+    int maxDiff[3] = { 0, 0, 0 };
+    unsigned long long squared[3] = { 0, 0, 0 };
+    unsigned long long mismatched = 0;
+    unsigned long long pixels = 0;
+    unsigned long long squaredAll = 0;
+    double ssim[3] = { 0, 0, 0 };
+    double ssimAll = 0;
+    mutex merge;
+
+    const char* names[3] = { "red", "green", "blue" };
+
+    //reads one of the files
+    auto readOne = [&](int k)
+    {
+        ifstream fin;
+
+        if (!(openInputFile(fin, filenames[k])))
+        {
+            cout << "Unable to open input file: " << filenames[k] << endl;
+            exit(0);
+        }
+
+        readMagicNum(fin, img[k], max_pix_val[k]);
+
+        fin.clear();
+        fin.close();
+    };
+
+    thread reader(readOne, 1);
+    readOne(0);
+    reader.join();
+
+    if (img[0].rows != img[1].rows || img[0].cols != img[1].cols)
+    {
+        cout << "The images are not the same size: " << img[0].cols << " x " << img[0].rows << " and "
+             << img[1].cols << " x " << img[1].rows << endl;
+        exit(0);
+    }
+
+    if (max_pix_val[0] != max_pix_val[1])
+    {
+        cout << "The images do not have the same maximum value: " << max_pix_val[0] << " and "
+             << max_pix_val[1] << endl;
+        exit(0);
+    }
+
+    gray = (img[0].magicNumber == "P2" || img[0].magicNumber == "P5" || isBilevel(img[0])) &&
+        (img[1].magicNumber == "P2" || img[1].magicNumber == "P5" || isBilevel(img[1]));
+    channels = gray ? 1 : 3;
+
+    pixel** planes[2][3] = { { img[0].redGray, img[0].green, img[0].blue },
+                             { img[1].redGray, img[1].green, img[1].blue } };
+
+    //the differences, counted in strips
+    parallelFor(0, img[0].rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j, k, d;
+        const pixel* rowA;
+        const pixel* rowB;
+
+        int localMax[3] = { 0, 0, 0 };
+        unsigned long long localSquared[3] = { 0, 0, 0 };
+        unsigned long long localMismatched = 0;
+
+        vector<pixel> differs(img[0].cols);
+
+        //a channel at a time along each row, with the pixels that differ marked
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            fill(differs.begin(), differs.end(), (pixel)0);
+
+            for (k = 0; k < channels; k++)
+            {
+                rowA = planes[0][k][i];
+                rowB = planes[1][k][i];
+
+                for (j = 0; j < img[0].cols; j++)
+                {
+                    d = abs(rowA[j] - rowB[j]);
+
+                    localMax[k] = max(localMax[k], d);
+                    localSquared[k] += (unsigned int)(d * d);
+                    differs[j] |= (pixel)d;
+                }
+            }
+
+            for (j = 0; j < img[0].cols; j++)
+            {
+                localMismatched += differs[j] != 0 ? 1 : 0;
+            }
+        }
+
+        //add the strip into the result
+        lock_guard<mutex> lock(merge);
+
+        for (k = 0; k < channels; k++)
+        {
+            maxDiff[k] = max(maxDiff[k], localMax[k]);
+            squared[k] += localSquared[k];
+        }
+
+        mismatched += localMismatched;
+    });
+
+    pixels = (unsigned long long)img[0].rows * img[0].cols;
+
+    if (gray)
+    {
+        names[0] = "gray";
+    }
+
+    cout << "pixels " << pixels << "\n";
+    cout << "mismatched " << mismatched << "\n";
+
+    for (c = 0; c < channels; c++)
+    {
+        ssim[c] = ssimChannel(planes[0][c], planes[1][c], img[0].rows, img[0].cols, max_pix_val[0]);
+        ssimAll += ssim[c] / channels;
+        squaredAll += squared[c];
+
+        cout << names[c] << " max " << maxDiff[c] << " psnr " << fixed << setprecision(2)
+             << psnr(squared[c], pixels, max_pix_val[0]) << " ssim " << setprecision(6) << ssim[c] << "\n";
+    }
+
+    cout << "all psnr " << fixed << setprecision(2) << psnr(squaredAll, pixels * channels, max_pix_val[0])
+         << " ssim " << setprecision(6) << ssimAll << endl;
+
+    for (c = 0; c < 2; c++)
+    {
+        free2D(img[c].redGray, img[c].rows);
+        free2D(img[c].green, img[c].rows);
+        free2D(img[c].blue, img[c].rows);
+        free2D(img[c].alpha, img[c].rows);
+    }
+}
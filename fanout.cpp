@@ -0,0 +1,135 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the function that writes several outputs from a single read of an image
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Runs every branch of the --fanout mode on one decoded image and writes each result. The branches
+  * run in parallel and share the arrays of the image copy on write:
+  *
+  * - A branch whose options are only flips and 90 degree rotations, or nothing at all, never changes
+  *   the pixels. It hands its orientation to the writer and outputs straight from the shared arrays.
+  * - A branch that changes the pixels needs arrays of its own. If every other branch is done with the
+  *   shared arrays, it takes them over. Otherwise it makes a copy first.
+  *
+  * users counts the branches that still need the shared arrays. A branch stops needing them once it
+  * has copied them or written its output from them, and the branch that lowers the count to zero frees
+  * them, so the arrays are never freed or changed while another branch is still reading them. The
+  * arrays of img belong to this function once it is called and are freed before it returns.
+  *
+  * @param[in,out] img - the decoded image. Its arrays are freed.
+  * @param[in] max_pix_val - maximum value of a pixel.
+  * @param[in] grayInput - true if the file was grayscale.
+  * @param[in] branches - the branches from the command line.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --fanout cats.ppm --ascii copy --grayscale --binary gray --rotateCW --binary turned
+    runFanout(img, max_pix_val, false, branches);
+
+    //copy.ppm, gray.pgm, and turned.ppm are written from one read of cats.ppm,
+    //and only the grayscale branch makes a copy of the pixels
+
+    @endverbatim
+
+  ***********************************************************************/
+void runFanout(image& img, int max_pix_val, bool grayInput, const vector<outputBranch>& branches)
+{
+    mutex lock;
+    int users = (int)branches.size();
+    bool owned = true;
+
+    parallelFor(0, (int)branches.size(), [&](int branchStart, int branchEnd)
+    {
+        int b = 0;
+        int orient = ORIENT_NONE;
+        bool grayOutput = false;
+        bool takeOver = false;
+
+        vector<operation> ops;
+        image work;
+        ofstream fout;
+
+        for (b = branchStart; b < branchEnd; b++)
+        {
+            ops = branches[b].ops;
+            setChecksum(fout, takeChecksum(ops));
+            orient = fuseEncodeOrientation(ops);
+            grayOutput = grayInput;
+            takeOver = false;
+
+            //changes the pixels, so it needs arrays of its own
+            if (!ops.empty())
+            {
+                lock.lock();
+
+                //the last branch that needs the shared arrays keeps them
+                takeOver = users == 1 && owned;
+
+                if (takeOver)
+                {
+                    owned = false;
+                }
+
+                lock.unlock();
+
+                if (takeOver)
+                {
+                    work = img;
+                }
+
+                else
+                {
+                    copyImage(img, work);
+                }
+            }
+
+            //only reads the shared arrays
+            else
+            {
+                outputImage(fout, img, branches[b].opType, branches[b].basename, max_pix_val, grayOutput, orient);
+            }
+
+            //done with the shared arrays
+            if (!takeOver)
+            {
+                lock.lock();
+
+                users--;
+
+                if (users == 0 && owned)
+                {
+                    owned = false;
+
+                    free2D(img.redGray, img.rows);
+                    free2D(img.green, img.rows);
+                    free2D(img.blue, img.rows);
+                    free2D(img.alpha, img.rows);
+                }
+
+                lock.unlock();
+            }
+
+            if (!ops.empty())
+            {
+                applyOperations(work, ops, grayOutput);
+                outputImage(fout, work, branches[b].opType, branches[b].basename, max_pix_val, grayOutput, orient);
+
+                free2D(work.redGray, work.rows);
+                free2D(work.green, work.rows);
+                free2D(work.blue, work.rows);
+                free2D(work.alpha, work.rows);
+            }
+        }
+    });
+}
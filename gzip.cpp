@@ -0,0 +1,1700 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains a self contained gzip decoder and encoder that are attached to file streams
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of bytes of output a match can refer back to.
+ */
+const size_t GZIP_WINDOW = 32768;
+
+/**
+ * @brief Number of bytes decoded into the buffer of an input stream at a time.
+ */
+const size_t GZIP_INPUT_CHUNK = 1 << 18;
+
+/**
+ * @brief Number of bytes compressed into each gzip member of an output stream. A member is
+ *        compressed by each thread at a time.
+ */
+const size_t GZIP_BLOCK = 1 << 20;
+
+/**
+ * @brief The most bytes a stored block can hold, since its length is 16 bits.
+ */
+const size_t GZIP_STORED = 65535;
+
+/**
+ * @brief Number of earlier positions with the same hash that are tried for a match.
+ */
+const int GZIP_CHAIN = 16;
+
+/**
+ * @brief The shortest and longest length of a match.
+ */
+const int GZIP_MIN_MATCH = 3;
+const int GZIP_MAX_MATCH = 258;
+
+/**
+ * @brief The lengths of matches, and the number of extra bits after each of the length codes 257 to 285.
+ */
+static const unsigned short LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+/**
+ * @brief The distances of matches, and the number of extra bits after each of the distance codes 0 to 29.
+ */
+static const unsigned short DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const unsigned char DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/**
+ * @brief The order the lengths of the code length codes are stored in a dynamic block.
+ */
+static const unsigned char CODE_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/**
+ * @brief Codes up to this many bits are decoded with a single table lookup.
+ */
+const int HUFFMAN_FAST_BITS = 9;
+
+
+/**
+ * @brief A canonical Huffman code for decoding. Short codes are looked up in fast, and longer
+ *        ones are decoded a bit at a time from the number of codes of each length.
+ */
+struct huffmanCode
+{
+    unsigned short counts[16];                      /**< Number of codes of each length. */
+    unsigned short symbols[288];                    /**< The symbols ordered by their codes. */
+    unsigned short fast[1 << HUFFMAN_FAST_BITS];    /**< Symbol plus length << 9 by the next bits, 0 if longer. */
+};
+
+
+/**
+ * @brief Where a decoder is in a gzip file.
+ */
+enum inflateStep
+{
+    INFLATE_MEMBER,     /**< At the header of a member, or the end of the file. */
+    INFLATE_BLOCK,      /**< At the header of a block. */
+    INFLATE_STORED,     /**< Inside a block that is not compressed. */
+    INFLATE_CODES,      /**< Inside a block of Huffman codes. */
+    INFLATE_DONE        /**< Past the end of the data. */
+};
+
+
+/**
+ * @brief The state of a decoder, kept between calls so a file is decoded a chunk at a time.
+ */
+struct inflateState
+{
+    streambuf* source = nullptr;        /**< The compressed file. */
+    unsigned long long bits = 0;        /**< Bits read from the file but not used yet, first bit lowest. */
+    int bitCount = 0;                   /**< Number of bits in bits. */
+    int step = INFLATE_MEMBER;          /**< Where the decoder is. */
+    bool lastBlock = false;             /**< True if the current block is the last of its member. */
+    size_t storedLeft = 0;              /**< Bytes left in the current stored block. */
+    unsigned int crc = 0;               /**< CRC-32 of the member so far. */
+    unsigned int size = 0;              /**< Size of the member so far, modulo 2^32. */
+    huffmanCode lengths;                /**< Code of the literals and lengths of the current block. */
+    huffmanCode distances;              /**< Code of the distances of the current block. */
+};
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds length bytes to a CRC-32, the checksum at the end of every gzip member. The table of the
+  * checksum of every byte value is computed the first time the function is called.
+  *
+  * @param[in] crc - the checksum of the bytes before data, 0 at the start.
+  * @param[in] data - the bytes to add.
+  * @param[in] length - the number of bytes.
+  *
+  * @returns the checksum including data
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned int crc = crc32Update(0, "123456789", 9);
+
+    //crc is 0xcbf43926
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned int crc32Update(unsigned int crc, const void* data, size_t length)
+{
+    static const vector<unsigned int> table = []()
+    {
+        unsigned int n = 0;
+        unsigned int c = 0;
+        int k = 0;
+        vector<unsigned int> values(256);
+
+        for (n = 0; n < 256; n++)
+        {
+            c = n;
+
+            for (k = 0; k < 8; k++)
+            {
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+
+            values[n] = c;
+        }
+
+        return values;
+    }();
+
+    const unsigned char* p = (const unsigned char*)data;
+
+    crc = ~crc;
+
+    while (length-- > 0)
+    {
+        crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs a message and exits when the compressed data is not valid.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    if (distance > available)
+    {
+        invalidGzip();
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+static void invalidGzip()
+{
+    cout << "Invalid Gzip Data" << endl;
+    exit(0);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Makes sure the decoder holds at least count bits, reading more bytes from the file as needed.
+  * Returns false if the file ends first.
+  *
+  * @param[in,out] s - the state of the decoder.
+  * @param[in] count - the number of bits needed, at most 32.
+  *
+  * @returns true if there are count bits
+  * @returns false if the file ended
+  *
+  * @par Example:
+    @verbatim
+
+    if (needBits(s, 16))
+    {
+        //the next 16 bits are in s.bits
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool needBits(inflateState& s, int count)
+{
+    int c = 0;
+
+    while (s.bitCount < count)
+    {
+        c = s.source->sbumpc();
+
+        if (c == EOF)
+        {
+            return false;
+        }
+
+        s.bits |= (unsigned long long)(unsigned char)c << s.bitCount;
+        s.bitCount += 8;
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Takes count bits from the decoder, first bit lowest. Returns -1 if the file ends first.
+  *
+  * @param[in,out] s - the state of the decoder.
+  * @param[in] count - the number of bits, at most 32.
+  *
+  * @returns the bits, or -1 if the file ended
+  *
+  * @par Example:
+    @verbatim
+
+    long long type = getBits(s, 2);
+
+    @endverbatim
+
+  ***********************************************************************/
+static long long getBits(inflateState& s, int count)
+{
+    long long value = 0;
+
+    if (!needBits(s, count))
+    {
+        return -1;
+    }
+
+    value = (long long)(s.bits & ((1ull << count) - 1));
+    s.bits >>= count;
+    s.bitCount -= count;
+
+    return value;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Builds the canonical Huffman code from the length of the code of each symbol, 0 for symbols that
+  * do not appear. Codes of up to HUFFMAN_FAST_BITS bits are also entered in the fast table, once for
+  * every value the bits after them can have.
+  *
+  * @param[out] h - the code.
+  * @param[in] lengths - the length of the code of each symbol.
+  * @param[in] n - the number of symbols.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned char lengths[30];
+
+    fill(lengths, lengths + 30, 5);
+    buildHuffman(s.distances, lengths, 30);
+
+    //the distance code of a fixed block
+
+    @endverbatim
+
+  ***********************************************************************/
+static void buildHuffman(huffmanCode& h, const unsigned char* lengths, int n)
+{
+    //loop variables
+    int i = 0;
+    int len = 0;
+
+    unsigned short offsets[16];
+    unsigned int code = 0;
+    unsigned int reversed = 0;
+    unsigned int next[16];
+
+    memset(h.counts, 0, sizeof(h.counts));
+    memset(h.fast, 0, sizeof(h.fast));
+
+    for (i = 0; i < n; i++)
+    {
+        h.counts[lengths[i]]++;
+    }
+
+    h.counts[0] = 0;
+    offsets[1] = 0;
+
+    for (len = 1; len < 15; len++)
+    {
+        offsets[len + 1] = offsets[len] + h.counts[len];
+    }
+
+    //first code of each length
+    code = 0;
+
+    for (len = 1; len < 16; len++)
+    {
+        code = (code + h.counts[len - 1]) << 1;
+        next[len] = code;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        len = lengths[i];
+
+        if (len == 0)
+        {
+            continue;
+        }
+
+        h.symbols[offsets[len]++] = (unsigned short)i;
+
+        code = next[len]++;
+
+        if (len <= HUFFMAN_FAST_BITS)
+        {
+            //codes are stored first bit highest, the table is read first bit lowest
+            reversed = 0;
+
+            for (int b = 0; b < len; b++)
+            {
+                reversed |= ((code >> b) & 1) << (len - 1 - b);
+            }
+
+            for (; reversed < (1u << HUFFMAN_FAST_BITS); reversed += 1u << len)
+            {
+                h.fast[reversed] = (unsigned short)(i | len << 9);
+            }
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Decodes one symbol. Short codes are found with a single lookup in the fast table, and longer ones
+  * by comparing the code a bit at a time against the first code of each length. Returns -1 if the file
+  * ends first.
+  *
+  * @param[in,out] s - the state of the decoder.
+  * @param[in] h - the code.
+  *
+  * @returns the symbol, or -1 if the file ended
+  *
+  * @par Example:
+    @verbatim
+
+    int symbol = decodeSymbol(s, s.lengths);
+
+    @endverbatim
+
+  ***********************************************************************/
+static int decodeSymbol(inflateState& s, const huffmanCode& h)
+{
+    //loop variable
+    int len = 0;
+
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    int count = 0;
+    unsigned short entry = 0;
+
+    //the last code of a file may be followed by fewer than 15 bits
+    needBits(s, 15);
+
+    entry = h.fast[s.bits & ((1u << HUFFMAN_FAST_BITS) - 1)];
+
+    if (entry != 0 && (entry >> 9) <= s.bitCount)
+    {
+        s.bits >>= entry >> 9;
+        s.bitCount -= entry >> 9;
+
+        return entry & 0x1ff;
+    }
+
+    for (len = 1; len < 16; len++)
+    {
+        if (s.bitCount == 0)
+        {
+            return -1;
+        }
+
+        code |= (int)(s.bits & 1);
+        s.bits >>= 1;
+        s.bitCount--;
+
+        count = h.counts[len];
+
+        if (code - count < first)
+        {
+            return h.symbols[index + (code - first)];
+        }
+
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+
+    invalidGzip();
+    return -1;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the header of a gzip member: the magic bytes, the method, the flags, and any extra field,
+  * file name, comment, or header checksum the flags say follow. Returns false at the end of the file
+  * or if what follows is not a member.
+  *
+  * @param[in,out] s - the state of the decoder, at the start of a member.
+  *
+  * @returns true if a member starts here
+  * @returns false at the end of the file
+  *
+  * @par Example:
+    @verbatim
+
+    if (readMemberHeader(s))
+    {
+        //s is at the first block of the member
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool readMemberHeader(inflateState& s)
+{
+    //loop variable
+    int k = 0;
+
+    long long id1 = getBits(s, 8);
+    long long id2 = getBits(s, 8);
+    long long method = getBits(s, 8);
+    long long flags = getBits(s, 8);
+    long long extra = 0;
+
+    //a file that ends inside the magic bytes of a member is cut short
+    if (id1 == 0x1f && id2 < 0)
+    {
+        invalidGzip();
+    }
+
+    //anything after the last member is ignored, as gzip does
+    if (id1 != 0x1f || id2 != 0x8b)
+    {
+        return false;
+    }
+
+    if (method != 8)
+    {
+        invalidGzip();
+    }
+
+    //time, extra flags, and system
+    for (k = 0; k < 6; k++)
+    {
+        getBits(s, 8);
+    }
+
+    if (flags & 4)
+    {
+        extra = getBits(s, 16);
+
+        while (extra-- > 0)
+        {
+            getBits(s, 8);
+        }
+    }
+
+    //file name and comment, each ending in a zero
+    for (k = 8; k <= 16; k += 8)
+    {
+        if (flags & k)
+        {
+            while (getBits(s, 8) > 0);
+        }
+    }
+
+    if (flags & 2)
+    {
+        getBits(s, 16);
+    }
+
+    s.crc = 0;
+    s.size = 0;
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the header of a block. A stored block is followed by its length. A fixed block uses the codes
+  * from the format. A dynamic block is followed by its own codes, which are themselves stored with a
+  * Huffman code of the lengths 0 to 15 and three codes that repeat lengths.
+  *
+  * @param[in,out] s - the state of the decoder, at the start of a block.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readBlockHeader(s);
+
+    //s.step is INFLATE_STORED or INFLATE_CODES
+
+    @endverbatim
+
+  ***********************************************************************/
+static void readBlockHeader(inflateState& s)
+{
+    //loop variables
+    int i = 0;
+
+    long long type = 0;
+    long long length = 0;
+    int literals = 0;
+    int distances = 0;
+    int codes = 0;
+    int symbol = 0;
+    int repeat = 0;
+    unsigned char value = 0;
+
+    unsigned char lengths[320];
+    huffmanCode codeLengths;
+
+    s.lastBlock = getBits(s, 1) == 1;
+    type = getBits(s, 2);
+
+    //not compressed, starts at the next byte
+    if (type == 0)
+    {
+        s.bits >>= s.bitCount % 8;
+        s.bitCount -= s.bitCount % 8;
+
+        length = getBits(s, 16);
+
+        if (length < 0 || getBits(s, 16) != (~length & 0xffff))
+        {
+            invalidGzip();
+        }
+
+        s.storedLeft = (size_t)length;
+        s.step = INFLATE_STORED;
+
+        return;
+    }
+
+    //fixed codes
+    if (type == 1)
+    {
+        fill(lengths, lengths + 144, 8);
+        fill(lengths + 144, lengths + 256, 9);
+        fill(lengths + 256, lengths + 280, 7);
+        fill(lengths + 280, lengths + 288, 8);
+        buildHuffman(s.lengths, lengths, 288);
+
+        fill(lengths, lengths + 30, 5);
+        buildHuffman(s.distances, lengths, 30);
+
+        s.step = INFLATE_CODES;
+
+        return;
+    }
+
+    if (type != 2)
+    {
+        invalidGzip();
+    }
+
+    //dynamic codes
+    literals = (int)getBits(s, 5) + 257;
+    distances = (int)getBits(s, 5) + 1;
+    codes = (int)getBits(s, 4) + 4;
+
+    memset(lengths, 0, sizeof(lengths));
+
+    for (i = 0; i < codes; i++)
+    {
+        lengths[CODE_ORDER[i]] = (unsigned char)getBits(s, 3);
+    }
+
+    buildHuffman(codeLengths, lengths, 19);
+
+    i = 0;
+
+    while (i < literals + distances)
+    {
+        symbol = decodeSymbol(s, codeLengths);
+
+        if (symbol < 0)
+        {
+            invalidGzip();
+        }
+
+        if (symbol < 16)
+        {
+            lengths[i++] = (unsigned char)symbol;
+            continue;
+        }
+
+        //16 repeats the last length, 17 and 18 repeat zero
+        value = symbol == 16 && i > 0 ? lengths[i - 1] : 0;
+        repeat = symbol == 16 ? 3 + (int)getBits(s, 2) : symbol == 17 ? 3 + (int)getBits(s, 3) : 11 + (int)getBits(s, 7);
+
+        if ((symbol == 16 && i == 0) || i + repeat > literals + distances)
+        {
+            invalidGzip();
+        }
+
+        while (repeat-- > 0)
+        {
+            lengths[i++] = value;
+        }
+    }
+
+    buildHuffman(s.lengths, lengths, literals);
+    buildHuffman(s.distances, lengths + literals, distances);
+
+    s.step = INFLATE_CODES;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Decodes bytes into out from position start until the buffer is nearly full or the file ends. The
+  * GZIP_WINDOW bytes before start must be the bytes decoded just before them, since matches copy from
+  * there. The decoder stops between symbols, so it picks up where it left off on the next call. At the
+  * end of each member the CRC-32 and size in its trailer are checked, and the next member is decoded as
+  * if it were part of the same data. A file that ends before the last block of a member and its
+  * trailer is not valid, so it is reported like a bad checksum instead of being handed back in part.
+  *
+  * @param[in,out] s - the state of the decoder.
+  * @param[in,out] out - the buffer, with the bytes before start already decoded.
+  * @param[in] start - where to put the first byte.
+  * @param[in] end - the size of the buffer.
+  *
+  * @returns the number of bytes decoded, 0 at the end of the file
+  *
+  * @par Example:
+    @verbatim
+
+    produced = inflateData(s, buffer.data(), filled, buffer.size());
+
+    //buffer[filled] to buffer[filled + produced - 1] are the next bytes of the file
+
+    @endverbatim
+
+  ***********************************************************************/
+static size_t inflateData(inflateState& s, char* out, size_t start, size_t end)
+{
+    size_t pos = start;
+    size_t crcFrom = start;
+    size_t take = 0;
+    int symbol = 0;
+    int length = 0;
+    size_t distance = 0;
+    long long extra = 0;
+    long long crc = 0;
+    long long size = 0;
+
+    while (s.step != INFLATE_DONE && pos + GZIP_MAX_MATCH <= end)
+    {
+        if (s.step == INFLATE_MEMBER)
+        {
+            s.step = readMemberHeader(s) ? INFLATE_BLOCK : INFLATE_DONE;
+        }
+
+        else if (s.step == INFLATE_BLOCK)
+        {
+            readBlockHeader(s);
+        }
+
+        else if (s.step == INFLATE_STORED)
+        {
+            take = min(s.storedLeft, end - pos);
+
+            //the rest of the bytes already read, then straight from the file
+            while (take > 0 && s.bitCount >= 8)
+            {
+                out[pos++] = (char)(s.bits & 0xff);
+                s.bits >>= 8;
+                s.bitCount -= 8;
+                s.storedLeft--;
+                take--;
+            }
+
+            if (take > 0)
+            {
+                take = (size_t)s.source->sgetn(out + pos, (streamsize)take);
+                pos += take;
+                s.storedLeft -= take;
+
+                //the file ended inside the block
+                if (take == 0)
+                {
+                    invalidGzip();
+                }
+            }
+
+            if (s.storedLeft == 0)
+            {
+                s.step = s.lastBlock ? INFLATE_MEMBER : INFLATE_BLOCK;
+            }
+        }
+
+        else
+        {
+            symbol = decodeSymbol(s, s.lengths);
+
+            if (symbol < 256)
+            {
+                //the file ended before the end of the block
+                if (symbol < 0)
+                {
+                    invalidGzip();
+                }
+
+                out[pos++] = (char)symbol;
+                continue;
+            }
+
+            //end of the block
+            if (symbol == 256)
+            {
+                s.step = s.lastBlock ? INFLATE_MEMBER : INFLATE_BLOCK;
+            }
+
+            else
+            {
+                symbol -= 257;
+
+                if (symbol >= 29)
+                {
+                    invalidGzip();
+                }
+
+                extra = getBits(s, LENGTH_EXTRA[symbol]);
+                length = LENGTH_BASE[symbol] + (int)extra;
+
+                symbol = decodeSymbol(s, s.distances);
+
+                if (extra < 0 || symbol < 0)
+                {
+                    invalidGzip();
+                }
+
+                if (symbol >= 30)
+                {
+                    invalidGzip();
+                }
+
+                extra = getBits(s, DIST_EXTRA[symbol]);
+                distance = DIST_BASE[symbol] + (size_t)extra;
+
+                if (extra < 0)
+                {
+                    invalidGzip();
+                }
+
+                if (distance > pos)
+                {
+                    invalidGzip();
+                }
+
+                //byte by byte, since the copy may overlap what it writes
+                while (length-- > 0)
+                {
+                    out[pos] = out[pos - distance];
+                    pos++;
+                }
+            }
+        }
+
+        //end of a member, check its trailer
+        if (s.step == INFLATE_MEMBER)
+        {
+            s.crc = crc32Update(s.crc, out + crcFrom, pos - crcFrom);
+            s.size += (unsigned int)(pos - crcFrom);
+            crcFrom = pos;
+
+            s.bits >>= s.bitCount % 8;
+            s.bitCount -= s.bitCount % 8;
+
+            crc = getBits(s, 32);
+            size = getBits(s, 32);
+
+            //a missing trailer is as wrong as a bad one
+            if (crc < 0 || size < 0 || (unsigned int)crc != s.crc || (unsigned int)size != s.size)
+            {
+                invalidGzip();
+            }
+        }
+    }
+
+    s.crc = crc32Update(s.crc, out + crcFrom, pos - crcFrom);
+    s.size += (unsigned int)(pos - crcFrom);
+
+    return pos - start;
+}
+
+
+/**
+ * @brief A stream buffer that decodes a gzip file as it is read. The decoded bytes are kept in a
+ *        buffer whose first GZIP_WINDOW bytes are the bytes decoded before the current chunk.
+ *        Seeking forward decodes and skips, and seeking back before the buffer starts over.
+ */
+class gzipInputBuffer : public streambuf
+{
+public:
+    explicit gzipInputBuffer(streambuf* file);
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, ios_base::openmode which) override;
+
+private:
+    streambuf* file;            /**< The buffer of the compressed file. */
+    inflateState state;         /**< The state of the decoder. */
+    vector<char> buffer;        /**< The decoded bytes. */
+    long long base = 0;         /**< Position of buffer[0] in the decoded file. */
+    size_t filled = 0;          /**< Number of decoded bytes in the buffer. */
+};
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Starts decoding the gzip file read through file, from its beginning.
+  *
+  * @param[in] file - the buffer of the compressed file.
+  *
+  * @par Example:
+    @verbatim
+
+    gzipInputBuffer* gz = new gzipInputBuffer(fin.rdbuf());
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipInputBuffer::gzipInputBuffer(streambuf* file) : file(file), buffer(GZIP_WINDOW + GZIP_INPUT_CHUNK)
+{
+    state.source = file;
+    setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Decodes the next chunk once every decoded byte has been read. Only the last GZIP_WINDOW bytes are
+  * kept in front of the new chunk.
+  *
+  * @returns the next byte, or EOF at the end of the file
+  *
+  * @par Example:
+    @verbatim
+
+    fin >> img.magicNumber;
+
+    //calls underflow whenever the decoded bytes run out
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipInputBuffer::int_type gzipInputBuffer::underflow()
+{
+    size_t produced = 0;
+
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    //keeping the bytes that matches can copy from
+    if (filled > GZIP_WINDOW)
+    {
+        memmove(buffer.data(), buffer.data() + filled - GZIP_WINDOW, GZIP_WINDOW);
+        base += (long long)(filled - GZIP_WINDOW);
+        filled = GZIP_WINDOW;
+    }
+
+    produced = inflateData(state, buffer.data(), filled, buffer.size());
+
+    setg(buffer.data(), buffer.data() + filled, buffer.data() + filled + produced);
+    filled += produced;
+
+    if (produced == 0)
+    {
+        return traits_type::eof();
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Moves to a position relative to the start, the current position, or the end of the decoded file.
+  * The end is found by decoding the rest of the file.
+  *
+  * @param[in] off - the offset from dir.
+  * @param[in] dir - where the offset is measured from.
+  * @param[in] which - must include ios::in.
+  *
+  * @returns the new position, or -1 if it is outside the file
+  *
+  * @par Example:
+    @verbatim
+
+    fin.seekg(0, ios::end);
+
+    //fin.tellg() is the size of the decoded file
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipInputBuffer::pos_type gzipInputBuffer::seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which)
+{
+    if (!(which & ios_base::in))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    if (dir == ios_base::cur)
+    {
+        off += base + (gptr() - eback());
+    }
+
+    else if (dir == ios_base::end)
+    {
+        while (underflow() != traits_type::eof())
+        {
+            setg(eback(), egptr(), egptr());
+        }
+
+        off += base + (long long)filled;
+    }
+
+    return seekpos(pos_type(off), which);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Moves to a position in the decoded file. A position in the buffer is reached at once, a later one
+  * by decoding and skipping, and an earlier one by decoding again from the start of the file.
+  *
+  * @param[in] pos - the position.
+  * @param[in] which - must include ios::in.
+  *
+  * @returns the new position, or -1 if it is outside the file
+  *
+  * @par Example:
+    @verbatim
+
+    fin.seekg(0, ios::beg);
+
+    //starts decoding the file again
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipInputBuffer::pos_type gzipInputBuffer::seekpos(pos_type pos, ios_base::openmode which)
+{
+    long long target = (long long)(off_type)pos;
+
+    if (!(which & ios_base::in) || target < 0)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    //before the buffer, start over
+    if (target < base)
+    {
+        file->pubseekpos(0, ios_base::in);
+        state = inflateState();
+        state.source = file;
+        base = 0;
+        filled = 0;
+        setg(buffer.data(), buffer.data(), buffer.data());
+    }
+
+    //after the buffer, decode and skip
+    while (target > base + (long long)filled)
+    {
+        setg(eback(), egptr(), egptr());
+
+        if (underflow() == traits_type::eof())
+        {
+            return pos_type(off_type(-1));
+        }
+    }
+
+    setg(buffer.data(), buffer.data() + (target - base), buffer.data() + filled);
+
+    return pos;
+}
+
+
+/**
+ * @brief A stream buffer that compresses what is written to it into a gzip file. The bytes are
+ *        gathered until there is a block of GZIP_BLOCK bytes for every thread, and the blocks are
+ *        then compressed in parallel, each into a gzip member of its own, and written in order.
+ */
+class gzipOutputBuffer : public streambuf
+{
+public:
+    explicit gzipOutputBuffer(streambuf* file);
+    void finish();
+
+protected:
+    int_type overflow(int_type c) override;
+
+private:
+    void compressPending();
+
+    streambuf* file;            /**< The buffer of the compressed file. */
+    vector<char> pending;       /**< The bytes waiting to be compressed. */
+};
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds a single block of Huffman codes to out that holds data, with literals and matches found in
+  * the GZIP_WINDOW bytes before them. Each position is entered in a hash table by its next three bytes,
+  * and up to GZIP_CHAIN earlier positions with the same hash are tried for the longest match. The fixed
+  * codes of the format are used, so the block needs no tables of its own.
+  *
+  * @param[in] data - the bytes to compress.
+  * @param[in] n - the number of bytes.
+  * @param[in,out] out - the compressed bytes are added to the end.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    deflateFixed(pending.data(), pending.size(), out);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void deflateFixed(const unsigned char* data, size_t n, vector<unsigned char>& out)
+{
+    //loop variables
+    size_t i = 0;
+    size_t k = 0;
+
+    unsigned long long bits = 0;
+    int bitCount = 0;
+
+    int code = 0;
+    int best = 0;
+    int match = 0;
+    int chain = 0;
+    size_t bestDistance = 0;
+    long long candidate = 0;
+    unsigned int hash = 0;
+
+    //the fixed codes, first bit lowest
+    static unsigned short literalCode[288];
+    static unsigned char literalLength[288];
+    static once_flag ready;
+
+    vector<int> head(1 << 15, -1);
+    vector<int> previous(n);
+
+    call_once(ready, []()
+    {
+        int s = 0;
+        int b = 0;
+        unsigned int c = 0;
+
+        for (s = 0; s < 288; s++)
+        {
+            literalLength[s] = (unsigned char)(s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8);
+            c = s < 144 ? 0x30 + s : s < 256 ? 0x190 + s - 144 : s < 280 ? s - 256 : 0xc0 + s - 280;
+            literalCode[s] = 0;
+
+            for (b = 0; b < literalLength[s]; b++)
+            {
+                literalCode[s] |= (unsigned short)(((c >> b) & 1) << (literalLength[s] - 1 - b));
+            }
+        }
+    });
+
+    auto putBits = [&](unsigned int value, int count)
+    {
+        bits |= (unsigned long long)value << bitCount;
+        bitCount += count;
+
+        while (bitCount >= 8)
+        {
+            out.push_back((unsigned char)bits);
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    };
+
+    //distance codes are five bits, first bit highest
+    auto putDistanceCode = [&](int d)
+    {
+        unsigned int reversed = 0;
+
+        for (int b = 0; b < 5; b++)
+        {
+            reversed |= ((d >> b) & 1) << (4 - b);
+        }
+
+        putBits(reversed, 5);
+    };
+
+    //the last block, with fixed codes
+    putBits(1, 1);
+    putBits(1, 2);
+
+    while (i < n)
+    {
+        best = 0;
+
+        if (i + GZIP_MIN_MATCH <= n)
+        {
+            hash = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & 0x7fff;
+            candidate = head[hash];
+            previous[i] = (int)candidate;
+            head[hash] = (int)i;
+
+            for (chain = 0; chain < GZIP_CHAIN && candidate >= 0 && i - candidate <= GZIP_WINDOW; chain++)
+            {
+                match = 0;
+
+                while (match < GZIP_MAX_MATCH && i + match < n && data[candidate + match] == data[i + match])
+                {
+                    match++;
+                }
+
+                if (match > best)
+                {
+                    best = match;
+                    bestDistance = i - (size_t)candidate;
+
+                    if (best == GZIP_MAX_MATCH)
+                    {
+                        break;
+                    }
+                }
+
+                candidate = previous[candidate];
+            }
+        }
+
+        if (best < GZIP_MIN_MATCH)
+        {
+            putBits(literalCode[data[i]], literalLength[data[i]]);
+            i++;
+            continue;
+        }
+
+        //the length code and its extra bits
+        code = (int)(upper_bound(LENGTH_BASE, LENGTH_BASE + 29, best) - LENGTH_BASE) - 1;
+        putBits(literalCode[257 + code], literalLength[257 + code]);
+        putBits(best - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+        //the distance code and its extra bits
+        code = (int)(upper_bound(DIST_BASE, DIST_BASE + 30, bestDistance) - DIST_BASE) - 1;
+        putDistanceCode(code);
+        putBits((unsigned int)(bestDistance - DIST_BASE[code]), DIST_EXTRA[code]);
+
+        //entering the positions inside the match
+        for (k = i + 1; k < i + best && k + GZIP_MIN_MATCH <= n; k++)
+        {
+            hash = ((data[k] << 10) ^ (data[k + 1] << 5) ^ data[k + 2]) & 0x7fff;
+            previous[k] = head[hash];
+            head[hash] = (int)k;
+        }
+
+        i += best;
+    }
+
+    //end of the block, then up to the next byte
+    putBits(literalCode[256], literalLength[256]);
+    putBits(0, (8 - bitCount % 8) % 8);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds data to out as stored blocks, which hold the bytes as they are after a header of their length,
+  * GZIP_STORED bytes at most each. The last block is marked as the last. Bytes that do not compress,
+  * like noise or a QOI file, take 5 bytes more per block this way instead of growing by the codes.
+  *
+  * @param[in] data - the bytes.
+  * @param[in] n - the number of bytes.
+  * @param[in,out] out - the blocks are added to the end.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    deflateStored(data, n, out);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void deflateStored(const unsigned char* data, size_t n, vector<unsigned char>& out)
+{
+    //loop variable
+    size_t i = 0;
+
+    size_t take = 0;
+
+    do
+    {
+        take = min(GZIP_STORED, n - i);
+
+        //the last block bit and the stored type, padded to the byte, then the length and its complement
+        out.push_back(i + take == n ? 1 : 0);
+        out.push_back((unsigned char)take);
+        out.push_back((unsigned char)(take >> 8));
+        out.push_back((unsigned char)~take);
+        out.push_back((unsigned char)(~take >> 8));
+        out.insert(out.end(), data + i, data + i + take);
+
+        i += take;
+    } while (i < n);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Compresses data into a complete gzip member: the header, the compressed block, and the trailer with
+  * the CRC-32 and size of data. If the block with fixed codes comes out larger than the data stored as
+  * it is, the data is stored instead, so a member is never more than a few bytes larger than its data.
+  * Members can be written one after another, and together they decompress to the bytes of every member
+  * in order.
+  *
+  * @param[in] data - the bytes to compress.
+  * @param[in] n - the number of bytes.
+  * @param[out] out - the member.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    gzipMember(block, GZIP_BLOCK, members[b]);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void gzipMember(const char* data, size_t n, vector<unsigned char>& out)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned int crc = crc32Update(0, data, n);
+    static const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+
+    out.assign(header, header + 10);
+
+    deflateFixed((const unsigned char*)data, n, out);
+
+    //storing the bytes is smaller
+    if (out.size() - 10 > n + 5 * max((size_t)1, (n + GZIP_STORED - 1) / GZIP_STORED))
+    {
+        out.resize(10);
+        deflateStored((const unsigned char*)data, n, out);
+    }
+
+    for (k = 0; k < 4; k++)
+    {
+        out.push_back((unsigned char)(crc >> (8 * k)));
+    }
+
+    for (k = 0; k < 4; k++)
+    {
+        out.push_back((unsigned char)((unsigned int)n >> (8 * k)));
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Starts compressing into the file written through file, with room for a block per thread.
+  *
+  * @param[in] file - the buffer of the compressed file.
+  *
+  * @par Example:
+    @verbatim
+
+    gzipOutputBuffer* gz = new gzipOutputBuffer(fout.rdbuf());
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipOutputBuffer::gzipOutputBuffer(streambuf* file) : file(file), pending(GZIP_BLOCK * threadCount())
+{
+    setp(pending.data(), pending.data() + pending.size());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Compresses the pending blocks in parallel, one gzip member per block, and writes the members to the
+  * file in order. The buffer is then empty again.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    compressPending();
+
+    //every byte written so far is in the file
+
+    @endverbatim
+
+  ***********************************************************************/
+void gzipOutputBuffer::compressPending()
+{
+    //loop variable
+    size_t b = 0;
+
+    size_t n = (size_t)(pptr() - pbase());
+    size_t blocks = (n + GZIP_BLOCK - 1) / GZIP_BLOCK;
+    vector<vector<unsigned char>> members(blocks);
+
+    parallelFor(0, (int)blocks, [&](int blockStart, int blockEnd)
+    {
+        int m = 0;
+
+        for (m = blockStart; m < blockEnd; m++)
+        {
+            gzipMember(pbase() + (size_t)m * GZIP_BLOCK, min(GZIP_BLOCK, n - (size_t)m * GZIP_BLOCK), members[m]);
+        }
+    });
+
+    for (b = 0; b < blocks; b++)
+    {
+        file->sputn((const char*)members[b].data(), (streamsize)members[b].size());
+    }
+
+    setp(pending.data(), pending.data() + pending.size());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Compresses the full buffer and stores c as the first byte of the next one.
+  *
+  * @param[in] c - the byte that did not fit, or EOF.
+  *
+  * @returns c, or something other than EOF if c is EOF
+  *
+  * @par Example:
+    @verbatim
+
+    fout.write((char*)band.data(), band.size());
+
+    //calls overflow each time the buffer fills up
+
+    @endverbatim
+
+  ***********************************************************************/
+gzipOutputBuffer::int_type gzipOutputBuffer::overflow(int_type c)
+{
+    compressPending();
+
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        return traits_type::not_eof(c);
+    }
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+
+    return c;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Compresses whatever is still pending. Flushing the stream does not do this, since the output
+  * functions flush after every line and each flush would start a new member.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    gz->finish();
+
+    //the file holds every byte written, compressed
+
+    @endverbatim
+
+  ***********************************************************************/
+void gzipOutputBuffer::finish()
+{
+    if (pptr() > pbase())
+    {
+        compressPending();
+    }
+
+    file->pubsync();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the slot of the streams where the buffer attached by attachGzipInput or attachGzipOutput
+  * is kept, so it can be found and freed later.
+  *
+  * @returns the index of the slot
+  *
+  * @par Example:
+    @verbatim
+
+    streambuf* gz = (streambuf*)fin.pword(gzipSlot());
+
+    @endverbatim
+
+  ***********************************************************************/
+static int gzipSlot()
+{
+    static int slot = ios_base::xalloc();
+
+    return slot;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Frees the buffer attached to a stream when the stream is destroyed.
+  *
+  * @param[in] ev - what is happening to the stream.
+  * @param[in,out] stream - the stream.
+  * @param[in] slot - the slot of the buffer.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fin.register_callback(freeGzip, gzipSlot());
+
+    @endverbatim
+
+  ***********************************************************************/
+static void freeGzip(ios_base::event ev, ios_base& stream, int slot)
+{
+    if (ev == ios_base::erase_event)
+    {
+        delete (streambuf*)stream.pword(slot);
+        stream.pword(slot) = nullptr;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Attaches a buffer to a stream in place of its file buffer, so everything read or written goes
+  * through it. The buffer is freed by detachGzip or when the stream is destroyed.
+  *
+  * @param[in,out] stream - the stream.
+  * @param[in] gz - the buffer.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    attachGzip(fin, new gzipInputBuffer(fin.rdbuf()));
+
+    @endverbatim
+
+  ***********************************************************************/
+static void attachGzip(ios& stream, streambuf* gz)
+{
+    //the callback is registered once per stream
+    if (stream.iword(gzipSlot()) == 0)
+    {
+        stream.register_callback(freeGzip, gzipSlot());
+        stream.iword(gzipSlot()) = 1;
+    }
+
+    stream.pword(gzipSlot()) = gz;
+    stream.rdbuf(gz);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Puts the file buffer of a stream back in place and frees any gzip buffer attached to it. Called
+  * before the stream opens another file.
+  *
+  * @param[in,out] stream - the stream.
+  * @param[in] file - the file buffer of the stream.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    detachGzip(fin, fin.rdbuf());
+    fin.open(filename, ios::in | ios::binary);
+
+    @endverbatim
+
+  ***********************************************************************/
+void detachGzip(ios& stream, streambuf* file)
+{
+    delete (streambuf*)stream.pword(gzipSlot());
+    stream.pword(gzipSlot()) = nullptr;
+
+    stream.rdbuf(file);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Checks whether a file that was just opened starts with the gzip magic bytes, and if so attaches
+  * a gzipInputBuffer, so that every read, seek, and tell of the stream works on the decompressed
+  * bytes. The readers then handle a .ppm.gz file exactly like a .ppm file, without a temporary file.
+  *
+  * @param[in,out] fin - the input file stream, just opened.
+  *
+  * @returns true if the file is compressed
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    openInputFile(fin, "cats.ppm.gz");
+
+    //calls attachGzipInput, and fin reads the decompressed image
+
+    @endverbatim
+
+  ***********************************************************************/
+bool attachGzipInput(ifstream& fin)
+{
+    char magic[2] = { 0, 0 };
+    filebuf* file = fin.rdbuf();
+
+    if (file->sgetn(magic, 2) != 2 || (unsigned char)magic[0] != 0x1f || (unsigned char)magic[1] != 0x8b)
+    {
+        file->pubseekpos(0, ios_base::in);
+        return false;
+    }
+
+    file->pubseekpos(0, ios_base::in);
+    attachGzip(fin, new gzipInputBuffer(file));
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Attaches a gzipOutputBuffer to an output file that was just opened, so that everything written
+  * to it is compressed. It goes in front of the buffer the stream writes to, the file buffer or the
+  * checksum buffer of attachChecksumOutput.
+  *
+  * @param[in,out] fout - the output file stream, just opened.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fout.open("dogs.ppm.gz", ios::out | ios::trunc | ios::binary);
+    attachGzipOutput(fout);
+
+    @endverbatim
+
+  ***********************************************************************/
+void attachGzipOutput(ofstream& fout)
+{
+    ios& stream = fout;
+
+    attachGzip(fout, new gzipOutputBuffer(stream.rdbuf()));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Compresses and writes what is still pending in the gzip buffer of an output file, if it has one,
+  * and puts its file buffer back in place. Must be called before the file is closed.
+  *
+  * @param[in,out] fout - the output file stream.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    finishGzipOutput(fout);
+    fout.close();
+
+    @endverbatim
+
+  ***********************************************************************/
+void finishGzipOutput(ofstream& fout)
+{
+    gzipOutputBuffer* gz = dynamic_cast<gzipOutputBuffer*>((streambuf*)fout.pword(gzipSlot()));
+
+    if (gz != nullptr)
+    {
+        gz->finish();
+    }
+
+    detachGzip(fout, fout.rdbuf());
+}
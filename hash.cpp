@@ -0,0 +1,1092 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the xxHash64 hash of a block of bytes, computed all at once or in pieces, and the
+ *          CRC-32C checksum of the output files, computed while they are written
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief SSE4.2 has an instruction for CRC-32C. On x86 the function that uses it is always compiled,
+ *        for SSE4.2 only, and it is called when the processor reports SSE4.2 at run time. Otherwise
+ *        the checksum is computed 8 bytes at a time with tables.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HASH_SSE42
+#ifdef _MSC_VER
+#include <intrin.h>
+#define HASH_SSE42_TARGET
+#else
+#define HASH_SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+#endif
+
+/**
+ * @brief The five primes of xxHash64.
+ */
+const unsigned long long XXH_PRIME1 = 11400714785074694791ULL;
+const unsigned long long XXH_PRIME2 = 14029467366897019727ULL;
+const unsigned long long XXH_PRIME3 = 1609587929392839161ULL;
+const unsigned long long XXH_PRIME4 = 9650029242287828579ULL;
+const unsigned long long XXH_PRIME5 = 2870177450012600261ULL;
+
+/**
+ * @brief The polynomial of CRC-32C, the Castagnoli polynomial, with its bits reversed.
+ */
+const unsigned int CRC32C_POLY = 0x82F63B78;
+
+/**
+ * @brief Bytes gathered by the checksum buffer before they are checked and passed to the file.
+ */
+const size_t CHECKSUM_BUFFER = 1 << 16;
+
+/**
+ * @brief The bits of the iword of checksumSlot: the callback that frees the buffer is registered,
+ *        and checksums are on for the stream.
+ */
+const long CHECKSUM_CALLBACK = 1;
+const long CHECKSUM_WANTED = 2;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates the bits of a 64 bit value to the left.
+  *
+  * @param[in] value - the value.
+  * @param[in] bits - the number of bits to rotate by, 1 to 63.
+  *
+  * @returns the rotated value
+  *
+  * @par Example:
+    @verbatim
+
+    rotateLeft(0x8000000000000001ULL, 1);
+
+    //returns 3
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned long long rotateLeft(unsigned long long value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads 8 bytes as a little endian number, whatever the alignment of the bytes.
+  *
+  * @param[in] bytes - the bytes.
+  *
+  * @returns the number
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned long long v = read64(data + 8);
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned long long read64(const unsigned char* bytes)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned long long value = 0;
+
+    for (k = 7; k >= 0; k--)
+    {
+        value = (value << 8) | bytes[k];
+    }
+
+    return value;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads 4 bytes as a little endian number, whatever the alignment of the bytes.
+  *
+  * @param[in] bytes - the bytes.
+  *
+  * @returns the number
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned long long v = read32(p);
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned long long read32(const unsigned char* bytes)
+{
+    return (unsigned long long)bytes[0] | (unsigned long long)bytes[1] << 8 | (unsigned long long)bytes[2] << 16 |
+        (unsigned long long)bytes[3] << 24;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Mixes 8 bytes of input into one of the four lanes of xxHash64.
+  *
+  * @param[in] lane - the lane.
+  * @param[in] input - the 8 bytes, as a little endian number.
+  *
+  * @returns the new value of the lane
+  *
+  * @par Example:
+    @verbatim
+
+    state.lane[0] = xxRound(state.lane[0], read64(data));
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned long long xxRound(unsigned long long lane, unsigned long long input)
+{
+    lane += input * XXH_PRIME2;
+    lane = rotateLeft(lane, 31);
+
+    return lane * XXH_PRIME1;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Sets up the state of an xxHash64 for a new stream of bytes.
+  *
+  * @param[out] state - the state of the hash.
+  * @param[in] seed - the seed, which gives a different hash for the same bytes.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    xxHashState state;
+
+    xxHashInit(state, 0);
+    xxHashUpdate(state, data, size);
+
+    unsigned long long h = xxHashFinal(state);
+
+    @endverbatim
+
+  ***********************************************************************/
+void xxHashInit(xxHashState& state, unsigned long long seed)
+{
+    state.lane[0] = seed + XXH_PRIME1 + XXH_PRIME2;
+    state.lane[1] = seed + XXH_PRIME2;
+    state.lane[2] = seed;
+    state.lane[3] = seed - XXH_PRIME1;
+    state.seed = seed;
+    state.total = 0;
+    state.buffered = 0;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds bytes to the hash. The bytes are taken 32 at a time, 8 into each of the four lanes, and
+  * the few that are left over wait in the state for the next call, so a stream can be hashed in
+  * pieces of any size and gives the same hash as hashing it at once.
+  *
+  * @param[in,out] state - the state of the hash.
+  * @param[in] data - the bytes.
+  * @param[in] size - the number of bytes.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    xxHashUpdate(state, buffer.data(), fin.gcount());
+
+    @endverbatim
+
+  ***********************************************************************/
+void xxHashUpdate(xxHashState& state, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + size;
+    size_t take = 0;
+
+    state.total += size;
+
+    //finishing the 32 bytes left over from the last call
+    if (state.buffered > 0)
+    {
+        take = min(size, (size_t)32 - state.buffered);
+        memcpy(state.buffer + state.buffered, p, take);
+
+        state.buffered += take;
+        p += take;
+
+        if (state.buffered < 32)
+        {
+            return;
+        }
+
+        state.lane[0] = xxRound(state.lane[0], read64(state.buffer));
+        state.lane[1] = xxRound(state.lane[1], read64(state.buffer + 8));
+        state.lane[2] = xxRound(state.lane[2], read64(state.buffer + 16));
+        state.lane[3] = xxRound(state.lane[3], read64(state.buffer + 24));
+        state.buffered = 0;
+    }
+
+    for (; end - p >= 32; p += 32)
+    {
+        state.lane[0] = xxRound(state.lane[0], read64(p));
+        state.lane[1] = xxRound(state.lane[1], read64(p + 8));
+        state.lane[2] = xxRound(state.lane[2], read64(p + 16));
+        state.lane[3] = xxRound(state.lane[3], read64(p + 24));
+    }
+
+    memcpy(state.buffer, p, end - p);
+    state.buffered = end - p;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the hash of every byte added since xxHashInit. The four lanes are merged, the bytes
+  * still in the state are mixed in, and the bits are mixed once more so that every bit of the hash
+  * depends on every bit of the input. The state is not changed, so more bytes can still be added.
+  *
+  * @param[in] state - the state of the hash.
+  *
+  * @returns the 64 bit hash
+  *
+  * @par Example:
+    @verbatim
+
+    xxHashInit(state, 0);
+
+    xxHashFinal(state);
+
+    //returns 0xef46db3751d8e999, the hash of no bytes
+
+    @endverbatim
+
+  ***********************************************************************/
+unsigned long long xxHashFinal(const xxHashState& state)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned long long h = 0;
+    const unsigned char* p = state.buffer;
+    const unsigned char* end = state.buffer + state.buffered;
+
+    if (state.total >= 32)
+    {
+        h = rotateLeft(state.lane[0], 1) + rotateLeft(state.lane[1], 7) + rotateLeft(state.lane[2], 12) +
+            rotateLeft(state.lane[3], 18);
+
+        for (k = 0; k < 4; k++)
+        {
+            h ^= xxRound(0, state.lane[k]);
+            h = h * XXH_PRIME1 + XXH_PRIME4;
+        }
+    }
+
+    else
+    {
+        h = state.seed + XXH_PRIME5;
+    }
+
+    h += state.total;
+
+    for (; end - p >= 8; p += 8)
+    {
+        h ^= xxRound(0, read64(p));
+        h = rotateLeft(h, 27) * XXH_PRIME1 + XXH_PRIME4;
+    }
+
+    if (end - p >= 4)
+    {
+        h ^= read32(p) * XXH_PRIME1;
+        h = rotateLeft(h, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+
+    for (; p < end; p++)
+    {
+        h ^= *p * XXH_PRIME5;
+        h = rotateLeft(h, 11) * XXH_PRIME1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the xxHash64 of a block of bytes.
+  *
+  * @param[in] data - the bytes.
+  * @param[in] size - the number of bytes.
+  * @param[in] seed - the seed, which gives a different hash for the same bytes.
+  *
+  * @returns the 64 bit hash
+  *
+  * @par Example:
+    @verbatim
+
+    xxHash64("abc", 3, 0);
+
+    //returns 0x44bc2cf5ad770999
+
+    @endverbatim
+
+  ***********************************************************************/
+unsigned long long xxHash64(const void* data, size_t size, unsigned long long seed)
+{
+    xxHashState state;
+
+    xxHashInit(state, seed);
+    xxHashUpdate(state, data, size);
+
+    return xxHashFinal(state);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the eight tables of CRC-32C, built the first time they are needed. Table 0 holds the
+  * checksum of each byte value, and table k the checksum of a byte followed by k zero bytes, so that
+  * eight bytes can be taken at once with one lookup each.
+  *
+  * @returns the 8 x 256 table entries, table k at k * 256
+  *
+  * @par Example:
+    @verbatim
+
+    const unsigned int* table = crc32cTable();
+
+    //table[1] is 0xf26b8303
+
+    @endverbatim
+
+  ***********************************************************************/
+static const unsigned int* crc32cTable()
+{
+    static const vector<unsigned int> table = []()
+    {
+        int n = 0;
+        int k = 0;
+        unsigned int c = 0;
+
+        vector<unsigned int> t(8 * 256);
+
+        for (n = 0; n < 256; n++)
+        {
+            c = n;
+
+            for (k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? CRC32C_POLY ^ (c >> 1) : c >> 1;
+            }
+
+            t[n] = c;
+        }
+
+        for (k = 1; k < 8; k++)
+        {
+            for (n = 0; n < 256; n++)
+            {
+                t[k * 256 + n] = (t[(k - 1) * 256 + n] >> 8) ^ t[t[(k - 1) * 256 + n] & 0xff];
+            }
+        }
+
+        return t;
+    }();
+
+    return table.data();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds bytes to an inverted CRC-32C checksum with the eight tables from crc32cTable, 8 bytes at a time.
+  *
+  * @param[in] crc - the inverted checksum of the bytes before these.
+  * @param[in] p - the first byte.
+  * @param[in] end - one past the last byte.
+  *
+  * @returns the inverted checksum
+  *
+  * @par Example:
+    @verbatim
+
+    ~crc32cTables(~0u, data, data + 9);
+
+    //is the checksum of 9 bytes
+
+    @endverbatim
+
+  ***********************************************************************/
+static unsigned int crc32cTables(unsigned int crc, const unsigned char* p, const unsigned char* end)
+{
+    const unsigned int* table = crc32cTable();
+    unsigned int low = 0;
+    unsigned int high = 0;
+
+    for (; end - p >= 8; p += 8)
+    {
+        low = crc ^ (unsigned int)read32(p);
+        high = (unsigned int)read32(p + 4);
+
+        crc = table[7 * 256 + (low & 0xff)] ^ table[6 * 256 + ((low >> 8) & 0xff)] ^
+            table[5 * 256 + ((low >> 16) & 0xff)] ^ table[4 * 256 + (low >> 24)] ^
+            table[3 * 256 + (high & 0xff)] ^ table[2 * 256 + ((high >> 8) & 0xff)] ^
+            table[256 + ((high >> 16) & 0xff)] ^ table[high >> 24];
+    }
+
+    for (; p < end; p++)
+    {
+        crc = table[(crc ^ *p) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+
+#ifdef HASH_SSE42
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if the processor has SSE4.2, asked once with the cpuid instruction.
+  *
+  * @returns true if the crc32 instruction can be used
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    crc32cHardware();
+
+    //returns true on any x64 processor from 2008 on
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool crc32cHardware()
+{
+#ifdef _MSC_VER
+    static const bool supported = []()
+    {
+        int info[4] = { 0, 0, 0, 0 };
+
+        //bit 20 of ecx of leaf 1
+        __cpuid(info, 1);
+
+        return (info[2] & (1 << 20)) != 0;
+    }();
+#else
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+#endif
+
+    return supported;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds bytes to an inverted CRC-32C checksum with the crc32 instruction of SSE4.2, 8 bytes at a time
+  * on x64 and 4 at a time on x86. Only called when crc32cHardware returns true.
+  *
+  * @param[in] crc - the inverted checksum of the bytes before these.
+  * @param[in] p - the first byte.
+  * @param[in] end - one past the last byte.
+  *
+  * @returns the inverted checksum
+  *
+  * @par Example:
+    @verbatim
+
+    ~crc32cInstruction(~0u, data, data + 9);
+
+    //is the checksum of 9 bytes
+
+    @endverbatim
+
+  ***********************************************************************/
+HASH_SSE42_TARGET static unsigned int crc32cInstruction(unsigned int crc, const unsigned char* p, const unsigned char* end)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    unsigned long long wide = crc;
+
+    for (; end - p >= 8; p += 8)
+    {
+        wide = _mm_crc32_u64(wide, read64(p));
+    }
+
+    crc = (unsigned int)wide;
+#endif
+
+    for (; end - p >= 4; p += 4)
+    {
+        crc = _mm_crc32_u32(crc, (unsigned int)read32(p));
+    }
+
+    for (; p < end; p++)
+    {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+
+    return crc;
+}
+#endif
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds bytes to a CRC-32C checksum, the checksum of iSCSI and ext4, and returns the new checksum.
+  * Start with 0; the checksum of a stream in pieces is the same as the checksum of it at once. When
+  * the processor has SSE4.2 the crc32 instruction takes 8 bytes at a time, and otherwise the eight
+  * tables from crc32cTable do, so both give the same checksum at several bytes per cycle.
+  *
+  * @param[in] crc - the checksum of the bytes before these, 0 to start.
+  * @param[in] data - the bytes.
+  * @param[in] size - the number of bytes.
+  *
+  * @returns the checksum
+  *
+  * @par Example:
+    @verbatim
+
+    crc32c(0, "123456789", 9);
+
+    //returns 0xe3069283
+
+    @endverbatim
+
+  ***********************************************************************/
+unsigned int crc32c(unsigned int crc, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+
+#ifdef HASH_SSE42
+    if (crc32cHardware())
+    {
+        return ~crc32cInstruction(~crc, p, p + size);
+    }
+#endif
+
+    return ~crc32cTables(~crc, p, p + size);
+}
+
+
+/**
+ * @brief A stream buffer that passes what is written to it on to a file and computes the CRC-32C of
+ *        the bytes on the way, so the checksum of an output file costs no second pass over it. The
+ *        checksum is written to a file of its own, the name of the output file with .crc32c added.
+ */
+class checksumOutputBuffer : public streambuf
+{
+public:
+    checksumOutputBuffer(streambuf* file, string name);
+    void finish();
+
+protected:
+    int_type overflow(int_type c) override;
+    streamsize xsputn(const char* s, streamsize n) override;
+    int sync() override;
+
+private:
+    void forwardPending();
+
+    streambuf* file;            /**< The buffer the bytes are passed on to. */
+    string name;                /**< The name of the output file. */
+    unsigned int crc;           /**< The checksum of the bytes passed on so far. */
+    vector<char> pending;       /**< The bytes waiting to be checked and passed on. */
+};
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Makes a checksum buffer in front of a file buffer.
+  *
+  * @param[in] file - the buffer of the output file, or of the gzip buffer in front of it.
+  * @param[in] name - the name of the output file.
+  *
+  * @par Example:
+    @verbatim
+
+    checksumOutputBuffer* sum = new checksumOutputBuffer(fout.rdbuf(), "dogs.ppm");
+
+    @endverbatim
+
+  ***********************************************************************/
+checksumOutputBuffer::checksumOutputBuffer(streambuf* file, string name)
+    : file(file), name(name), crc(0), pending(CHECKSUM_BUFFER)
+{
+    setp(pending.data(), pending.data() + pending.size());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds the pending bytes to the checksum and passes them on to the file.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    forwardPending();
+
+    //the file has every byte written so far
+
+    @endverbatim
+
+  ***********************************************************************/
+void checksumOutputBuffer::forwardPending()
+{
+    streamsize n = pptr() - pbase();
+
+    crc = crc32c(crc, pbase(), (size_t)n);
+    file->sputn(pbase(), n);
+
+    setp(pending.data(), pending.data() + pending.size());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Passes the full buffer on and stores c as the first byte of the next one.
+  *
+  * @param[in] c - the byte that did not fit, or EOF.
+  *
+  * @returns c, or something other than EOF if c is EOF
+  *
+  * @par Example:
+    @verbatim
+
+    fout << value << ' ';
+
+    //calls overflow each time the buffer fills up
+
+    @endverbatim
+
+  ***********************************************************************/
+checksumOutputBuffer::int_type checksumOutputBuffer::overflow(int_type c)
+{
+    forwardPending();
+
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        return traits_type::not_eof(c);
+    }
+
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+
+    return c;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes n bytes. Bytes that fit are gathered in the buffer, and a block as large as the buffer is
+  * checked and passed on directly, so the rows of a binary image are not copied twice.
+  *
+  * @param[in] s - the bytes.
+  * @param[in] n - the number of bytes.
+  *
+  * @returns n
+  *
+  * @par Example:
+    @verbatim
+
+    fout.write((char*)band.data(), band.size());
+
+    @endverbatim
+
+  ***********************************************************************/
+streamsize checksumOutputBuffer::xsputn(const char* s, streamsize n)
+{
+    if (n > epptr() - pptr())
+    {
+        forwardPending();
+    }
+
+    if (n >= (streamsize)pending.size())
+    {
+        crc = crc32c(crc, s, (size_t)n);
+
+        return file->sputn(s, n);
+    }
+
+    memcpy(pptr(), s, (size_t)n);
+    pbump((int)n);
+
+    return n;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Passes the pending bytes on and flushes the file, when the stream is flushed.
+  *
+  * @returns 0 on success, -1 if the file could not be flushed
+  *
+  * @par Example:
+    @verbatim
+
+    fout << endl;
+
+    //calls sync
+
+    @endverbatim
+
+  ***********************************************************************/
+int checksumOutputBuffer::sync()
+{
+    forwardPending();
+
+    return file->pubsync();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Passes on whatever is still pending and writes the checksum of the whole output file to the
+  * name of the file with .crc32c added, as eight hex digits, two spaces, and the name of the file
+  * without its directory, the layout of sha256sum.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    sum->finish();
+
+    //dogs.ppm.crc32c holds "5d2a41c7  dogs.ppm"
+
+    @endverbatim
+
+  ***********************************************************************/
+void checksumOutputBuffer::finish()
+{
+    ofstream sidecar;
+
+    //the name without its directory
+    string base = name.substr(name.find_last_of("/\\") + 1);
+
+    forwardPending();
+    file->pubsync();
+
+    sidecar.open(name + ".crc32c", ios::out | ios::trunc | ios::binary);
+
+    sidecar << hex << setfill('0') << setw(8) << crc << "  " << base << "\n";
+
+    sidecar.close();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the slot of the streams where the checksum buffer is kept, with the CHECKSUM_CALLBACK and
+  * CHECKSUM_WANTED bits in its iword.
+  *
+  * @returns the index of the slot
+  *
+  * @par Example:
+    @verbatim
+
+    streambuf* sum = (streambuf*)fout.pword(checksumSlot());
+
+    @endverbatim
+
+  ***********************************************************************/
+static int checksumSlot()
+{
+    static int slot = ios_base::xalloc();
+
+    return slot;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Frees the checksum buffer of a stream when the stream is destroyed.
+  *
+  * @param[in] ev - what is happening to the stream.
+  * @param[in,out] stream - the stream.
+  * @param[in] slot - the slot of the buffer.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fout.register_callback(freeChecksum, checksumSlot());
+
+    @endverbatim
+
+  ***********************************************************************/
+static void freeChecksum(ios_base::event ev, ios_base& stream, int slot)
+{
+    if (ev == ios_base::erase_event)
+    {
+        delete (streambuf*)stream.pword(slot);
+        stream.pword(slot) = nullptr;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Removes the --checksum option from the operations, like takeCacheDir, since it changes what is
+  * written beside the output and not the output itself.
+  *
+  * @param[in,out] ops - the operations from the command line.
+  *
+  * @returns true if there was a --checksum option
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --sepia --checksum --binary old cats.ppm
+    takeChecksum(ops);
+
+    //returns true and ops only holds --sepia
+
+    @endverbatim
+
+  ***********************************************************************/
+bool takeChecksum(vector<operation>& ops)
+{
+    //loop variable
+    size_t i = 0;
+
+    bool found = false;
+
+    while (i < ops.size())
+    {
+        if (ops[i].option == "--checksum")
+        {
+            ops.erase(ops.begin() + i);
+            found = true;
+        }
+
+        else
+        {
+            i++;
+        }
+    }
+
+    return found;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Turns checksums on or off for the files opened on a stream from now on. Each stream keeps its
+  * own setting, so the branches of --fanout can differ.
+  *
+  * @param[in,out] stream - the output file stream.
+  * @param[in] enabled - true to write a checksum beside every output file.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    setChecksum(fout, true);
+    outputImage(fout, img, "--binary", "dogs", max_pix_val, false, ORIENT_NONE);
+
+    //dogs.ppm and dogs.ppm.crc32c are written
+
+    @endverbatim
+
+  ***********************************************************************/
+void setChecksum(ios& stream, bool enabled)
+{
+    if (enabled)
+    {
+        stream.iword(checksumSlot()) |= CHECKSUM_WANTED;
+    }
+
+    else
+    {
+        stream.iword(checksumSlot()) &= ~CHECKSUM_WANTED;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns whether checksums were turned on for a stream with setChecksum.
+  *
+  * @param[in,out] stream - the output file stream.
+  *
+  * @returns true if the files opened on the stream get a checksum
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    setChecksum(fout, true);
+
+    checksumRequested(fout);
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+bool checksumRequested(ios& stream)
+{
+    return (stream.iword(checksumSlot()) & CHECKSUM_WANTED) != 0;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Attaches a checksumOutputBuffer to an output file that was just opened, if checksums are on for
+  * the stream and the file did open. It goes in front of the buffer the stream writes to, so when
+  * a gzip buffer is attached after it, the checksum is of the compressed bytes in the file. Any
+  * checksum buffer left from an earlier file is freed first.
+  *
+  * @param[in,out] fout - the output file stream, just opened.
+  * @param[in] name - the name of the output file.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fout.open("dogs.ppm", ios::out | ios::trunc | ios::binary);
+    attachChecksumOutput(fout, "dogs.ppm");
+
+    @endverbatim
+
+  ***********************************************************************/
+void attachChecksumOutput(ofstream& fout, string name)
+{
+    ios& stream = fout;
+
+    delete (streambuf*)stream.pword(checksumSlot());
+    stream.pword(checksumSlot()) = nullptr;
+
+    if (!checksumRequested(stream) || !fout.is_open())
+    {
+        return;
+    }
+
+    //the callback is registered once per stream
+    if ((stream.iword(checksumSlot()) & CHECKSUM_CALLBACK) == 0)
+    {
+        stream.register_callback(freeChecksum, checksumSlot());
+        stream.iword(checksumSlot()) |= CHECKSUM_CALLBACK;
+    }
+
+    stream.pword(checksumSlot()) = new checksumOutputBuffer(stream.rdbuf(), name);
+    stream.rdbuf((streambuf*)stream.pword(checksumSlot()));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Passes on what is still pending in the checksum buffer of an output file, if it has one, writes
+  * the checksum file, and puts the file buffer back in place. Must be called after finishGzipOutput
+  * and before the file is closed.
+  *
+  * @param[in,out] fout - the output file stream.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    finishGzipOutput(fout);
+    finishChecksumOutput(fout);
+    fout.close();
+
+    @endverbatim
+
+  ***********************************************************************/
+void finishChecksumOutput(ofstream& fout)
+{
+    ios& stream = fout;
+
+    checksumOutputBuffer* sum = dynamic_cast<checksumOutputBuffer*>((streambuf*)stream.pword(checksumSlot()));
+
+    if (sum == nullptr)
+    {
+        return;
+    }
+
+    sum->finish();
+
+    delete sum;
+    stream.pword(checksumSlot()) = nullptr;
+
+    stream.rdbuf(fout.rdbuf());
+}
@@ -0,0 +1,295 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the Sobel and Scharr edge detection functions
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the gradients are computed one pixel at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EDGE_SSE2
+#endif
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Computes the two halves of a 3 x 3 kernel for one row of the source: the difference of the
+  * neighbours on the right and left of each pixel, which the horizontal gradient smooths down
+  * the columns, and the pixel and its neighbours weighted side : center : side, which the vertical
+  * gradient takes the difference of. The pixels on the edges are repeated past the edge. With SSE2,
+  * 16 pixels are widened to 16 bits and done at once.
+  *
+  * @param[in] src - the row of the source.
+  * @param[in] cols - the number of pixels.
+  * @param[in] side - the weight of the two neighbours, 1 for Sobel and 3 for Scharr.
+  * @param[in] center - the weight of the pixel, 2 for Sobel and 10 for Scharr.
+  * @param[out] diff - the difference of each pixel's neighbours.
+  * @param[out] smooth - the weighted sum of each pixel and its neighbours.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel src[3] = { 10, 20, 40 };
+    short diff[3], smooth[3];
+
+    edgeRow(src, 3, 1, 2, diff, smooth);
+
+    //diff is 10, 30, 20 and smooth is 50, 90, 140
+
+    @endverbatim
+
+  ***********************************************************************/
+static void edgeRow(const pixel* src, int cols, int side, int center, short* diff, short* smooth)
+{
+    //loop variable
+    int j = 0;
+
+    int left = 0;
+    int right = 0;
+
+    //the first pixel is its own neighbour on the left
+    left = src[0];
+    right = src[min(cols - 1, 1)];
+
+    diff[0] = (short)(right - left);
+    smooth[0] = (short)(side * (left + right) + center * src[0]);
+
+#ifdef EDGE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sideWeight = _mm_set1_epi16((short)side);
+    const __m128i centerWeight = _mm_set1_epi16((short)center);
+    __m128i l, m, r;
+
+    //16 pixels and their neighbours at a time, widened in two halves of 8, while the right neighbours stay inside the row
+    auto halves = [&](__m128i l16, __m128i m16, __m128i r16, int at)
+    {
+        _mm_storeu_si128((__m128i*)(diff + at), _mm_sub_epi16(r16, l16));
+        _mm_storeu_si128((__m128i*)(smooth + at),
+            _mm_add_epi16(_mm_mullo_epi16(_mm_add_epi16(l16, r16), sideWeight), _mm_mullo_epi16(m16, centerWeight)));
+    };
+
+    for (j = 1; j + 17 <= cols; j += 16)
+    {
+        l = _mm_loadu_si128((const __m128i*)(src + j - 1));
+        m = _mm_loadu_si128((const __m128i*)(src + j));
+        r = _mm_loadu_si128((const __m128i*)(src + j + 1));
+
+        halves(_mm_unpacklo_epi8(l, zero), _mm_unpacklo_epi8(m, zero), _mm_unpacklo_epi8(r, zero), j);
+        halves(_mm_unpackhi_epi8(l, zero), _mm_unpackhi_epi8(m, zero), _mm_unpackhi_epi8(r, zero), j + 8);
+    }
+#endif
+
+    //the rest of the row, the last pixel is its own neighbour on the right
+    for (j = max(j, 1); j < cols; j++)
+    {
+        left = src[j - 1];
+        right = src[min(cols - 1, j + 1)];
+
+        diff[j] = (short)(right - left);
+        smooth[j] = (short)(side * (left + right) + center * src[j]);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Combines the halves of the rows above, at, and below a row into its gradients and writes the
+  * result. The horizontal gradient gx is the differences of the three rows weighted side : center :
+  * side, and the vertical gradient gy is the smoothed row below minus the smoothed row above. For
+  * EDGE_MAGNITUDE the result is the length of the gradient, the square root of gx * gx + gy * gy,
+  * divided by the sum of the positive weights so that a step from black to white gives 255. For
+  * EDGE_X and EDGE_Y the signed gradient is divided by twice that, with a flat area at 128. With
+  * SSE2, 8 gradients are computed at once in 16 bits, squared and added into 32 bits with madd, and
+  * the square root is taken in single precision; the scalar code rounds the same way, so the result
+  * does not depend on SSE2.
+  *
+  * @param[in] above - the differences and smoothed values of the row above, diff first.
+  * @param[in] at - the same for the row itself.
+  * @param[in] below - the same for the row below.
+  * @param[in] cols - the number of pixels.
+  * @param[in] side - the weight of the rows above and below.
+  * @param[in] center - the weight of the row itself.
+  * @param[in] output - what to write, EDGE_MAGNITUDE, EDGE_X, or EDGE_Y.
+  * @param[out] out - the row of the result.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    edgeCombine(rows[0], rows[1], rows[2], img.cols, 1, 2, EDGE_MAGNITUDE, img.green[i]);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void edgeCombine(const short* above[2], const short* at[2], const short* below[2], int cols, int side, int center,
+    edgeOutput output, pixel* out)
+{
+    //loop variable
+    int j = 0;
+
+    int gx = 0;
+    int gy = 0;
+    int norm = 2 * side + center;
+    int shift = side == 1 ? 3 : 5;
+    float inverse = 1.0f / (float)norm;
+
+#ifdef EDGE_SSE2
+    const __m128i sideWeight = _mm_set1_epi16((short)side);
+    const __m128i centerWeight = _mm_set1_epi16((short)center);
+    const __m128i flat = _mm_set1_epi16(128);
+    const __m128i half = _mm_set1_epi16((short)(1 << (shift - 1)));
+    const __m128 scale = _mm_set1_ps(inverse);
+    __m128i x, y, lo, hi, result;
+
+    for (j = 0; j + 8 <= cols; j += 8)
+    {
+        x = _mm_add_epi16(_mm_mullo_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i*)(above[0] + j)),
+            _mm_loadu_si128((const __m128i*)(below[0] + j))), sideWeight),
+            _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)(at[0] + j)), centerWeight));
+        y = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(below[1] + j)), _mm_loadu_si128((const __m128i*)(above[1] + j)));
+
+        if (output == EDGE_MAGNITUDE)
+        {
+            lo = _mm_unpacklo_epi16(x, y);
+            hi = _mm_unpackhi_epi16(x, y);
+
+            lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(lo, lo))), scale));
+            hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(hi, hi))), scale));
+
+            result = _mm_packs_epi32(lo, hi);
+        }
+
+        else
+        {
+            result = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(output == EDGE_X ? x : y, half), shift), flat);
+        }
+
+        _mm_storel_epi64((__m128i*)(out + j), _mm_packus_epi16(result, result));
+    }
+#endif
+
+    for (; j < cols; j++)
+    {
+        gx = side * (above[0][j] + below[0][j]) + center * at[0][j];
+        gy = below[1][j] - above[1][j];
+
+        if (output == EDGE_MAGNITUDE)
+        {
+            out[j] = (pixel)min(255, (int)nearbyintf(sqrtf((float)(gx * gx + gy * gy)) * inverse));
+        }
+
+        else
+        {
+            out[j] = (pixel)max(0, min(255, (((output == EDGE_X ? gx : gy) + (1 << (shift - 1))) >> shift) + 128));
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Finds the edges of the image with the Sobel or Scharr kernel and replaces it with a grayscale
+  * image of the gradient magnitude, or of the horizontal or vertical gradient. A color image is
+  * converted to grayscale first. The rows are split across threads, and each strip slides a window
+  * of three rows down its part of the image: every source row is split into its two kernel halves
+  * once, by edgeRow, into a ring of three short rows, and edgeCombine makes each row of the result
+  * from the three rows of the ring. The result is written into the green channel while the gray
+  * channel is still read, so no full size temporary is needed, and is then copied into the other
+  * two channels. Pixels past the edges of the image repeat the edge pixels.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] scharr - true for the Scharr kernel, 3 10 3, false for Sobel, 1 2 1.
+  * @param[in] output - what to write, EDGE_MAGNITUDE, EDGE_X, or EDGE_Y.
+  * @param[in,out] grayOutput - true if the image is already grayscale, set to true.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --sobel --binary edges cats.ppm
+    detectEdges(img, false, EDGE_MAGNITUDE, grayOutput);
+
+    //edges.pgm is white where cats.ppm has sharp edges and black where it is flat
+
+    @endverbatim
+
+  ***********************************************************************/
+void detectEdges(image& img, bool scharr, edgeOutput output, bool& grayOutput)
+{
+    int side = scharr ? 3 : 1;
+    int center = scharr ? 10 : 2;
+
+    if (!grayOutput)
+    {
+        convertGrayScale(img);
+        grayOutput = true;
+    }
+
+    if (isBilevel(img))
+    {
+        img.magicNumber = "P5";
+    }
+
+    //gradients of the gray channel into the green channel
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i = 0;
+        int k = 0;
+
+        vector<short> ring(6 * (size_t)img.cols);
+        short* halves[3][2];
+        const short* window[3][2];
+
+        for (k = 0; k < 3; k++)
+        {
+            halves[k][0] = ring.data() + (size_t)(2 * k) * img.cols;
+            halves[k][1] = ring.data() + (size_t)(2 * k + 1) * img.cols;
+        }
+
+        //the row above the strip and its first row
+        edgeRow(img.redGray[max(0, rowStart - 1)], img.cols, side, center, halves[0][0], halves[0][1]);
+        edgeRow(img.redGray[rowStart], img.cols, side, center, halves[1][0], halves[1][1]);
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            //the row below slides into the ring
+            edgeRow(img.redGray[min(img.rows - 1, i + 1)], img.cols, side, center, halves[(i - rowStart + 2) % 3][0],
+                halves[(i - rowStart + 2) % 3][1]);
+
+            for (k = 0; k < 3; k++)
+            {
+                window[k][0] = halves[(i - rowStart + k) % 3][0];
+                window[k][1] = halves[(i - rowStart + k) % 3][1];
+            }
+
+            edgeCombine(window[0], window[1], window[2], img.cols, side, center, output, img.green[i]);
+        }
+    });
+
+    //the result into the other two channels
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i = 0;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            memcpy(img.redGray[i], img.green[i], img.cols);
+            memcpy(img.blue[i], img.green[i], img.cols);
+        }
+    });
+}
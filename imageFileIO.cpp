@@ -1,649 +1,2950 @@
-/** *********************************************************************
- * @file
- *
- * @brief   Handles input and outfiles for all the files passed to main
- ***********************************************************************/
-
-#include "netPBM.h"
-
- /** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This function receives an input file stream and opens it as a binary file. 
-  * Clears any error flags that have been set before opening the file.
-  * Returns true if the file opened successfully. 
-  * Returns false otherwise. 
-  *
-  * @param[in,out] fin - the input file stream.
-  * @param[in] filename - name of the file to be opened.
-  *
-  * @returns true if file opened successfully
-  * @returns false if file did not open
-  *
-  * @par Example:
-    @verbatim
-    
-    string filename = "cats.ppm";
-    ifstream fin; 
-
-    openInputFile (fin, filename);
-    
-    //returns true if "cats.ppm" exists and can be opened. 
-    //returns false otherwise.
-
-    @endverbatim
-
-  ***********************************************************************/
-bool openInputFile( ifstream &fin, string filename)
-{
-    //clearing any error flags that have been set
-    fin.clear();
-
-    //opening a binary file
-    fin.open(filename, ios::in | ios::binary);
-
-    if (fin.is_open())
-    {
-        return true;
-    }
-
-    else
-    {
-        return false;
-    }
-}
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * Reads the magic number of the file. The magic number is the first two bytes of the input file. 
-  * If the magic number is a P3, the function seeks to beginning of input file and calls the readFileP3 function. 
-  * If the magic number is a P6, the function seeks to beginning of input file and calls the readFileP6 function. 
-  *
-  * @param[in,out] bfin - the input file stream.
-  * @param[in,out] img - a structure of type image.
-  * @param[in,out] max_pix_val - maximum value that can be in a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ifstream fin;
-    image img;
-    int max_pix_val;
-
-    readMagicNum(fin, img, max_pix_val);
-
-    //reads the magic number
-    //calls readFileP3 or readFileP6 file accordingly
-
-    @endverbatim
-
-  ***********************************************************************/
-void readMagicNum(ifstream& bfin, image& img, int& max_pix_val)
-{
-    //clear any error flags and go to beginning of file
-    bfin.clear();
-    bfin.seekg(0, ios::beg);
-
-    //read magic number
-    bfin >> img.magicNumber;
-
-    //read P3 is thats magic num
-    if (img.magicNumber == "P3")
-    {        
-        bfin.seekg(0, ios::beg);        
-        readFileP3(bfin, img, max_pix_val);
-    }
-
-    //P6 otherwise
-    else if (img.magicNumber == "P6")
-    {        
-        bfin.seekg(0, ios::beg);
-        readFileP6(bfin, img, max_pix_val);
-    }
-
-    //invalid magic number
-    else
-    {
-        cout << "Invalid Magic Number" << endl;
-
-        //cleaning up files
-        bfin.clear();
-        bfin.close();
-
-        exit(0);
-    }
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This functions reads a file containing ascii image data. The rest of the data is also read as ascii.
-  * Reads in the magic number, comments, width, height, and the maximum pixel value from the input file.
-  * This data is then stored into the structure that has been passed by reference to this function. 
-  * The maximum pixel value is stored into the variable max_pix_val that has been passed by reference.
-  * Using the width and height, the function allocates 3 2D dynamic arrays using the alloc2D function.
-  * The function then proceeds to read in the image data into these dynamically allocated arrays. 
-  * The data is supplied for each row. Each column in every row has three values - the red, green, and 
-  * blue channel.
-  *
-  * @param[in,out] bfin - the input file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ifstream fin;
-    image img;
-    int max_pix_val;
-
-    
-    readFileP3(fin, img, max_pix_val);
-
-    //reads image data into the structure img.
-
-    @endverbatim
-
-  ***********************************************************************/
-void readFileP3(ifstream& bfin, image &img, int &max_pix_val)
-{
-    //loop variable
-    int i = 0;
-    int j = 0;
-
-    //variables to read line in
-    string line;
-
-    //variables for reading in image data
-    int r, g, b;
-
-    //reading in image header
-    bfin >> img.magicNumber;
-    bfin.ignore();
-    
-    //getting the comment
-    while (getline(bfin, line, '\n') && line[0] == '#') 
-    {
-        img.comment += line + "\n";
-    }
-
-    
-        
-    //getting the width and height
-    img.cols = stoi(line.substr(0, line.find(' ')));
-    img.rows = stoi(line.substr(line.find(' ')));
-
-    //maximum pixel value    
-    bfin >> max_pix_val;
-    
-    //dynamically allocating 3 2D arrays
-    img.redGray = alloc2D(img.rows, img.cols);
-    img.green = alloc2D(img.rows, img.cols);
-    img.blue = alloc2D(img.rows, img.cols);
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //read in image data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            bfin >> r >> g >> b;
-
-            //assign these values to the array
-            img.redGray[i][j] = (pixel)r;
-            img.green[i][j] = (pixel)g;
-            img.blue[i][j] = (pixel)b;
-        }
-
-
-    }
-
-    
-
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This functions reads a file containing binary image data. The rest of the data is read in as ascii.
-  * Reads in the magic number, comments, width, height, and the maximum pixel value from the input file.
-  * This data is then stored into the structure that has been passed by reference to this function. 
-  * The maximum pixel value is stored into the variable max_pix_val that has been passed by reference.
-  * Using the width and height, the function allocates 3 2D dynamic arrays using the alloc2D function.
-  * The function then proceeds to read in the image data into these dynamically allocated arrays. 
-  * Since the image data is in binary, it uses the .read() function to read in the data into the arrays.
-  * The data is supplied for each row. Each column in every row has three values - the red, green, and 
-  * blue channel.
-  *
-  * @param[in,out] bfin - the input file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ifstream fin;
-    image img;
-    int max_pix_val;
-
-    readFileP6(fin, img, max_pix_val);
-
-    //reads image data in binary and stores it into the structure img.
-    @endverbatim
-
-  ***********************************************************************/
-void readFileP6(ifstream& bfin, image& img, int& max_pix_val)
-{
-    //loop variable
-    int i = 0;
-    int j = 0;
-
-    //variables to read line in
-    string line;   
-
-    //reading in image header
-    bfin >> img.magicNumber;
-    bfin.ignore();
-
-    //getting the comment
-    while (getline(bfin, line, '\n') && line[0] == '#') {
-        img.comment += line + "\n";
-    }
-
-    //getting values for rows and columns
-    img.cols = stoi(line.substr(0, line.find(' ')));
-    img.rows = stoi(line.substr(line.find(' ')));
-
-    //maximum pixel value    
-    bfin >> max_pix_val;
-    bfin.ignore();
-
-    //dynamically allocating 3 2D arrays
-    img.redGray = alloc2D(img.rows, img.cols);
-    img.green = alloc2D(img.rows, img.cols);
-    img.blue = alloc2D(img.rows, img.cols);
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //read in image data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-
-            bfin.read((char*)&img.redGray[i][j], sizeof(pixel));
-            bfin.read((char*)&img.green[i][j], sizeof(pixel));
-            bfin.read((char*)&img.blue[i][j], sizeof(pixel));
-
-        }
-
-
-    }
-
-
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This functions outputs the image data to a binary file in ascii. The name of the output file
-  * is given by "basename.ppm". Outputs the magic number, comment, width, height, and the maximum 
-  * pixel value from the input file. The function then proceeds to output the image data onto the output file.
-  * The image data is outputted in ascii format. ofstream fout is used to output the all the data to the file.
-  * The order of the data for the output file is the same as that for the input file. The data is supplied for 
-  * each row. Each column in every row has three values - the red, green, and blue channel. The pixel values stored
-  * in the red, green, and blue channels are typecasted to integers. 
-  *
-  * @param[in,out] fout - the input file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in] basename - name of the output file.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ofstream fout;
-    image img;
-    string basename;
-    int max_pix_val;
-
-    basename = "dogs.ppm";
-
-    outputP3(fout, img, basename, max_pix_val);
-
-    //outputs the data in img to a file called "dogs.ppm"
-    //data output format is in ascii
-
-    @endverbatim
-
-  ***********************************************************************/
-void outputP3 (ofstream &fout, image img, string basename, int max_pix_val)
-{ 
-    int i = 0;
-    int j = 0;
-
-    //opening the output file
-    fout.clear();
-    fout.open(basename + ".ppm", ios::out);
-
-    //output to P3
-    fout << "P3" << "\n";
-    
-    //output the comment/s
-    fout << img.comment;
-
-    //output width and height 
-    fout << img.cols << " " << img.rows << "\n";
-
-    //output maximum pixel value
-    fout << max_pix_val << "\n";
-
-    //outputing image data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            
-            fout << (int) img.redGray[i][j] << endl;
-            fout << (int) img.green[i][j] << endl;
-            fout << (int) img.blue[i][j] << endl;
-            
-        }
-    }
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This functions outputs the image data to a binary file in binary format. The rest of the data is still 
-  * ascii. Outputs the magic number, comment, width, height, and the maximum pixel value to the output file.
-  * This data is still in ascii and outputted using ofstream fout to the output file.
-  * The function then proceeds to output the image data onto the output file specified by basename.
-  * The output file is named "basename.ppm". Since the image data is to be outputted
-  * in binary format, the .write() function is used to output the data to the file. The order of the data in the
-  * output file is the same as that in the input file. The image data is supplied for each row. Each column in every 
-  * row has three values - the red, green, and blue channel. 
-  *
-  * @param[in,out] fout - the input file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in] basename - name of the output file.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ifstream fout;
-    image img;
-    string basename;
-    int max_pix_val;
-
-    basename = "dogs.ppm";
-
-    outputP6(fout, img, basename, max_pix_val);
-
-    //outputs data to a file called "dogs.ppm"
-    //All the data upto the maximum pixel value is in ascii
-    //Following that, the image data is stored in binary
-
-    @endverbatim
-
-  ***********************************************************************/
-void outputP6(ofstream& fout, image img, string basename, int max_pix_val)
-{
-    int i = 0;
-    int j = 0;
-
-    //opening the output file
-    fout.clear();
-    fout.open(basename + ".ppm", ios::out | ios::trunc | ios::binary);
-
-    //output to P3
-    fout << "P6" << "\n";
-
-    //output the comment
-    fout << img.comment;
-
-    //output width and height
-    fout << img.cols << " " << img.rows << "\n";
-
-    //output maximum pixel value
-    fout << max_pix_val << "\n";
-
-    //outputing image data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            
-            //write the three channels to binary file
-            fout.write((char*)&img.redGray[i][j], sizeof(pixel));
-            fout.write((char*)&img.green[i][j], sizeof(pixel));
-            fout.write((char*)&img.blue[i][j], sizeof(pixel));
-        }
-    }
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * The function outputs image data in an ascii format to the output file. The output file type is a .pgm which 
-  * represents a grayscale image file. This function only outputs the data in img.redGray channel.  
-  * It first outputs the magic number P2 to the top of the output file. Then outputs the comments, width, and 
-  * height stored in the structure that is passed to the function. Then it outputs the maximum value that can be 
-  * stored in a pixel - the max_pix_val. Then it outputs all the image data in an ascii format to the file 
-  * by typecasting the pixel values stored in img.redGray to integers. 
-  *
-  * @param[in,out] fout - the output file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in] basename - name of the output file.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ofstream fout;
-    image img;
-    string basename;
-    int max_pix_val;
-
-    basename = "dogs.ppm";
-
-    outputGrayP2(fout, img, basename, max_pix_val);
-
-    //outputs the data in ascii format to a file "dogs.ppm"
-    //all the data is outputted in ascii
-
-    @endverbatim
-
-  ***********************************************************************/
-void outputGrayP2(ofstream& fout, image img, string basename, int max_pix_val)
-{
-    int i = 0;
-    int j = 0;
-
-    //opening the output file
-    fout.clear();
-    fout.open(basename + ".pgm", ios::out);
-
-    //output to P2
-    fout << "P2" << "\n";
-
-    //output comment
-    fout << img.comment;
-
-    //output width and height
-    fout << img.cols << " " << img.rows << "\n";
-
-    //output maximum pixel value
-    fout << max_pix_val << "\n";
-
-    //outputting image data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            fout << (int) img.redGray[i][j] << endl;
-        }
-    }
-}
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * The function outputs image data in an binary format to the output file. The output file type is a .pgm which 
-  * represents a grayscale image file. This function only outputs the data in the img.redGray channel.  
-  * It first outputs the magic number P5 to the top of the output file. The magic number P5 specifies that it 
-  * is a grayscale image file with binary image data. The function then outputs the comments, width, and 
-  * height stored in the structure that is passed to the function. Then it outputs the maximum value that can be 
-  * stored in a pixel - the max_pix_val. Then it outputs all the image data in a binary format to the file 
-  * by using the .write() function.  
-  *
-  * @param[in,out] fout - the input file stream.
-  * @param[in,out] img - a strucutre of type image.
-  * @param[in] basename - name of the output file.
-  * @param[in,out] max_pix_val - maximum value of a pixel.
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    ofstream fout;
-    image img;
-    string basename;
-    int max_pix_val;
-
-    basename = "dogs.ppm";
-
-    outputGrayP5(fout, img, basename, max_pix_val);
-
-    //outputs the data till max_pix_val in ascii to a file called "dogs.ppm"
-    //the image data is then outputted in binary
-
-    @endverbatim
-
-  ***********************************************************************/
-void outputGrayP5(ofstream& fout, image img, string basename, int max_pix_val)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //opening the output file
-    fout.clear();
-    fout.open(basename + ".pgm", ios::out | ios::trunc | ios::binary);
-
-    //output to P3
-    fout << "P5" << "\n";
-
-    //output comment
-    fout << img.comment;
-
-    //output width and height
-    fout << img.cols << " " << img.rows << "\n";
-
-    //output maximum pixel value
-    fout << max_pix_val << "\n";
-
-    //loop to output grayscale data
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            fout.write((char*)&img.redGray[i][j], sizeof(pixel));
-        }
-    }
-}
-
-
-
-/** ***************************************************************************
- * @author Jonathan Mascarenhas
- *
- * @par Description
- * The function outputs a usage statement if there are incorrect number of command line arguments
- * or an incorrect option or output type that may have been entered by the user at the command line 
- * terminal.
- *
- * @param none
- *
- * @returns none
- *
- * @par Example
- * @verbatim
-   c:\> thpExam1.exe [option] --outputtype basename image.ppm
-   d:\> c:\bin\thpExam1.exe [option] --outputtype basename image.ppm
-
-         Output Type 
-             --ascii                integer text numbers will be written for the data
-             --binary               integer numbers will be written in binary form
-
-         Option Code                Option Description
-             --flipX                Flip the image on the X axis
-             --flipY                Flip the image on the Y axis
-             --rotateCW             Rotate the image clockwise
-             --rotateCCW            Rotate the image counterclockwise
-             --grayscale            Convert the image to grayscale
-             --sepia                Antique a color image
-   @endverbatim
- *****************************************************************************/
-void outputUsage()
-{
-    cout << "Usage: " << endl;
-    
-    cout << "c:\\> thpExam1.exe [option] --outputtype basename image.ppm" << endl;
-    cout << "d:\\> c:\\bin\\thpExam1.exe [option] --outputtype basename image.ppm" << endl;
-    cout << "\n";
-
-    
-    cout << "Option Code" << setw(25) << "Option Description" << endl;
-    cout << "--flipX" << setw(39) << "Flip the image on the X axis" << endl;
-    cout << "--flipY" << setw(39) << "Flip the image on the Y axis" << endl;
-    cout << "--rotateCW" << setw(34) << "Rotate the image clockwise" << endl;
-    cout << "--rotateCCW" << setw(40) << "Rotate the image counterclockwise" << endl;
-    cout << "--grayscale" << setw(37) << "Convert the image to grayscale" << endl;
-    cout << "--sepia" << setw(32) << "Antique a color image" << endl;
-    cout << "\n";
-
-    cout << "Output Type" << endl;
-    cout << "--ascii" << setw(60) << "integer text numbers will be written for the data" << endl;
-    cout << "--binary" << setw(56) << "integer numbers will be written in binary form" << endl;
+/** *********************************************************************
+ * @file
+ *
+ * @brief   Handles input and outfiles for all the files passed to main
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of bytes of binary image data packed before each write.
+ */
+const size_t WRITE_BAND = 1 << 20;
+
+/**
+ * @brief Binary image data smaller than this is written by one thread.
+ */
+const size_t PARALLEL_WRITE_MIN = 4 << 20;
+
+/**
+ * @brief The extensions of the files the writers open.
+ */
+static const char* const OUTPUT_EXTENSIONS[5] = { ".ppm", ".pgm", ".pbm", ".qoi", ".pam" };
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This function receives an input file stream and opens it as a binary file. 
+  * Clears any error flags that have been set before opening the file.
+  * A file compressed with gzip is decompressed as it is read.
+  * Returns true if the file opened successfully. 
+  * Returns false otherwise. 
+  *
+  * @param[in,out] fin - the input file stream.
+  * @param[in] filename - name of the file to be opened.
+  *
+  * @returns true if file opened successfully
+  * @returns false if file did not open
+  *
+  * @par Example:
+    @verbatim
+    
+    string filename = "cats.ppm";
+    ifstream fin; 
+
+    openInputFile (fin, filename);
+    
+    //returns true if "cats.ppm" exists and can be opened. 
+    //returns false otherwise.
+
+    @endverbatim
+
+  ***********************************************************************/
+bool openInputFile( ifstream &fin, string filename)
+{
+    //clearing any error flags that have been set
+    fin.clear();
+
+    //reading from the file itself again if the last file was compressed
+    detachGzip(fin, fin.rdbuf());
+
+    //opening a binary file
+    fin.open(filename, ios::in | ios::binary);
+
+    if (fin.is_open())
+    {
+        //a gzip file is decompressed as it is read
+        attachGzipInput(fin);
+
+        return true;
+    }
+
+    else
+    {
+        return false;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the slot of a stream that holds the extension of the file it was last opened on, as
+  * one more than its place in OUTPUT_EXTENSIONS, or 0 if it has not been opened by openOutputFile.
+  *
+  * @returns the slot
+  *
+  * @par Example:
+    @verbatim
+
+    long kind = fout.iword(extensionSlot());
+
+    @endverbatim
+
+  ***********************************************************************/
+static int extensionSlot()
+{
+    static int slot = ios_base::xalloc();
+
+    return slot;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the name of the output file for basename with the given extension. If basename ends
+  * in .gz, the extension goes before the .gz.
+  *
+  * @param[in] basename - the name of the file without its extension, optionally ending in .gz.
+  * @param[in] extension - the extension of the image type, .ppm, .pgm, .pbm, .qoi, or .pam.
+  *
+  * @returns the name of the file
+  *
+  * @par Example:
+    @verbatim
+
+    outputFileName("dogs.gz", ".ppm");
+
+    //returns "dogs.ppm.gz"
+
+    @endverbatim
+
+  ***********************************************************************/
+string outputFileName(string basename, string extension)
+{
+    if (basename.size() > 3 && basename.compare(basename.size() - 3, 3, ".gz") == 0)
+    {
+        return basename.substr(0, basename.size() - 3) + extension + ".gz";
+    }
+
+    return basename + extension;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the extension of the file a stream was last opened on by openOutputFile, which tells
+  * which kind of image the writer picked. Returns an empty string if the stream has not been opened.
+  *
+  * @param[in] stream - the output file stream.
+  *
+  * @returns the extension, such as .pgm
+  *
+  * @par Example:
+    @verbatim
+
+    outputImage(fout, img, "--binary", "dogs", max_pix_val, true, ORIENT_NONE);
+
+    outputExtension(fout);
+
+    //returns ".pgm"
+
+    @endverbatim
+
+  ***********************************************************************/
+string outputExtension(ios& stream)
+{
+    long kind = stream.iword(extensionSlot());
+
+    return kind > 0 && kind <= 5 ? OUTPUT_EXTENSIONS[kind - 1] : "";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Opens the output file for basename with the given extension, named by outputFileName. If
+  * basename ends in .gz, the file is compressed with gzip as it is written, so everything written
+  * to fout ends up compressed. Binary files are opened in binary mode, and compressed files always
+  * are. If setChecksum is on for fout, the CRC-32C of the file is computed as it is written, and the
+  * file is opened in binary mode too, so the checksum is of the bytes in the file. The extension is
+  * kept with the stream for outputExtension.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] basename - the name of the file without its extension, optionally ending in .gz.
+  * @param[in] extension - the extension of the image type, .ppm, .pgm, .pbm, .qoi, or .pam.
+  * @param[in] binary - true if the image type is binary.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    openOutputFile(fout, "dogs.gz", ".ppm", true);
+
+    //dogs.ppm.gz is opened and compressed as it is written
+
+    @endverbatim
+
+  ***********************************************************************/
+void openOutputFile(ofstream& fout, string basename, string extension, bool binary)
+{
+    //loop variable
+    int k = 0;
+
+    bool compressed = basename.size() > 3 && basename.compare(basename.size() - 3, 3, ".gz") == 0;
+
+    //clearing any error flags that have been set
+    fout.clear();
+
+    //writing to the file itself again if the last file was compressed
+    detachGzip(fout, fout.rdbuf());
+
+    fout.iword(extensionSlot()) = 0;
+
+    for (k = 0; k < 5; k++)
+    {
+        if (extension == OUTPUT_EXTENSIONS[k])
+        {
+            fout.iword(extensionSlot()) = k + 1;
+        }
+    }
+
+    if (compressed || binary || checksumRequested(fout))
+    {
+        fout.open(outputFileName(basename, extension), ios::out | ios::trunc | ios::binary);
+    }
+
+    else
+    {
+        fout.open(outputFileName(basename, extension), ios::out);
+    }
+
+    //the checksum goes next to the file, under the compression
+    attachChecksumOutput(fout, outputFileName(basename, extension));
+
+    if (compressed)
+    {
+        attachGzipOutput(fout);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Closes an output file opened by openOutputFile. A compressed file first has the rest of its
+  * data compressed and written, and then the checksum file is written if there is one.
+  *
+  * @param[in,out] fout - the output file stream.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    closeOutputFile(fout);
+
+    //dogs.ppm.gz is complete
+
+    @endverbatim
+
+  ***********************************************************************/
+void closeOutputFile(ofstream& fout)
+{
+    finishGzipOutput(fout);
+    finishChecksumOutput(fout);
+
+    fout.clear();
+    fout.close();
+}
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the magic number of the file. The magic number is the first two bytes of the input file.
+  * If the magic number is a P3, the function seeks to beginning of input file and calls the readFileP3 function.
+  * If the magic number is a P6, the function seeks to beginning of input file and calls the readFileP6 function.
+  * The grayscale magic numbers P2 and P5 are handled the same way by readFileP2 and readFileP5.
+  * PAM files, with the magic number P7, are read by readFilePam.
+  * The reduce factor is passed on to the reader, which then shrinks the image while it is decoded,
+  * and so is the orientation, which the reader applies while it stores the rows.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a structure of type image.
+  * @param[in,out] max_pix_val - maximum value that can be in a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readMagicNum(fin, img, max_pix_val);
+
+    //reads the magic number
+    //calls readFileP3 or readFileP6 file accordingly
+
+    @endverbatim
+
+  ***********************************************************************/
+void readMagicNum(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //clear any error flags and go to beginning of file
+    bfin.clear();
+    bfin.seekg(0, ios::beg);
+
+    //read magic number
+    bfin >> img.magicNumber;
+
+    //read P3 is thats magic num
+    if (img.magicNumber == "P3")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP3(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //P6
+    else if (img.magicNumber == "P6")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP6(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //grayscale ascii
+    else if (img.magicNumber == "P2")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP2(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //grayscale binary
+    else if (img.magicNumber == "P5")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP5(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //black and white ascii
+    else if (img.magicNumber == "P1")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP1(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //black and white binary
+    else if (img.magicNumber == "P4")
+    {
+        bfin.seekg(0, ios::beg);
+        readFileP4(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //lossless compressed
+    else if (img.magicNumber.compare(0, 4, "qoif") == 0)
+    {
+        readFileQoi(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //PAM, with or without alpha
+    else if (img.magicNumber == "P7")
+    {
+        readFilePam(bfin, img, max_pix_val, reduce, orient);
+    }
+
+    //invalid magic number
+    else
+    {
+        cout << "Invalid Magic Number" << endl;
+
+        //cleaning up files
+        bfin.clear();
+        bfin.close();
+
+        exit(0);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the header of a netPBM file. The header is the magic number followed by the width,
+  * height, and maximum pixel value, separated by whitespace. Comments start with a # and run to
+  * the end of the line. They may appear anywhere in the header and are saved in img.comment so
+  * that they are printed to the output file. The single whitespace character after the maximum
+  * pixel value is also read, so the stream is left at the first byte of the image data. The black and
+  * white formats P1 and P4 have no maximum pixel value, and their pixels are read as 0 and 255.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readHeader(fin, img, max_pix_val);
+
+    //img.magicNumber, img.comment, img.cols, and img.rows are filled in
+    //fin is at the start of the image data
+
+    @endverbatim
+
+  ***********************************************************************/
+void readHeader(ifstream& bfin, image& img, int& max_pix_val)
+{
+    //loop variable
+    int i = 0;
+
+    //variables to read line in
+    string line;
+
+    //the three numbers after the magic number, two for black and white
+    int values[3] = { 0, 0, 255 };
+    int count = 3;
+
+    //reading in the magic number
+    bfin >> img.magicNumber;
+
+    if (isBilevel(img))
+    {
+        count = 2;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        //skip whitespace and save any comments
+        while (isspace(bfin.peek()) || bfin.peek() == '#')
+        {
+            if (bfin.peek() == '#')
+            {
+                getline(bfin, line, '\n');
+                img.comment += line + "\n";
+            }
+
+            else
+            {
+                bfin.get();
+            }
+        }
+
+        bfin >> values[i];
+    }
+
+    //a single whitespace character comes before the image data
+    bfin.get();
+
+    //if the header is broken
+    if (!bfin || values[0] <= 0 || values[1] <= 0 || values[2] <= 0)
+    {
+        cout << "Invalid Image Header" << endl;
+        exit(0);
+    }
+
+    img.cols = values[0];
+    img.rows = values[1];
+    max_pix_val = values[2];
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the number of rows or columns left after shrinking size by reduce, rounded up. The sum is
+  * done in 64 bits, so a reduce as large as INT_MAX does not overflow.
+  *
+  * @param[in] size - the number of rows or columns of the file.
+  * @param[in] reduce - the factor that the image is shrunk by.
+  *
+  * @returns the reduced size
+  *
+  * @par Example:
+    @verbatim
+
+    int cols = reducedSize(771, 4);
+
+    //cols is 193
+
+    @endverbatim
+
+  ***********************************************************************/
+static int reducedSize(int size, int reduce)
+{
+    return (int)(((long long)size + reduce - 1) / reduce);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Allocates the three 2D arrays of the image. When reduce is greater than one, only the
+  * reduced size of the image is allocated, which is the full size divided by reduce and
+  * rounded up. When the orientation transposes the image, the arrays are allocated with the
+  * rows and columns swapped. The rows and columns of the structure are left at the full size
+  * of the file.
+  *
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] reduce - the factor that the image is shrunk by while it is read.
+  * @param[in] orient - the orientation the image is stored in.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //a file of dimensions 210 x 771 read at a quarter of its size
+    img.rows = 210;
+    img.cols = 771;
+
+    allocImage(img, 4, ORIENT_NONE);
+
+    //img.redGray, img.green, and img.blue are 2D arrays of 53 x 193
+
+    @endverbatim
+
+  ***********************************************************************/
+static void allocImage(image& img, int reduce, int orient)
+{
+    int rows = reducedSize(img.rows, reduce);
+    int cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(rows, cols);
+    }
+
+    //dynamically allocating 3 2D arrays
+    img.redGray = alloc2D(rows, cols);
+    img.green = alloc2D(rows, cols);
+    img.blue = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the view that the rows of the file are stored through. The arrays allocated by allocImage
+  * hold the image in its final orientation, and the view undoes that orientation, so row i and column j
+  * of the view is where row i and column j of the reduced file belong. Storing the file through the view
+  * applies the orientation while it is read, without a second pass over the image.
+  *
+  * @param[in] img - a strucutre of type image, with the full size of the file.
+  * @param[in] reduce - the factor that the image is shrunk by.
+  * @param[in] orient - the orientation the image is stored in.
+  *
+  * @returns a view with the reduced size of the file
+  *
+  * @par Example:
+    @verbatim
+
+    //reading a file of dimensions 210 x 771 rotated clockwise
+    allocImage(img, 1, ORIENT_TRANSPOSE | ORIENT_FLIP_Y);
+
+    imageView dst = decodeView(img, 1, ORIENT_TRANSPOSE | ORIENT_FLIP_Y);
+
+    //dst is 210 x 771, and row 0 of dst is the last column of the arrays
+
+    @endverbatim
+
+  ***********************************************************************/
+static imageView decodeView(image& img, int reduce, int orient)
+{
+    imageView v;
+
+    v.red = img.redGray[0];
+    v.green = img.green[0];
+    v.blue = img.blue[0];
+    v.rows = reducedSize(img.rows, reduce);
+    v.cols = reducedSize(img.cols, reduce);
+
+    //the arrays as they were allocated
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(v.rows, v.cols);
+    }
+
+    v.rowStride = v.cols;
+    v.colStride = 1;
+
+    return orientView(v, inverseOrientation(orient));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Stores one decoded row of the file into the image through the view dst, which places it in the
+  * orientation the image is stored in. The row holds channels values for every
+  * column, three for color images and one for grayscale images. A grayscale value is stored in
+  * all three channels. When reduce is one the values are copied straight into row i of the view.
+  * Otherwise they are added into sums, which holds a running total for every channel of every
+  * reduced column. Once the last row of a block of reduce rows has been added, the totals are
+  * divided by the number of pixels in each block and stored as a single row of the reduced image,
+  * and sums is cleared for the next block. The totals are 64 bits, so a block of any size fits. Blocks on the right and bottom edges may be smaller.
+  *
+  * @param[in] img - a strucutre of type image, with the full size of the file.
+  * @param[in] dst - the view returned by decodeView.
+  * @param[in] row - the decoded values of row i of the file.
+  * @param[in] channels - the number of values per column, 3 or 1.
+  * @param[in] i - the index of the row in the file.
+  * @param[in] reduce - the factor that the image is shrunk by.
+  * @param[in,out] sums - running totals of the current block of rows.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<pixel> row(img.cols * 3);
+    vector<unsigned long long> sums;
+
+    for (i = 0; i < img.rows; i++)
+    {
+        bfin.read((char*)row.data(), row.size());
+        storeRow(img, dst, row, 3, i, 2, sums);
+    }
+
+    //img holds the image at half its size
+
+    @endverbatim
+
+  ***********************************************************************/
+static void storeRow(const image& img, const imageView& dst, const vector<pixel>& row, int channels, int i, int reduce,
+    vector<unsigned long long>& sums)
+{
+    //loop variables
+    int j = 0;
+    int c = 0;
+
+    int cols = reducedSize(img.cols, reduce);
+    int blockRows = 0;
+    int blockCols = 0;
+    long long count = 0;
+    int r = i / reduce;
+    ptrdiff_t step = dst.colStride;
+
+    pixel* planes[3] = { nullptr, nullptr, nullptr };
+
+    //full size, just copy the values
+    if (reduce == 1)
+    {
+        planes[0] = dst.red + i * dst.rowStride;
+        planes[1] = dst.green + i * dst.rowStride;
+        planes[2] = dst.blue + i * dst.rowStride;
+
+        if (channels == 3)
+        {
+            for (j = 0; j < img.cols; j++)
+            {
+                planes[0][j * step] = row[3 * j];
+                planes[1][j * step] = row[3 * j + 1];
+                planes[2][j * step] = row[3 * j + 2];
+            }
+        }
+
+        else if (step == 1)
+        {
+            memcpy(planes[0], row.data(), img.cols);
+            memcpy(planes[1], row.data(), img.cols);
+            memcpy(planes[2], row.data(), img.cols);
+        }
+
+        else
+        {
+            for (j = 0; j < img.cols; j++)
+            {
+                planes[0][j * step] = row[j];
+                planes[1][j * step] = row[j];
+                planes[2][j * step] = row[j];
+            }
+        }
+
+        return;
+    }
+
+    //add the row into the totals of its block
+    if (sums.size() != (size_t)cols * channels)
+    {
+        sums.assign((size_t)cols * channels, 0);
+    }
+
+    for (j = 0; j < img.cols; j++)
+    {
+        for (c = 0; c < channels; c++)
+        {
+            sums[(j / reduce) * channels + c] += row[j * channels + c];
+        }
+    }
+
+    //not the last row of the block yet
+    if (i % reduce != reduce - 1 && i != img.rows - 1)
+    {
+        return;
+    }
+
+    //store the averages of the block
+    blockRows = i - r * reduce + 1;
+
+    planes[0] = dst.red + r * dst.rowStride;
+    planes[1] = dst.green + r * dst.rowStride;
+    planes[2] = dst.blue + r * dst.rowStride;
+
+    for (j = 0; j < cols; j++)
+    {
+        blockCols = min(reduce, img.cols - j * reduce);
+        count = (long long)blockRows * blockCols;
+
+        for (c = 0; c < 3; c++)
+        {
+            planes[c][j * step] = (pixel)((sums[j * channels + c % channels] + count / 2) / count);
+        }
+    }
+
+    fill(sums.begin(), sums.end(), 0);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the ascii image data of a P3 or P2 file. The text is parsed in parallel by streamAsciiSamples,
+  * which splits each batch of text into strips at whitespace and parses the strips on separate threads.
+  * The values are gathered into rows, and each complete row is handed to storeRow, which stores it into
+  * the image or averages it into the reduced image, in the orientation given. If the file ends early,
+  * the missing values are 0. Once every row has been read, the rows and columns of the
+  * structure are set to the reduced and oriented size.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the image data.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] channels - the number of values per column, 3 or 1.
+  * @param[in] reduce - the factor that the image is shrunk by.
+  * @param[in] orient - the orientation the image is stored in.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readHeader(fin, img, max_pix_val);
+    allocImage(img, reduce, ORIENT_NONE);
+
+    readAsciiData(fin, img, 3, reduce, ORIENT_NONE);
+
+    //img holds the image data
+
+    @endverbatim
+
+  ***********************************************************************/
+static void readAsciiData(ifstream& bfin, image& img, int channels, int reduce, int orient)
+{
+    //loop variable
+    int i = 0;
+
+    size_t filled = 0;
+    size_t take = 0;
+
+    vector<pixel> row((size_t)img.cols * channels);
+    vector<unsigned long long> sums;
+    imageView dst = decodeView(img, reduce, orient);
+
+    //the values come in batches, each row is stored once it is complete
+    streamAsciiSamples(bfin, (unsigned long long)img.rows * img.cols * channels, [&](const pixel* samples, size_t count)
+    {
+        while (count > 0)
+        {
+            take = min(count, row.size() - filled);
+            memcpy(row.data() + filled, samples, take);
+
+            filled += take;
+            samples += take;
+            count -= take;
+
+            if (filled == row.size())
+            {
+                storeRow(img, dst, row, channels, i, reduce, sums);
+                filled = 0;
+                i++;
+            }
+        }
+    });
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the binary image data of a P6 or P5 file one row at a time. Each row is read with a
+  * single .read() call into a buffer and handed to storeRow, which stores it into the image or
+  * averages it into the reduced image. A reduced read therefore only needs memory for the
+  * reduced image and one row of the file. The rows are stored in the orientation given, so a flip
+  * or rotation costs nothing more than the read. If the file is truncated, the rest of the image is
+  * 0. Once every row has been read, the rows and columns of the structure are set to the reduced and
+  * oriented size.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the image data.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] channels - the number of values per column, 3 or 1.
+  * @param[in] reduce - the factor that the image is shrunk by.
+  * @param[in] orient - the orientation the image is stored in.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readHeader(fin, img, max_pix_val);
+    allocImage(img, reduce, ORIENT_NONE);
+
+    readBinaryData(fin, img, 3, reduce, ORIENT_NONE);
+
+    //img holds the image data
+
+    @endverbatim
+
+  ***********************************************************************/
+static void readBinaryData(ifstream& bfin, image& img, int channels, int reduce, int orient)
+{
+    //loop variable
+    int i = 0;
+
+    vector<pixel> row((size_t)img.cols * channels);
+    vector<unsigned long long> sums;
+    imageView dst = decodeView(img, reduce, orient);
+
+    //read in image data
+    for (i = 0; i < img.rows; i++)
+    {
+        bfin.read((char*)row.data(), row.size());
+
+        //the bytes missing from a truncated file are 0
+        fill(row.begin() + bfin.gcount(), row.end(), (pixel)0);
+
+        storeRow(img, dst, row, channels, i, reduce, sums);
+    }
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions reads a file containing ascii image data. The rest of the data is also read as ascii.
+  * Reads in the magic number, comments, width, height, and the maximum pixel value from the input file.
+  * This data is then stored into the structure that has been passed by reference to this function.
+  * The maximum pixel value is stored into the variable max_pix_val that has been passed by reference.
+  * Using the width and height, the function allocates 3 2D dynamic arrays using the alloc2D function.
+  * The function then proceeds to read in the image data into these dynamically allocated arrays.
+  * The data is supplied for each row. Each column in every row has three values - the red, green, and
+  * blue channel. If reduce is greater than one, each reduce x reduce block of pixels is averaged
+  * while it is read and only the reduced image is allocated.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+
+    readFileP3(fin, img, max_pix_val);
+
+    //reads image data into the structure img.
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP3(ifstream& bfin, image &img, int &max_pix_val, int reduce, int orient)
+{
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    //dynamically allocating 3 2D arrays
+    allocImage(img, reduce, orient);
+
+    //read in image data
+    readAsciiData(bfin, img, 3, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions reads a file containing binary image data. The rest of the data is read in as ascii.
+  * Reads in the magic number, comments, width, height, and the maximum pixel value from the input file.
+  * This data is then stored into the structure that has been passed by reference to this function.
+  * The maximum pixel value is stored into the variable max_pix_val that has been passed by reference.
+  * Using the width and height, the function allocates 3 2D dynamic arrays using the alloc2D function.
+  * The function then proceeds to read in the image data into these dynamically allocated arrays.
+  * Since the image data is in binary, it uses the .read() function to read in the data a row at a time.
+  * The data is supplied for each row. Each column in every row has three values - the red, green, and
+  * blue channel. If reduce is greater than one, each reduce x reduce block of pixels is averaged
+  * while it is read and only the reduced image is allocated, so a preview costs one pass over the
+  * file and a fraction of the memory.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileP6(fin, img, max_pix_val, 4);
+
+    //reads image data in binary and stores it into the structure img
+    //at a quarter of its width and height
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP6(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    //dynamically allocating 3 2D arrays
+    allocImage(img, reduce, orient);
+
+    //read in image data
+    readBinaryData(bfin, img, 3, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions reads a grayscale file containing ascii image data. The header is read the same
+  * way as for a P3 file. Each column in every row has a single gray value, which is stored in all
+  * three channels of the image so that every image operation works on it. If reduce is greater than
+  * one, each reduce x reduce block of pixels is averaged while it is read.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileP2(fin, img, max_pix_val);
+
+    //reads grayscale image data into the structure img.
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP2(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    //dynamically allocating 3 2D arrays
+    allocImage(img, reduce, orient);
+
+    //read in image data
+    readAsciiData(bfin, img, 1, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions reads a grayscale file containing binary image data. The header is read the same
+  * way as for a P6 file. Each column in every row has a single gray value, which is stored in all
+  * three channels of the image so that every image operation works on it. If reduce is greater than
+  * one, each reduce x reduce block of pixels is averaged while it is read.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileP5(fin, img, max_pix_val, 8);
+
+    //reads grayscale image data in binary at an eighth of its width and height
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP5(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    //dynamically allocating 3 2D arrays
+    allocImage(img, reduce, orient);
+
+    //read in image data
+    readBinaryData(bfin, img, 1, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the rows of a black and white file with streamBilevelRows and hands each one to storeRow as
+  * grayscale pixels, 0 for black and 255 for white, so a P1 or P4 file can be reduced and flipped or
+  * rotated while it is read like any other file. The image keeps its magic number, so it is written
+  * black and white again.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the file.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - set to 255.
+  * @param[in] ascii - true for P1, false for P4.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readBilevel(fin, img, max_pix_val, false, 1, ORIENT_NONE);
+
+    //reads a P4 file into the structure img
+
+    @endverbatim
+
+  ***********************************************************************/
+static void readBilevel(ifstream& bfin, image& img, int& max_pix_val, bool ascii, int reduce, int orient)
+{
+    //loop variable
+    int i = 0;
+
+    vector<pixel> row;
+    vector<unsigned long long> sums;
+    imageView dst;
+
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    //dynamically allocating 3 2D arrays
+    allocImage(img, reduce, orient);
+
+    row.resize(img.cols);
+    dst = decodeView(img, reduce, orient);
+
+    streamBilevelRows(bfin, img, ascii, [&](const pixel* rows, int n)
+    {
+        int r = 0;
+
+        for (r = 0; r < n; r++)
+        {
+            memcpy(row.data(), rows + (size_t)r * img.cols, img.cols);
+            storeRow(img, dst, row, 1, i, reduce, sums);
+            i++;
+        }
+    });
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads a black and white file with ascii image data, the digits 1 for black and 0 for white.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - set to 255.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileP1(fin, img, max_pix_val);
+
+    //every pixel of img is 0 or 255
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP1(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    readBilevel(bfin, img, max_pix_val, true, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads a black and white file with binary image data, 8 pixels to a byte with 1 bits for black.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - set to 255.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileP4(fin, img, max_pix_val, 4);
+
+    //reads a scan at a quarter of its width and height, in shades of gray
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileP4(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    readBilevel(bfin, img, max_pix_val, false, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Allocates the alpha channel of an image that is being read, at the reduced and oriented size of the
+  * arrays allocImage made, and returns the view that storeRow stores the alpha values through, so the
+  * alpha channel is reduced and flipped or rotated along with the colors. If memory allocation fails,
+  * a message is outputted and the program exits.
+  *
+  * @param[in,out] img - a strucutre of type image, with the full size of the file.
+  * @param[in] reduce - the factor that the image is shrunk by while it is read.
+  * @param[in] orient - the orientation the image is stored in.
+  *
+  * @returns the view of img.alpha to store the rows of the file through
+  *
+  * @par Example:
+    @verbatim
+
+    allocImage(img, reduce, orient);
+    alphaDst = allocAlpha(img, reduce, orient);
+
+    //img.alpha has the size of img.redGray
+
+    @endverbatim
+
+  ***********************************************************************/
+static imageView allocAlpha(image& img, int reduce, int orient)
+{
+    int rows = reducedSize(img.rows, reduce);
+    int cols = reducedSize(img.cols, reduce);
+
+    image alphaImage;
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(rows, cols);
+    }
+
+    img.alpha = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if (img.alpha == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //the alpha array through a view of its own
+    alphaImage = img;
+    alphaImage.redGray = alphaImage.green = alphaImage.blue = img.alpha;
+
+    return decodeView(alphaImage, reduce, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads a QOI file, the lossless compressed format written by outputQoi. The header gives the width and
+  * height, and the image is read as a color image with a maximum pixel value of 255. The chunks are
+  * decoded a batch at a time by streamQoiSamples, the pixels are gathered into rows, and each complete
+  * row is handed to storeRow, so a QOI file can be reduced and flipped or rotated while it is read just
+  * like a P6 file. When the header says the file has 4 channels, the alpha values are stored in img.alpha
+  * as for a PAM file. If the file ends early, the missing values are 0.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFileQoi(fin, img, max_pix_val);
+
+    //reads the compressed image data into the structure img
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFileQoi(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    size_t filled = 0;
+    size_t take = 0;
+    bool alpha = false;
+    int channels = 3;
+
+    vector<pixel> raw;
+    vector<pixel> row;
+    vector<pixel> alphaRow;
+    vector<unsigned long long> sums;
+    vector<unsigned long long> alphaSums;
+    imageView dst;
+    imageView alphaDst;
+
+    //reading in image header
+    if (!readQoiHeader(bfin, img, max_pix_val, &alpha))
+    {
+        cout << "Invalid Magic Number" << endl;
+        exit(0);
+    }
+
+    //dynamically allocating 3 2D arrays, and one for alpha
+    allocImage(img, reduce, orient);
+    dst = decodeView(img, reduce, orient);
+
+    if (alpha)
+    {
+        alphaDst = allocAlpha(img, reduce, orient);
+        channels = 4;
+    }
+
+    raw.resize((size_t)img.cols * channels);
+    row.resize((size_t)img.cols * 3);
+    alphaRow.resize(img.cols);
+
+    //the pixels come in batches, each row is stored once it is complete
+    streamQoiSamples(bfin, (unsigned long long)img.rows * img.cols, [&](const pixel* samples, size_t count)
+    {
+        while (count > 0)
+        {
+            take = min(count, raw.size() - filled);
+            memcpy(raw.data() + filled, samples, take);
+
+            filled += take;
+            samples += take;
+            count -= take;
+
+            if (filled < raw.size())
+            {
+                continue;
+            }
+
+            //the colors and the alpha values apart
+            if (alpha)
+            {
+                for (j = 0; j < img.cols; j++)
+                {
+                    memcpy(row.data() + (size_t)j * 3, raw.data() + (size_t)j * 4, 3);
+                    alphaRow[j] = raw[(size_t)j * 4 + 3];
+                }
+
+                storeRow(img, alphaDst, alphaRow, 1, i, reduce, alphaSums);
+            }
+
+            storeRow(img, dst, alpha ? row : raw, 3, i, reduce, sums);
+            filled = 0;
+            i++;
+        }
+    }, channels);
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads a PAM file, the magic number P7, with readPamHeader for the header. Each row of the file is read
+  * with a single .read() call and split into its colors and, if the file has one, its alpha channel. The
+  * colors are handed to storeRow as for a P6 or P5 file, and the alpha values are handed to storeRow
+  * through a view of img.alpha, so the alpha channel is reduced and flipped or rotated along with the
+  * colors. Black and white values of 0 and 1 are read as 0 and 255, and alpha values are scaled to 0 to
+  * 255 whatever the maximum value of the file. If the header is not valid, a message is outputted and
+  * the program exits.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] reduce - the image is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the image is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+
+    readFilePam(fin, img, max_pix_val);
+
+    //reads the colors into the structure img and the opacity into img.alpha
+
+    @endverbatim
+
+  ***********************************************************************/
+void readFilePam(ifstream& bfin, image& img, int& max_pix_val, int reduce, int orient)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+    int c = 0;
+    int k = 0;
+
+    int depth = 0;
+    int channels = 0;
+    int maxval = 0;
+    bool alpha = false;
+    bool bilevel = false;
+
+    vector<pixel> raw;
+    vector<pixel> row;
+    vector<pixel> alphaRow;
+    vector<unsigned long long> sums;
+    vector<unsigned long long> alphaSums;
+    pixel scale[256];
+    pixel opacity[256];
+    imageView dst;
+    imageView alphaDst;
+
+    //reading in image header
+    if (!readPamHeader(bfin, img, max_pix_val, depth, alpha, bilevel))
+    {
+        cout << "Invalid Image Header" << endl;
+        exit(0);
+    }
+
+    channels = depth - alpha;
+    maxval = bilevel ? 1 : max_pix_val;
+
+    //black and white as 0 and 255, alpha on a scale of 0 to 255
+    for (k = 0; k < 256; k++)
+    {
+        scale[k] = bilevel ? (k ? 255 : 0) : (pixel)k;
+        opacity[k] = (pixel)min(255, (k * 255 + maxval / 2) / maxval);
+    }
+
+    //dynamically allocating 3 2D arrays, and one for alpha
+    allocImage(img, reduce, orient);
+    dst = decodeView(img, reduce, orient);
+
+    //the alpha array has the size of the others
+    if (alpha)
+    {
+        alphaDst = allocAlpha(img, reduce, orient);
+    }
+
+    raw.resize((size_t)img.cols * depth);
+    row.resize((size_t)img.cols * channels);
+    alphaRow.resize(img.cols);
+
+    //read in image data
+    for (i = 0; i < img.rows; i++)
+    {
+        bfin.read((char*)raw.data(), raw.size());
+
+        //the bytes missing from a truncated file are 0
+        fill(raw.begin() + bfin.gcount(), raw.end(), (pixel)0);
+
+        for (j = 0; j < img.cols; j++)
+        {
+            for (c = 0; c < channels; c++)
+            {
+                row[(size_t)j * channels + c] = scale[raw[(size_t)j * depth + c]];
+            }
+
+            if (alpha)
+            {
+                alphaRow[j] = opacity[raw[(size_t)j * depth + channels]];
+            }
+        }
+
+        storeRow(img, dst, row, channels, i, reduce, sums);
+
+        if (alpha)
+        {
+            storeRow(img, alphaDst, alphaRow, 1, i, reduce, alphaSums);
+        }
+    }
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads only the region of w x h pixels whose top left corner is column x and row y. Every row of a
+  * P6 or P5 file has the same number of bytes, so the position of any pixel can be computed from the
+  * end of the header. For each row of the region the function seeks straight to the first byte of the
+  * region in that row and reads just the bytes of the region, so the time taken depends on the size of
+  * the region and not on the size of the file. The rows are stored with storeRow, so the region can also
+  * be shrunk by reduce while it is read. The ascii formats P3, P2, and P1, the packed P4 format, compressed
+  * QOI files, and PAM files are read whole and then cropped, along with the alpha channel of a PAM file. If the region does not fit inside the image, a message is
+  * outputted and the program exits.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] region - the region as x, y, w, and h.
+  * @param[in] reduce - the region is shrunk by this factor while it is read, 1 to keep the full size.
+  * @param[in] orient - the orientation the region is stored in, ORIENT_NONE to keep it as it is.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    image img;
+    int max_pix_val;
+    int region[4] = { 5000, 8000, 1000, 1000 };
+
+    readRegion(fin, img, max_pix_val, region, 1);
+
+    //img holds the 1000 x 1000 region at column 5000 and row 8000 of the file
+
+    @endverbatim
+
+  ***********************************************************************/
+void readRegion(ifstream& bfin, image& img, int& max_pix_val, const int region[4], int reduce, int orient)
+{
+    //loop variable
+    int i = 0;
+
+    int channels = 0;
+    int x = region[0];
+    int y = region[1];
+    int w = region[2];
+    int h = region[3];
+
+    //position of the first byte of image data
+    streamoff dataStart = 0;
+    streamoff rowBytes = 0;
+
+    vector<pixel> row;
+    vector<unsigned long long> sums;
+    imageView dst;
+
+    //clear any error flags and go to beginning of file
+    bfin.clear();
+    bfin.seekg(0, ios::beg);
+
+    bfin >> img.magicNumber;
+    bfin.seekg(0, ios::beg);
+
+    //no fixed row size, read everything and crop
+    if (img.magicNumber == "P3" || img.magicNumber == "P2" || isBilevel(img) || img.magicNumber.compare(0, 4, "qoif") == 0 ||
+        img.magicNumber == "P7")
+    {
+        auto shape = [&](image& target)
+        {
+            cropImage(target, x, y, w, h);
+            downscaleBox(target, reduce);
+
+            if (orient != ORIENT_NONE)
+            {
+                viewToImage(target, orientView(makeView(target), orient));
+            }
+        };
+
+        readMagicNum(bfin, img, max_pix_val);
+
+        //the alpha channel of a PAM file is cut out along with the colors
+        applyToAlpha(img, shape);
+        shape(img);
+
+        return;
+    }
+
+    if (img.magicNumber != "P6" && img.magicNumber != "P5")
+    {
+        cout << "Invalid Magic Number" << endl;
+
+        //cleaning up files
+        bfin.clear();
+        bfin.close();
+
+        exit(0);
+    }
+
+    channels = img.magicNumber == "P6" ? 3 : 1;
+
+    //reading in image header
+    readHeader(bfin, img, max_pix_val);
+
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > img.cols || y + h > img.rows)
+    {
+        cout << "Region Outside Of Image" << endl;
+        exit(0);
+    }
+
+    dataStart = bfin.tellg();
+    rowBytes = (streamoff)img.cols * channels;
+
+    //only the region is allocated
+    img.rows = h;
+    img.cols = w;
+    allocImage(img, reduce, orient);
+    dst = decodeView(img, reduce, orient);
+
+    row.resize((size_t)w * channels);
+
+    //seek to and read the bytes of the region in each row
+    for (i = 0; i < h; i++)
+    {
+        bfin.seekg(dataStart + (streamoff)(y + i) * rowBytes + (streamoff)x * channels, ios::beg);
+        bfin.read((char*)row.data(), row.size());
+
+        //the bytes missing from a truncated file are 0
+        fill(row.begin() + bfin.gcount(), row.end(), (pixel)0);
+
+        storeRow(img, dst, row, channels, i, reduce, sums);
+    }
+
+    //changing the values of rows and columns
+    img.rows = reducedSize(img.rows, reduce);
+    img.cols = reducedSize(img.cols, reduce);
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        swap(img.rows, img.cols);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads only the header of a netPBM file and checks it, without reading or allocating the image.
+  * At most PROBE_BYTES bytes are read from the start of the file and the header is parsed from them.
+  * The magic number, comments, width, height, and maximum pixel value are stored in header, along
+  * with the offset of the image data. The bilevel formats P1 and P4 have no maximum pixel value. For
+  * the binary formats P4, P5, and P6 the size the file must have is computed from the header, and the
+  * file is reported as invalid if it is shorter. QOI files are also recognized, with the magic number
+  * qoif, their width and height, and a maximum pixel value of 255; their size cannot be checked since
+  * the data is compressed. PAM files, with the magic number P7, are read with readPamHeader and their
+  * size is checked from the width, height, and depth. A gzip file is probed through the gzip buffer,
+  * which only decompresses the first bytes; its size is taken from the file itself, and is not checked,
+  * since only decompressing all of it would tell. Returns false and sets header.error if the file cannot
+  * be opened or is not a valid netPBM, PAM, or QOI file.
+  *
+  * @param[in] filename - name of the file to probe.
+  * @param[out] header - the information from the header.
+  *
+  * @returns true if the header is valid
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    imageHeader header;
+
+    probeHeader("cats.ppm", header);
+
+    //header.magicNumber is "P6", header.cols and header.rows are the dimensions
+
+    @endverbatim
+
+  ***********************************************************************/
+bool probeHeader(string filename, imageHeader& header)
+{
+    //loop variable
+    int i = 0;
+
+    ifstream fin;
+    char buffer[PROBE_BYTES];
+    streamsize length = 0;
+    streamsize pos = 0;
+    streamsize start = 0;
+    long long value = 0;
+    long long rowBytes = 0;
+    int fields = 3;
+    int values[3] = { 0, 0, 0 };
+
+    //the header of a PAM file
+    image img;
+    int depth = 0;
+    bool alpha = false;
+    bool bilevel = false;
+
+    header = imageHeader();
+
+    if (!openInputFile(fin, filename))
+    {
+        header.error = "unable to open file";
+        return false;
+    }
+
+    //size of the file, from the file buffer itself so a gzip file is not decompressed
+    header.compressed = static_cast<ios&>(fin).rdbuf() != fin.rdbuf();
+    header.fileSize = (long long)fin.rdbuf()->pubseekoff(0, ios::end, ios::in);
+    fin.rdbuf()->pubseekpos(0, ios::in);
+
+    fin.read(buffer, PROBE_BYTES);
+    length = fin.gcount();
+
+    //QOI files have a fixed header of big endian numbers
+    if (length >= 14 && memcmp(buffer, "qoif", 4) == 0)
+    {
+        header.magicNumber = "qoif";
+        header.cols = (int)((unsigned char)buffer[4] << 24 | (unsigned char)buffer[5] << 16 | (unsigned char)buffer[6] << 8 | (unsigned char)buffer[7]);
+        header.rows = (int)((unsigned char)buffer[8] << 24 | (unsigned char)buffer[9] << 16 | (unsigned char)buffer[10] << 8 | (unsigned char)buffer[11]);
+        header.maxValue = 255;
+        header.dataOffset = 14;
+
+        if (header.cols <= 0 || header.rows <= 0)
+        {
+            header.error = "invalid header";
+            return false;
+        }
+
+        header.valid = true;
+        return true;
+    }
+
+    //PAM files have a header of keywords and values
+    if (length >= 2 && memcmp(buffer, "P7", 2) == 0)
+    {
+        if (!readPamHeader(fin, img, header.maxValue, depth, alpha, bilevel))
+        {
+            header.error = "invalid header";
+            return false;
+        }
+
+        header.magicNumber = "P7";
+        header.comment = img.comment;
+        header.cols = img.cols;
+        header.rows = img.rows;
+        header.maxValue = bilevel ? 1 : header.maxValue;
+        header.dataOffset = (long long)fin.tellg();
+        header.expectedSize = header.dataOffset + (long long)header.cols * depth * header.rows;
+
+        if (!header.compressed && header.fileSize < header.expectedSize)
+        {
+            header.error = "file is truncated";
+            return false;
+        }
+
+        header.valid = true;
+        return true;
+    }
+
+    //magic number
+    if (length < 2 || buffer[0] != 'P' || buffer[1] < '1' || buffer[1] > '6')
+    {
+        header.error = "invalid magic number";
+        return false;
+    }
+
+    header.magicNumber = string(buffer, 2);
+    pos = 2;
+
+    //bilevel images have no maximum pixel value
+    if (buffer[1] == '1' || buffer[1] == '4')
+    {
+        fields = 2;
+        values[2] = 1;
+    }
+
+    for (i = 0; i < fields; i++)
+    {
+        //skip whitespace and save any comments
+        while (pos < length && (isspace((unsigned char)buffer[pos]) || buffer[pos] == '#'))
+        {
+            if (buffer[pos] == '#')
+            {
+                start = pos;
+
+                while (pos < length && buffer[pos] != '\n')
+                {
+                    pos++;
+                }
+
+                header.comment += string(buffer + start, (size_t)(pos - start)) + "\n";
+            }
+
+            pos++;
+        }
+
+        //read the number
+        value = 0;
+        start = pos;
+
+        while (pos < length && isdigit((unsigned char)buffer[pos]) && value <= INT_MAX)
+        {
+            value = value * 10 + (buffer[pos] - '0');
+            pos++;
+        }
+
+        if (pos == start || value <= 0 || value > INT_MAX)
+        {
+            header.error = pos >= length ? "header too long" : "invalid header";
+            return false;
+        }
+
+        values[i] = (int)value;
+    }
+
+    //a single whitespace character comes before the image data
+    if (pos >= length || !isspace((unsigned char)buffer[pos]))
+    {
+        header.error = "invalid header";
+        return false;
+    }
+
+    header.cols = values[0];
+    header.rows = values[1];
+    header.maxValue = values[2];
+    header.dataOffset = pos + 1;
+
+    //binary files must be long enough to hold every pixel
+    if (buffer[1] >= '4')
+    {
+        if (buffer[1] == '4')
+        {
+            rowBytes = (header.cols + 7) / 8;
+        }
+
+        else
+        {
+            rowBytes = (long long)header.cols * (buffer[1] == '6' ? 3 : 1) * (header.maxValue > 255 ? 2 : 1);
+        }
+
+        header.expectedSize = header.dataOffset + rowBytes * header.rows;
+
+        if (!header.compressed && header.fileSize < header.expectedSize)
+        {
+            header.error = "file is truncated";
+            return false;
+        }
+    }
+
+    header.valid = true;
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes text as a JSON string, with the quotes around it. Quotes, backslashes, and control
+  * characters such as the newlines between comments are escaped.
+  *
+  * @param[in,out] out - the stream to write to.
+  * @param[in] text - the text to write.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputJsonString(cout, "# made by \"gimp\"\n");
+
+    //prints "# made by \"gimp\"\n" with the escapes
+
+    @endverbatim
+
+  ***********************************************************************/
+static void outputJsonString(ostream& out, const string& text)
+{
+    //loop variable
+    size_t i = 0;
+
+    const char* hex = "0123456789abcdef";
+    unsigned char c = 0;
+
+    out << '"';
+
+    for (i = 0; i < text.size(); i++)
+    {
+        c = (unsigned char)text[i];
+
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << (char)c;
+        }
+
+        else if (c == '\n')
+        {
+            out << "\\n";
+        }
+
+        else if (c == '\r')
+        {
+            out << "\\r";
+        }
+
+        else if (c == '\t')
+        {
+            out << "\\t";
+        }
+
+        else if (c < 0x20 || c >= 0x80)
+        {
+            out << "\\u00" << hex[c >> 4] << hex[c & 15];
+        }
+
+        else
+        {
+            out << (char)c;
+        }
+    }
+
+    out << '"';
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Prints the result of probeHeader as a single line of JSON, so that the output for many files
+  * can be read one line at a time. Valid files list the magic number, dimensions, maximum pixel
+  * value, comments, offset of the image data, and the file size. Invalid files list the error.
+  *
+  * @param[in] filename - name of the file that was probed.
+  * @param[in] header - the information from the header.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    probeHeader("cats.ppm", header);
+    outputProbeJson("cats.ppm", header);
+
+    //{"file":"cats.ppm","valid":true,"magic":"P6","width":771,"height":210,...}
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputProbeJson(string filename, const imageHeader& header)
+{
+    cout << "{\"file\":";
+    outputJsonString(cout, filename);
+    cout << ",\"valid\":" << (header.valid ? "true" : "false");
+
+    if (!header.valid)
+    {
+        cout << ",\"error\":";
+        outputJsonString(cout, header.error);
+    }
+
+    if (!header.magicNumber.empty())
+    {
+        cout << ",\"magic\":\"" << header.magicNumber << "\"";
+    }
+
+    if (header.cols > 0)
+    {
+        cout << ",\"width\":" << header.cols << ",\"height\":" << header.rows << ",\"maxval\":" << header.maxValue;
+        cout << ",\"comment\":";
+        outputJsonString(cout, header.comment);
+        cout << ",\"dataOffset\":" << header.dataOffset;
+    }
+
+    cout << ",\"fileSize\":" << header.fileSize;
+
+    if (header.compressed)
+    {
+        cout << ",\"compressed\":true";
+    }
+
+    if (header.expectedSize > 0)
+    {
+        cout << ",\"expectedSize\":" << header.expectedSize;
+    }
+
+    cout << "}\n";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions outputs the image data to a binary file in ascii. The name of the output file
+  * is given by "basename.ppm". Outputs the magic number, comment, width, height, and the maximum 
+  * pixel value from the input file. The function then proceeds to output the image data onto the output file.
+  * The image data is outputted in ascii format. ofstream fout is used to output the all the data to the file.
+  * The order of the data for the output file is the same as that for the input file. The data is supplied for 
+  * each row. Each column in every row has three values - the red, green, and blue channel. The pixel values stored
+  * in the red, green, and blue channels are typecasted to integers. 
+  *
+  * @param[in,out] fout - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ofstream fout;
+    image img;
+    string basename;
+    int max_pix_val;
+
+    basename = "dogs.ppm";
+
+    outputP3(fout, img, basename, max_pix_val);
+
+    //outputs the data in img to a file called "dogs.ppm"
+    //data output format is in ascii
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputP3 (ofstream &fout, image img, string basename, int max_pix_val, int orient)
+{ 
+    int i = 0;
+    int j = 0;
+    ptrdiff_t k = 0;
+
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".ppm", false);
+
+    //output to P3
+    fout << "P3" << "\n";
+    
+    //output the comment/s
+    fout << img.comment;
+
+    //output width and height 
+    fout << v.cols << " " << v.rows << "\n";
+
+    //output maximum pixel value
+    fout << max_pix_val << "\n";
+
+    //outputing image data
+    for (i = 0; i < v.rows; i++)
+    {
+        for (j = 0; j < v.cols; j++)
+        {
+            k = i * v.rowStride + j * v.colStride;
+
+            fout << (int) v.red[k] << endl;
+            fout << (int) v.green[k] << endl;
+            fout << (int) v.blue[k] << endl;
+            
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Packs the rows first to last - 1 of a view into band, in the order they are written to a binary
+  * file: one byte per pixel for grayscale, or red, green, and blue for each pixel for color. If alpha is
+  * given, the alpha value of each pixel follows its colors, as in a PAM file.
+  *
+  * @param[in] v - the pixels in the order they are written.
+  * @param[in] channels - 1 for grayscale, 3 for color.
+  * @param[in] first - the first row to pack.
+  * @param[in] last - one past the last row to pack.
+  * @param[out] band - the packed bytes.
+  * @param[in] alpha - the first pixel of a view of the alpha channel with the strides of v, or nullptr.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    packRows(makeView(img), 3, 0, 2, band);
+
+    //band holds the first two rows of img, 6 * img.cols bytes
+
+    @endverbatim
+
+  ***********************************************************************/
+static void packRows(const imageView& v, int channels, int first, int last, vector<pixel>& band, const pixel* alpha = nullptr)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    ptrdiff_t k = 0;
+    pixel* out = nullptr;
+
+    band.resize((size_t)(last - first) * v.cols * (channels + (alpha != nullptr)));
+    out = band.data();
+
+    for (i = first; i < last; i++)
+    {
+        for (j = 0; j < v.cols; j++)
+        {
+            k = i * v.rowStride + j * v.colStride;
+
+            *out++ = v.red[k];
+
+            if (channels == 3)
+            {
+                *out++ = v.green[k];
+                *out++ = v.blue[k];
+            }
+
+            if (alpha != nullptr)
+            {
+                *out++ = alpha[k];
+            }
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes the pixels of a binary file after its header. The size of the file is known once the header
+  * is written, so for large images the file is first extended to its full size and each thread then
+  * opens the file on its own, packs its strip of rows a band of WRITE_BAND bytes at a time, and writes
+  * each band straight to its position. The threads never write to the same bytes, so packing and
+  * writing scale with the number of threads. Images smaller than PARALLEL_WRITE_MIN bytes, or any image
+  * when a thread cannot open the file, are packed and written a band at a time through fout.
+  *
+  * @param[in,out] fout - the output file stream, open and just past the header.
+  * @param[in] v - the pixels in the order they are written.
+  * @param[in] channels - 1 for grayscale, 3 for color.
+  * @param[in] filename - the name of the output file, as outputFileName gives it to openOutputFile.
+  * @param[in] alpha - the first pixel of a view of the alpha channel with the strides of v, or nullptr.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fout << "P6\n" << img.comment << img.cols << " " << img.rows << "\n" << max_pix_val << "\n";
+
+    writeBinaryRaster(fout, makeView(img), 3, "dogs.ppm");
+
+    //the pixels of img follow the header in dogs.ppm
+
+    @endverbatim
+
+  ***********************************************************************/
+static void writeBinaryRaster(ofstream& fout, const imageView& v, int channels, string filename, const pixel* alpha = nullptr)
+{
+    //loop variable
+    int i = 0;
+
+    size_t rowBytes = (size_t)v.cols * (channels + (alpha != nullptr));
+    size_t total = rowBytes * v.rows;
+    int bandRows = (int)max<size_t>(1, WRITE_BAND / max<size_t>(1, rowBytes));
+    streamoff headerSize = fout.tellp();
+    vector<pixel> band;
+
+    //set by any thread that cannot write its strip
+    atomic<bool> failed(false);
+
+    if (total >= PARALLEL_WRITE_MIN && threadCount() > 1 && headerSize >= 0)
+    {
+        //extending the file to its full size
+        fout.seekp(headerSize + (streamoff)total - 1);
+        fout.put(0);
+        fout.flush();
+
+        parallelFor(0, v.rows, [&](int rowStart, int rowEnd)
+        {
+            int r = 0;
+            fstream part(filename, ios::in | ios::out | ios::binary);
+            vector<pixel> strip;
+
+            if (!part)
+            {
+                failed = true;
+                return;
+            }
+
+            for (r = rowStart; r < rowEnd; r += bandRows)
+            {
+                packRows(v, channels, r, min(r + bandRows, rowEnd), strip, alpha);
+
+                part.seekp(headerSize + (streamoff)r * rowBytes);
+                part.write((char*)strip.data(), strip.size());
+            }
+
+            if (!part.flush())
+            {
+                failed = true;
+            }
+        });
+
+        if (!failed)
+        {
+            return;
+        }
+
+        fout.seekp(headerSize);
+    }
+
+    //one band at a time through fout
+    for (i = 0; i < v.rows; i += bandRows)
+    {
+        packRows(v, channels, i, min(i + bandRows, v.rows), band, alpha);
+        fout.write((char*)band.data(), band.size());
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This functions outputs the image data to a binary file in binary format. The rest of the data is still 
+  * ascii. Outputs the magic number, comment, width, height, and the maximum pixel value to the output file.
+  * This data is still in ascii and outputted using ofstream fout to the output file.
+  * The function then proceeds to output the image data onto the output file specified by basename.
+  * The output file is named "basename.ppm". Since the image data is to be outputted
+  * in binary format, the .write() function is used to output the data to the file. The order of the data in the
+  * output file is the same as that in the input file. The image data is supplied for each row. Each column in every 
+  * row has three values - the red, green, and blue channel. The rows are written by writeBinaryRaster,
+  * from all threads at once for large images.
+  *
+  * @param[in,out] fout - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fout;
+    image img;
+    string basename;
+    int max_pix_val;
+
+    basename = "dogs.ppm";
+
+    outputP6(fout, img, basename, max_pix_val);
+
+    //outputs data to a file called "dogs.ppm"
+    //All the data upto the maximum pixel value is in ascii
+    //Following that, the image data is stored in binary
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputP6(ofstream& fout, image img, string basename, int max_pix_val, int orient)
+{
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".ppm", true);
+
+    //output to P3
+    fout << "P6" << "\n";
+
+    //output the comment
+    fout << img.comment;
+
+    //output width and height
+    fout << v.cols << " " << v.rows << "\n";
+
+    //output maximum pixel value
+    fout << max_pix_val << "\n";
+
+    //outputing image data, red, green, and blue for each pixel
+    writeBinaryRaster(fout, v, 3, outputFileName(basename, ".ppm"));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * The function outputs image data in an ascii format to the output file. The output file type is a .pgm which 
+  * represents a grayscale image file. This function only outputs the data in img.redGray channel.  
+  * It first outputs the magic number P2 to the top of the output file. Then outputs the comments, width, and 
+  * height stored in the structure that is passed to the function. Then it outputs the maximum value that can be 
+  * stored in a pixel - the max_pix_val. Then it outputs all the image data in an ascii format to the file 
+  * by typecasting the pixel values stored in img.redGray to integers. 
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ofstream fout;
+    image img;
+    string basename;
+    int max_pix_val;
+
+    basename = "dogs.ppm";
+
+    outputGrayP2(fout, img, basename, max_pix_val);
+
+    //outputs the data in ascii format to a file "dogs.ppm"
+    //all the data is outputted in ascii
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputGrayP2(ofstream& fout, image img, string basename, int max_pix_val, int orient)
+{
+    int i = 0;
+    int j = 0;
+
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".pgm", false);
+
+    //output to P2
+    fout << "P2" << "\n";
+
+    //output comment
+    fout << img.comment;
+
+    //output width and height
+    fout << v.cols << " " << v.rows << "\n";
+
+    //output maximum pixel value
+    fout << max_pix_val << "\n";
+
+    //outputting image data
+    for (i = 0; i < v.rows; i++)
+    {
+        for (j = 0; j < v.cols; j++)
+        {
+            fout << (int) v.red[i * v.rowStride + j * v.colStride] << endl;
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * The function outputs image data in an binary format to the output file. The output file type is a .pgm which 
+  * represents a grayscale image file. This function only outputs the data in the img.redGray channel.  
+  * It first outputs the magic number P5 to the top of the output file. The magic number P5 specifies that it 
+  * is a grayscale image file with binary image data. The function then outputs the comments, width, and 
+  * height stored in the structure that is passed to the function. Then it outputs the maximum value that can be 
+  * stored in a pixel - the max_pix_val. Then it outputs all the image data in a binary format to the file 
+  * with writeBinaryRaster, which writes the rows of large images from all threads at once.  
+  *
+  * @param[in,out] fout - the input file stream.
+  * @param[in,out] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in,out] max_pix_val - maximum value of a pixel.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ofstream fout;
+    image img;
+    string basename;
+    int max_pix_val;
+
+    basename = "dogs.ppm";
+
+    outputGrayP5(fout, img, basename, max_pix_val);
+
+    //outputs the data till max_pix_val in ascii to a file called "dogs.ppm"
+    //the image data is then outputted in binary
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputGrayP5(ofstream& fout, image img, string basename, int max_pix_val, int orient)
+{
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".pgm", true);
+
+    //output to P3
+    fout << "P5" << "\n";
+
+    //output comment
+    fout << img.comment;
+
+    //output width and height
+    fout << v.cols << " " << v.rows << "\n";
+
+    //output maximum pixel value
+    fout << max_pix_val << "\n";
+
+    //outputing grayscale data
+    writeBinaryRaster(fout, v, 1, outputFileName(basename, ".pgm"));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs a black and white image to "basename.pbm". The rows are packed a band of WRITE_BAND pixels
+  * at a time and written by writeBilevelRows, with any value below 128 black.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in] ascii - true for P1, false for P4.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputBilevel(fout, img, "scan", false, ORIENT_NONE);
+
+    //outputs img to "scan.pbm" with 8 pixels to a byte
+
+    @endverbatim
+
+  ***********************************************************************/
+static void outputBilevel(ofstream& fout, image& img, string basename, bool ascii, int orient)
+{
+    //loop variable
+    int i = 0;
+
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+    int bandRows = (int)max<size_t>(1, WRITE_BAND / v.cols);
+    int last = 0;
+
+    vector<pixel> band;
+
+    openOutputFile(fout, basename, ".pbm", !ascii);
+
+    fout << (ascii ? "P1" : "P4") << "\n";
+    fout << img.comment;
+    fout << v.cols << " " << v.rows << "\n";
+
+    for (i = 0; i < v.rows; i += bandRows)
+    {
+        last = min(v.rows, i + bandRows);
+
+        packRows(v, 1, i, last, band);
+        writeBilevelRows(fout, band.data(), v.cols, last - i, ascii);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs a black and white image to "basename.pbm" with ascii image data, a digit per pixel.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputP1(fout, img, "scan");
+
+    //outputs the digits 1 for black and 0 for white to a file called "scan.pbm"
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputP1(ofstream& fout, image& img, string basename, int orient)
+{
+    outputBilevel(fout, img, basename, true, orient);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs a black and white image to "basename.pbm" with binary image data, 8 pixels to a byte, which
+  * is 24 times smaller than the same image in P6.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputP4(fout, img, "scan");
+
+    //outputs the packed bits to a file called "scan.pbm"
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputP4(ofstream& fout, image& img, string basename, int orient)
+{
+    outputBilevel(fout, img, basename, false, orient);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs the image to "basename.qoi" in the lossless compressed QOI format, which is usually two to four
+  * times smaller than a P6 file and fast to encode and decode. QOI files always hold red, green, and blue
+  * values from 0 to 255, so grayscale images are written with the gray value in all three channels, and
+  * images with a different maximum pixel value are scaled to 255. The rows are packed a band of WRITE_BAND
+  * bytes at a time and encoded with qoiEncode, and the chunks are written whenever a band's worth has
+  * built up, so only one band of the output is kept in memory.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in] max_pix_val - maximum value of a pixel.
+  * @param[in] grayOutput - true if the image is grayscale.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputQoi(fout, img, "dogs", 255, false);
+
+    //outputs the compressed image to a file called "dogs.qoi"
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputQoi(ofstream& fout, image img, string basename, int max_pix_val, bool grayOutput, int orient)
+{
+    //loop variables
+    int i = 0;
+    size_t k = 0;
+
+    int channels = grayOutput ? 1 : 3;
+    int bandRows = 0;
+    size_t count = 0;
+
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+
+    qoiState state;
+    vector<pixel> band;
+    vector<pixel> rgb;
+    vector<unsigned char> out;
+    pixel scale[256];
+
+    //values on a scale of 0 to 255
+    for (k = 0; k < 256; k++)
+    {
+        scale[k] = max_pix_val == 255 || max_pix_val <= 0 ? (pixel)k : (pixel)min<size_t>(255, (k * 255 + max_pix_val / 2) / max_pix_val);
+    }
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".qoi", true);
+
+    writeQoiHeader(fout, v.cols, v.rows);
+
+    qoiReset(state);
+    bandRows = (int)max<size_t>(1, WRITE_BAND / max<size_t>(1, (size_t)v.cols * 3));
+
+    for (i = 0; i < v.rows; i += bandRows)
+    {
+        packRows(v, channels, i, min(i + bandRows, v.rows), band);
+
+        count = band.size() / channels;
+        rgb.resize(count * 3);
+
+        for (k = 0; k < band.size(); k++)
+        {
+            if (channels == 1)
+            {
+                rgb[3 * k] = rgb[3 * k + 1] = rgb[3 * k + 2] = scale[band[k]];
+            }
+
+            else
+            {
+                rgb[k] = scale[band[k]];
+            }
+        }
+
+        qoiEncode(state, rgb.data(), count, out);
+
+        if (out.size() >= WRITE_BAND)
+        {
+            fout.write((char*)out.data(), out.size());
+            out.clear();
+        }
+    }
+
+    qoiFinish(state, out);
+    fout.write((char*)out.data(), out.size());
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs the image to "basename.pam" in the PAM format. A color image is written with the tuple type RGB
+  * and a grayscale image with GRAYSCALE, and if the image has an alpha channel its value follows the colors
+  * of each pixel, with the tuple type RGB_ALPHA or GRAYSCALE_ALPHA. The pixels are written by
+  * writeBinaryRaster, from all threads at once for large images, and the alpha channel is written in the
+  * same orientation as the colors. The alpha values are scaled to the maximum pixel value.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] basename - name of the output file.
+  * @param[in] max_pix_val - maximum value of a pixel.
+  * @param[in] grayOutput - true if the image is grayscale.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputPam(fout, img, "logo", 255, false);
+
+    //outputs the image and its alpha channel to a file called "logo.pam"
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputPam(ofstream& fout, image img, string basename, int max_pix_val, bool grayOutput, int orient)
+{
+    int channels = grayOutput ? 1 : 3;
+    pixel** scaled = nullptr;
+    string type = grayOutput ? "GRAYSCALE" : "RGB";
+
+    //the pixels in the order they are written
+    imageView v = orientView(makeView(img), orient);
+    image alphaImage = img;
+
+    //opening the output file
+    fout.clear();
+    openOutputFile(fout, basename, ".pam", true);
+
+    if (img.alpha == nullptr)
+    {
+        writePamHeader(fout, img.comment, v.cols, v.rows, channels, max_pix_val, type);
+        writeBinaryRaster(fout, v, channels, outputFileName(basename, ".pam"));
+        return;
+    }
+
+    //alpha on the scale of the colors
+    if (max_pix_val != 255)
+    {
+        scaled = alloc2D(img.rows, img.cols);
+
+        //if memory allocation fails
+        if (scaled == nullptr)
+        {
+            cout << "Memory Allocation Failed" << endl;
+            exit(0);
+        }
+
+        parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+        {
+            int i = 0;
+            int j = 0;
+
+            for (i = rowStart; i < rowEnd; i++)
+            {
+                for (j = 0; j < img.cols; j++)
+                {
+                    scaled[i][j] = (pixel)((img.alpha[i][j] * max_pix_val + 127) / 255);
+                }
+            }
+        });
+    }
+
+    alphaImage.redGray = alphaImage.green = alphaImage.blue = scaled != nullptr ? scaled : img.alpha;
+
+    writePamHeader(fout, img.comment, v.cols, v.rows, channels + 1, max_pix_val, type + "_ALPHA");
+    writeBinaryRaster(fout, v, channels, outputFileName(basename, ".pam"), orientView(makeView(alphaImage), orient).red);
+
+    free2D(scaled, img.rows);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Outputs the image to "basename.pgm" if it is grayscale, or to "basename.ppm" otherwise, in ascii
+  * or binary depending on the output type. Calls outputGrayP2, outputGrayP5, outputP3, or outputP6.
+  * The output type --qoi calls outputQoi instead, which writes "basename.qoi" for either kind of image,
+  * and the output type --pam calls outputPam, which writes "basename.pam" with the alpha channel if there is one.
+  * A black and white image is written to "basename.pbm" by outputP1 or outputP4 instead.
+  * A basename ending in .gz writes a file compressed with gzip, such as "dogs.pgm.gz" for "dogs.gz".
+  * The file stream is closed once the image has been written.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] img - a strucutre of type image.
+  * @param[in] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[in] basename - name of the output file.
+  * @param[in] max_pix_val - maximum value of a pixel.
+  * @param[in] grayOutput - true if the image is written as grayscale.
+  * @param[in] orient - the orientation the pixels are written in, ORIENT_NONE to write them as they are.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    outputImage(fout, img, "--binary", "dogs", max_pix_val, true, ORIENT_NONE);
+
+    //outputs img in binary to a file called "dogs.pgm"
+
+    @endverbatim
+
+  ***********************************************************************/
+void outputImage(ofstream& fout, image& img, string opType, string basename, int max_pix_val, bool grayOutput, int orient)
+{
+    //compressed, for color and grayscale
+    if (opType == "--qoi")
+    {
+        outputQoi(fout, img, basename, max_pix_val, grayOutput, orient);
+    }
+
+    //PAM, with the alpha channel
+    else if (opType == "--pam")
+    {
+        outputPam(fout, img, basename, max_pix_val, grayOutput, orient);
+    }
+
+    //black and white, a digit per pixel
+    else if (isBilevel(img) && opType == "--ascii")
+    {
+        outputP1(fout, img, basename, orient);
+    }
+
+    //black and white, 8 pixels to a byte
+    else if (isBilevel(img))
+    {
+        outputP4(fout, img, basename, orient);
+    }
+
+    //outputting to grayscale and ascii speciied 
+    else if (grayOutput && opType == "--ascii")
+    {
+        outputGrayP2(fout, img, basename, max_pix_val, orient);
+    }
+
+    //grayscale and binary is specified
+    else if (grayOutput)
+    {
+        outputGrayP5(fout, img, basename, max_pix_val, orient);
+    }
+
+    //just output ascii
+    else if (opType == "--ascii")
+    {
+        outputP3(fout, img, basename, max_pix_val, orient);
+    }
+
+    //just output image as itself in binary
+    else
+    {
+        outputP6(fout, img, basename, max_pix_val, orient);
+    }
+
+    closeOutputFile(fout);
+}
+
+
+
+/** ***************************************************************************
+ * @author Jonathan Mascarenhas
+ *
+ * @par Description
+ * The function outputs a usage statement if there are incorrect number of command line arguments
+ * or an incorrect option or output type that may have been entered by the user at the command line 
+ * terminal.
+ *
+ * @param none
+ *
+ * @returns none
+ *
+ * @par Example
+ * @verbatim
+   c:\> thpExam1.exe [option]... --outputtype basename image.ppm
+   d:\> c:\bin\thpExam1.exe [option]... --outputtype basename image.ppm
+   c:\> thpExam1.exe --stats-only image.ppm
+   c:\> thpExam1.exe --probe image.ppm...
+   c:\> thpExam1.exe --benchmark image.ppm
+   c:\> thpExam1.exe --compare image.ppm other.ppm
+   c:\> thpExam1.exe --cache-stats dir
+   c:\> thpExam1.exe --fanout image.ppm [[option]... --outputtype basename]...
+   c:\> thpExam1.exe --batch [option]... --outputtype suffix image.ppm...
+
+         Output Type 
+             --ascii                integer text numbers will be written for the data
+             --binary               integer numbers will be written in binary form
+             --qoi                  lossless compressed pixels will be written to a .qoi file
+             --pam                  pixels and alpha will be written to a .pam file
+
+         Option Code                Option Description
+             --flipX                Flip the image on the X axis
+             --flipY                Flip the image on the Y axis
+             --rotateCW             Rotate the image clockwise
+             --rotateCCW            Rotate the image counterclockwise
+             --grayscale            Convert the image to grayscale
+             --sepia                Antique a color image
+             --resize WxH           Resize to W x H with the Lanczos-3 filter
+             --resizeBilinear WxH   Resize to W x H with the bilinear filter
+             --resizeBox WxH        Resize to W x H with the box filter
+             --thumbnail N          Shrink so the longest side is N pixels
+             --downscale N          Shrink by an integer factor N
+             --reduce N             Shrink by N while the file is read
+             --rotate DEG           Rotate clockwise by any angle in degrees
+             --affine a,b,c,d,e,f   Warp with the affine matrix [a b c; d e f]
+             --crop x,y,w,h         Keep only the w x h region at column x, row y
+             --roi x,y,w,h          Apply the next option to the region only
+             --region x,y,w,h       Read only the region from the file
+             --stats                Print the histogram and statistics of the image
+             --autoLevels           Stretch each channel to the full range
+             --equalize             Equalize the histogram of each channel
+             --tiled                Apply rotations, flips, and colors in 64 x 64 tiles
+             --threshold N          Black and white, with N and above white
+             --palette K            Reduce to K colors
+             --ditherBayer K        Reduce to K colors with ordered dithering
+             --ditherFloyd K        Reduce to K colors with error diffusion
+             --overlay F x,y        Stamp image F with its alpha at column x, row y
+             --sobel                Edges by gradient magnitude, Sobel kernel
+             --scharr               Edges by gradient magnitude, Scharr kernel
+             --sobelX               Horizontal gradient, 128 is flat
+             --sobelY               Vertical gradient, 128 is flat
+             --median R             Median of the (2R+1)x(2R+1) window
+             --erode R              Minimum of the (2R+1)x(2R+1) window
+             --dilate R             Maximum of the (2R+1)x(2R+1) window
+             --cache DIR            Reuse the output of the same run from DIR
+             --checksum             Write a CRC-32C of each output file beside it
+   @endverbatim
+ *****************************************************************************/
+void outputUsage()
+{
+    cout << "Usage: " << endl;
+    
+    cout << "c:\\> thpExam1.exe [option]... --outputtype basename image.ppm" << endl;
+    cout << "d:\\> c:\\bin\\thpExam1.exe [option]... --outputtype basename image.ppm" << endl;
+    cout << "c:\\> thpExam1.exe --stats-only image.ppm" << endl;
+    cout << "c:\\> thpExam1.exe --probe image.ppm..." << endl;
+    cout << "c:\\> thpExam1.exe --benchmark image.ppm" << endl;
+    cout << "c:\\> thpExam1.exe --compare image.ppm other.ppm" << endl;
+    cout << "c:\\> thpExam1.exe --cache-stats dir" << endl;
+    cout << "c:\\> thpExam1.exe --fanout image.ppm [[option]... --outputtype basename]..." << endl;
+    cout << "c:\\> thpExam1.exe --batch [option]... --outputtype suffix image.ppm..." << endl;
+    cout << "\n";
+
+    
+    cout << "Option Code" << setw(25) << "Option Description" << endl;
+    cout << "--flipX" << setw(39) << "Flip the image on the X axis" << endl;
+    cout << "--flipY" << setw(39) << "Flip the image on the Y axis" << endl;
+    cout << "--rotateCW" << setw(34) << "Rotate the image clockwise" << endl;
+    cout << "--rotateCCW" << setw(40) << "Rotate the image counterclockwise" << endl;
+    cout << "--grayscale" << setw(37) << "Convert the image to grayscale" << endl;
+    cout << "--sepia" << setw(32) << "Antique a color image" << endl;
+    cout << "--resize WxH" << setw(47) << "Resize to W x H with the Lanczos-3 filter" << endl;
+    cout << "--resizeBilinear WxH" << setw(41) << "Resize to W x H with the bilinear filter" << endl;
+    cout << "--resizeBox WxH" << setw(38) << "Resize to W x H with the box filter" << endl;
+    cout << "--thumbnail N" << setw(43) << "Shrink so the longest side is N pixels" << endl;
+    cout << "--downscale N" << setw(34) << "Shrink by an integer factor N" << endl;
+    cout << "--reduce N" << setw(42) << "Shrink by N while the file is read" << endl;
+    cout << "--rotate DEG" << setw(46) << "Rotate clockwise by any angle in degrees" << endl;
+    cout << "--affine a,b,c,d,e,f" << setw(43) << "Warp with the affine matrix [a b c; d e f]" << endl;
+    cout << "--crop x,y,w,h" << setw(49) << "Keep only the w x h region at column x, row y" << endl;
+    cout << "--roi x,y,w,h" << setw(45) << "Apply the next option to the region only" << endl;
+    cout << "--region x,y,w,h" << setw(36) << "Read only the region from the file" << endl;
+    cout << "--stats" << setw(58) << "Print the histogram and statistics of the image" << endl;
+    cout << "--autoLevels" << setw(44) << "Stretch each channel to the full range" << endl;
+    cout << "--equalize" << setw(46) << "Equalize the histogram of each channel" << endl;
+    cout << "--tiled" << setw(62) << "Apply rotations, flips, and colors in 64 x 64 tiles" << endl;
+    cout << "--threshold N" << setw(44) << "Black and white, with N and above white" << endl;
+    cout << "--palette K" << setw(25) << "Reduce to K colors" << endl;
+    cout << "--ditherBayer K" << setw(44) << "Reduce to K colors with ordered dithering" << endl;
+    cout << "--ditherFloyd K" << setw(42) << "Reduce to K colors with error diffusion" << endl;
+    cout << "--overlay F x,y" << setw(50) << "Stamp image F with its alpha at column x, row y" << endl;
+    cout << "--sobel" << setw(52) << "Edges by gradient magnitude, Sobel kernel" << endl;
+    cout << "--scharr" << setw(52) << "Edges by gradient magnitude, Scharr kernel" << endl;
+    cout << "--sobelX" << setw(42) << "Horizontal gradient, 128 is flat" << endl;
+    cout << "--sobelY" << setw(40) << "Vertical gradient, 128 is flat" << endl;
+    cout << "--median R" << setw(42) << "Median of the (2R+1)x(2R+1) window" << endl;
+    cout << "--erode R" << setw(44) << "Minimum of the (2R+1)x(2R+1) window" << endl;
+    cout << "--dilate R" << setw(43) << "Maximum of the (2R+1)x(2R+1) window" << endl;
+    cout << "--cache DIR" << setw(48) << "Reuse the output of the same run from DIR" << endl;
+    cout << "--checksum" << setw(53) << "Write a CRC-32C of each output file beside it" << endl;
+    cout << "\n";
+
+    cout << "Output Type" << endl;
+    cout << "--ascii" << setw(60) << "integer text numbers will be written for the data" << endl;
+    cout << "--binary" << setw(56) << "integer numbers will be written in binary form" << endl;
+    cout << "--qoi" << setw(70) << "lossless compressed pixels will be written to a .qoi file" << endl;
+    cout << "--pam" << setw(60) << "pixels and alpha will be written to a .pam file" << endl;
 }
\ No newline at end of file
@@ -0,0 +1,516 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the median filter and the erode and dilate functions
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the rows are compared one pixel at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FILTER_SSE2
+#endif
+
+/**
+ * @brief Number of fine bins in each coarse bin of the median histograms.
+ */
+const int MEDIAN_FINE = 16;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Replaces each value of run with the smaller of it and the value of src below it, or the larger
+  * of the two for dilate. With SSE2, 16 pixels are compared at once.
+  *
+  * @param[in,out] run - the row that keeps the running minimum or maximum.
+  * @param[in] src - the row that is compared with it.
+  * @param[in] cols - the number of pixels.
+  * @param[in] dilate - true for the maximum, false for the minimum.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel run[3] = { 10, 200, 30 };
+    pixel src[3] = { 50, 20, 30 };
+
+    extremeRow(run, src, 3, false);
+
+    //run is 10, 20, 30
+
+    @endverbatim
+
+  ***********************************************************************/
+static void extremeRow(pixel* run, const pixel* src, int cols, bool dilate)
+{
+    //loop variable
+    int j = 0;
+
+#ifdef FILTER_SSE2
+    __m128i a, b;
+
+    for (j = 0; j + 16 <= cols; j += 16)
+    {
+        a = _mm_loadu_si128((const __m128i*)(run + j));
+        b = _mm_loadu_si128((const __m128i*)(src + j));
+
+        _mm_storeu_si128((__m128i*)(run + j), dilate ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b));
+    }
+#endif
+
+    for (; j < cols; j++)
+    {
+        run[j] = dilate ? max(run[j], src[j]) : min(run[j], src[j]);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Replaces each pixel of a row with the minimum, or the maximum for dilate, of the pixels within
+  * radius of it, by the van Herk/Gil-Werman algorithm. The row, with radius pixels repeated past
+  * each end, is cut into blocks of 2 * radius + 1 pixels. Every window of that size covers the end
+  * of one block and the start of the next, so its result is the smaller of the running minimum from
+  * the end of the first block back to the window, and the running minimum from the start of the next
+  * block up to the end of the window. That is three comparisons per pixel for any radius.
+  *
+  * @param[in,out] row - the row.
+  * @param[in] cols - the number of pixels.
+  * @param[in] radius - the distance from the pixel to the edge of the window.
+  * @param[in] dilate - true for the maximum, false for the minimum.
+  * @param[out] line - a copy of the row, cols pixels.
+  * @param[out] suffix - the running values from the end of each block, cols pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel row[5] = { 9, 4, 7, 8, 1 };
+
+    extremeLine(row, 5, 1, false, line.data(), suffix.data());
+
+    //row is 4, 4, 4, 1, 1
+
+    @endverbatim
+
+  ***********************************************************************/
+static void extremeLine(pixel* row, int cols, int radius, bool dilate, pixel* line, pixel* suffix)
+{
+    //loop variables
+    int b = 0;
+    int p = 0;
+
+    int width = 2 * radius + 1;
+    pixel value = 0;
+    pixel acc = 0;
+
+    memcpy(line, row, cols);
+
+    for (b = 0; b < cols; b += width)
+    {
+        //back from the end of the block
+        for (p = b + width - 1; p >= b; p--)
+        {
+            value = line[min(max(p - radius, 0), cols - 1)];
+            acc = p == b + width - 1 ? value : (dilate ? max(acc, value) : min(acc, value));
+
+            if (p < cols)
+            {
+                suffix[p] = acc;
+            }
+        }
+
+        row[b] = suffix[b];
+
+        //forward through the next block, which finishes the windows that start inside this one
+        for (p = b + width; p < b + 2 * width - 1 && p - 2 * radius < cols; p++)
+        {
+            value = line[min(p - radius, cols - 1)];
+            acc = p == b + width ? value : (dilate ? max(acc, value) : min(acc, value));
+
+            row[p - 2 * radius] = dilate ? max(suffix[p - 2 * radius], acc) : min(suffix[p - 2 * radius], acc);
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Erodes or dilates one channel with a square window of 2 * radius + 1 pixels on a side. The
+  * window is separable, so the columns are done first, into a new channel, and then each of its
+  * rows in place by extremeLine. The rows are split across threads. Down the columns the van
+  * Herk/Gil-Werman blocks start at the first row of each strip, and whole rows are combined at once
+  * by extremeRow, so a strip only keeps one row of running values. A radius past the size of the
+  * image covers all of it, so it is cut down to that, and the cost per pixel does not depend on it.
+  *
+  * @param[in,out] channel - the channel, replaced by the result.
+  * @param[in] rows - the number of rows.
+  * @param[in] cols - the number of columns.
+  * @param[in] radius - the distance from the pixel to the edge of the window.
+  * @param[in] dilate - true to dilate, false to erode.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    morphChannel(img.redGray, img.rows, img.cols, 3, false);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void morphChannel(pixel**& channel, int rows, int cols, int radius, bool dilate)
+{
+    pixel** result = nullptr;
+
+    int down = min(radius, rows - 1);
+    int across = min(radius, cols - 1);
+    int width = 2 * down + 1;
+
+    result = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if (result == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, rows, [&](int rowStart, int rowEnd)
+    {
+        int b = 0;
+        int p = 0;
+        const pixel* src = nullptr;
+
+        vector<pixel> run(cols);
+        vector<pixel> line(cols);
+        vector<pixel> suffix(cols);
+
+        //down the columns, a block at a time
+        for (b = rowStart; b < rowEnd; b += width)
+        {
+            for (p = b + width - 1; p >= b; p--)
+            {
+                src = channel[min(max(p - down, 0), rows - 1)];
+
+                if (p == b + width - 1)
+                {
+                    memcpy(run.data(), src, cols);
+                }
+
+                else
+                {
+                    extremeRow(run.data(), src, cols, dilate);
+                }
+
+                if (p < rowEnd)
+                {
+                    memcpy(result[p], run.data(), cols);
+                }
+            }
+
+            for (p = b + width; p < b + 2 * width - 1 && p - 2 * down < rowEnd; p++)
+            {
+                src = channel[min(p - down, rows - 1)];
+
+                if (p == b + width)
+                {
+                    memcpy(run.data(), src, cols);
+                }
+
+                else
+                {
+                    extremeRow(run.data(), src, cols, dilate);
+                }
+
+                extremeRow(result[p - 2 * down], run.data(), cols, dilate);
+            }
+        }
+
+        //across the rows of the strip
+        for (p = rowStart; p < rowEnd; p++)
+        {
+            extremeLine(result[p], cols, across, dilate, line.data(), suffix.data());
+        }
+    });
+
+    free2D(channel, rows);
+    channel = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Replaces each pixel of one channel with the median of the square window of 2 * radius + 1
+  * pixels on a side around it, with the pixels on the edges repeated past the edges. The cost per
+  * pixel does not depend on the radius. Each strip of rows keeps a histogram of every column of the
+  * window, which is updated by one pixel out and one pixel in as the window moves down a row. The
+  * histogram of the window is the sum of the column histograms under it, and moving right adds the
+  * column that comes in and takes away the one that goes out. The histograms have 16 coarse bins
+  * of 16 fine bins each; the coarse bins of the window are kept up to date, and the fine bins of a
+  * coarse bin are only brought up to date when the median falls into it. A window of the largest
+  * radius holds more than INT_MAX pixels, so the window histograms count in 64 bits.
+  *
+  * @param[in,out] channel - the channel, replaced by the result.
+  * @param[in] rows - the number of rows.
+  * @param[in] cols - the number of columns.
+  * @param[in] radius - the distance from the pixel to the edge of the window.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    medianChannel(img.redGray, img.rows, img.cols, 2);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void medianChannel(pixel**& channel, int rows, int cols, int radius)
+{
+    pixel** result = nullptr;
+
+    int width = 2 * radius + 1;
+    long long target = (long long)width * width / 2;
+
+    result = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if (result == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, rows, [&](int rowStart, int rowEnd)
+    {
+        //loop variables
+        int i = 0;
+        int j = 0;
+        int k = 0;
+        int c = 0;
+        int v = 0;
+
+        long long acc = 0;
+        int in = 0;
+        int out = 0;
+
+        vector<unsigned short> colFine((size_t)cols * 256);
+        vector<unsigned short> colCoarse((size_t)cols * MEDIAN_FINE);
+        long long fine[256];
+        long long coarse[MEDIAN_FINE];
+        int lastCol[MEDIAN_FINE];
+
+        auto column = [&](int col)
+        {
+            return min(max(col, 0), cols - 1);
+        };
+
+        //adds the pixels of a row to the column histograms, or takes them away
+        auto count = [&](const pixel* row, int step)
+        {
+            int jj = 0;
+
+            for (jj = 0; jj < cols; jj++)
+            {
+                colFine[(size_t)jj * 256 + row[jj]] += (unsigned short)step;
+                colCoarse[(size_t)jj * MEDIAN_FINE + row[jj] / MEDIAN_FINE] += (unsigned short)step;
+            }
+        };
+
+        for (i = rowStart - radius; i <= rowStart + radius; i++)
+        {
+            count(channel[min(max(i, 0), rows - 1)], 1);
+        }
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            //the window moves down a row
+            if (i > rowStart)
+            {
+                count(channel[min(max(i - radius - 1, 0), rows - 1)], -1);
+                count(channel[min(i + radius, rows - 1)], 1);
+            }
+
+            memset(coarse, 0, sizeof(coarse));
+
+            for (c = -radius; c <= radius; c++)
+            {
+                for (k = 0; k < MEDIAN_FINE; k++)
+                {
+                    coarse[k] += colCoarse[(size_t)column(c) * MEDIAN_FINE + k];
+                }
+            }
+
+            //no fine bins are up to date at the start of a row
+            for (k = 0; k < MEDIAN_FINE; k++)
+            {
+                lastCol[k] = -width - 1;
+            }
+
+            for (j = 0; j < cols; j++)
+            {
+                //the window moves right a column
+                if (j > 0)
+                {
+                    in = column(j + radius) * MEDIAN_FINE;
+                    out = column(j - radius - 1) * MEDIAN_FINE;
+
+                    for (k = 0; k < MEDIAN_FINE; k++)
+                    {
+                        coarse[k] += colCoarse[in + k] - colCoarse[out + k];
+                    }
+                }
+
+                //the coarse bin that holds the median
+                acc = 0;
+
+                for (k = 0; acc + coarse[k] <= target; k++)
+                {
+                    acc += coarse[k];
+                }
+
+                //its fine bins, summed again if they are older than the window
+                if (j - lastCol[k] > width)
+                {
+                    memset(fine + k * MEDIAN_FINE, 0, MEDIAN_FINE * sizeof(long long));
+
+                    for (c = j - radius; c <= j + radius; c++)
+                    {
+                        for (v = 0; v < MEDIAN_FINE; v++)
+                        {
+                            fine[k * MEDIAN_FINE + v] += colFine[(size_t)column(c) * 256 + k * MEDIAN_FINE + v];
+                        }
+                    }
+                }
+
+                else
+                {
+                    for (c = lastCol[k] + 1; c <= j; c++)
+                    {
+                        in = column(c + radius) * 256 + k * MEDIAN_FINE;
+                        out = column(c - radius - 1) * 256 + k * MEDIAN_FINE;
+
+                        for (v = 0; v < MEDIAN_FINE; v++)
+                        {
+                            fine[k * MEDIAN_FINE + v] += colFine[in + v] - colFine[out + v];
+                        }
+                    }
+                }
+
+                lastCol[k] = j;
+
+                for (v = k * MEDIAN_FINE; acc + fine[v] <= target; v++)
+                {
+                    acc += fine[v];
+                }
+
+                result[i][j] = (pixel)v;
+            }
+        }
+    });
+
+    free2D(channel, rows);
+    channel = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Removes noise from the image by replacing each pixel with the median of the square window of
+  * 2 * radius + 1 pixels on a side around it, in each channel. The time per pixel is the same for
+  * any radius.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] radius - the distance from the pixel to the edge of the window, at least 1.
+  * @param[in] channels - the number of channels to filter, 3 or 1 for a grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --median 2 --binary clean scan.ppm
+    medianFilter(img, 2, 3);
+
+    //specks smaller than 5 x 5 pixels are gone from clean.ppm
+
+    @endverbatim
+
+  ***********************************************************************/
+void medianFilter(image& img, int radius, int channels)
+{
+    //loop variable
+    int c = 0;
+
+    pixel** planes[3] = { img.redGray, img.green, img.blue };
+
+    for (c = 0; c < channels; c++)
+    {
+        medianChannel(planes[c], img.rows, img.cols, radius);
+    }
+
+    img.redGray = planes[0];
+    img.green = planes[1];
+    img.blue = planes[2];
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Erodes the image, replacing each pixel with the minimum of the square window of 2 * radius + 1
+  * pixels on a side around it, or dilates it with the maximum, in each channel. Eroding shrinks the
+  * bright parts of the image and dilating grows them. The time per pixel is the same for any radius.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] radius - the distance from the pixel to the edge of the window, at least 1.
+  * @param[in] dilate - true to dilate, false to erode.
+  * @param[in] channels - the number of channels to change, 3 or 1 for a grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --threshold 128 --dilate 1 --binary bold text.pgm
+    morphImage(img, 1, true, 1);
+
+    //the white parts of bold.pbm are a pixel wider on every side
+
+    @endverbatim
+
+  ***********************************************************************/
+void morphImage(image& img, int radius, bool dilate, int channels)
+{
+    //loop variable
+    int c = 0;
+
+    pixel** planes[3] = { img.redGray, img.green, img.blue };
+
+    for (c = 0; c < channels; c++)
+    {
+        morphChannel(planes[c], img.rows, img.cols, radius, dilate);
+    }
+
+    img.redGray = planes[0];
+    img.green = planes[1];
+    img.blue = planes[2];
+}
@@ -1,651 +1,1003 @@
-/** *********************************************************************
- * @file
- *
- * @brief   contains functions that manipulate images 
- ***********************************************************************/
-
-#include "netPBM.h"
-
- /** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This function takes a struct of type image as input. It then proceeds to allocate three new temporary 
-  * 2D dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
-  * The function checks to see if the memory has been allocated and exits with zero if not.
-  * The dimensions of these arrays are cols x rows, since the image is to be rotated clockwise.
-  * The function then proceeds to execute two loops which interchange the rows of the original 
-  * image for the columns of the resulting image. The first row of the original image is now at the 
-  * last column for the modified image. The free2D function is called to delete the original 2D arrays of 
-  * the structure. They are then assigned new dimensions of cols x rows using the alloc2D function. Memory 
-  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
-  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
-  * The rows and columns parameters of the strucutre are also exchanged to reflect the dimensions of the new image.
-  * 
-  *
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-    
-    //rotating an image of dimensions 210 x 771 clockwise
-    img.rows = 210;
-    img.cols = 771;
-
-    rotateClockwise(img);
-
-    //img now contains a clockwise image of dimensions 771 x 210.
-    //img.rows = 771;
-    //img.cols = 210;
-
-    @endverbatim
-
-  ***********************************************************************/
-void rotateClockWise(image &img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;    
-
-    //assigning the values of rows and columns of flip X
-    rows = img.rows;
-    cols = img.cols;    
-
-    //temporary 2D arrays
-    pixel** redGrayTemp = nullptr;
-    pixel** greenTemp = nullptr;
-    pixel** blueTemp = nullptr;
-
-    //allocate three new 2D arrays
-    redGrayTemp = alloc2D(cols, rows);
-    greenTemp = alloc2D(cols, rows);
-    blueTemp = alloc2D(cols, rows);
-
-    //if memory allocation fails
-    if ((redGrayTemp == nullptr) || (greenTemp == nullptr) || (blueTemp == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //two for loops 
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            redGrayTemp[j][img.rows - i - 1] = img.redGray[i][j];
-            greenTemp[j][img.rows - i - 1] = img.green[i][j];
-            blueTemp[j][img.rows - i - 1] = img.blue[i][j];
-
-        }
-    }
-
-    //freeing up the memory allocated to img.redgray, img.green, img.blue
-    free2D(img.redGray, img.rows);
-    free2D(img.green, img.rows);
-    free2D(img.blue, img.rows);
-
-    //making a new size for the img pointers
-    img.redGray = alloc2D(cols, rows);
-    img.green = alloc2D(cols, rows);
-    img.blue = alloc2D(cols, rows);
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //assigning each value of temporary arrays to structure
-    copy2D(img.redGray, redGrayTemp, cols, rows);
-    copy2D(img.green, greenTemp, cols, rows);
-    copy2D(img.blue, blueTemp, cols, rows);
-
-    //freeing up the memory allocated to temporary arrays
-    free2D(redGrayTemp, cols);
-    free2D(greenTemp, cols);
-    free2D(blueTemp, cols);
-
-    //changing the values of rows and columns
-    img.rows = cols;
-    img.cols = rows;    
- 
-        
-    
-}
-
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This function takes a struct of type image as input. It then proceeds to allocated three new 2D
-  * dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
-  * The function checks to see if the memory has been allocated and exits with zero if not.
-  * The dimensions of these arrays are cols x rows, since the image is to be rotated counter clockwise.
-  * The function then proceeds to execute two loops which interchange the rows of the original
-  * image for the columns of the resulting image. The first row of the original image is now at the
-  * first column for the modified image. The free2D function is called to delete the original 2D arrays of 
-  * the structure. They are then assigned new dimensions of cols x rows using the alloc2D function. Memory 
-  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
-  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
-  * The rows and columns parameters of the strucutre are also exchanged to reflect the dimensions of the new image.
-  *
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    //rotating an image of dimensions 210 x 771 counter clockwise
-    img.rows = 210;
-    img.cols = 771;
-
-    rotateCounterClockwise(img);
-
-    //img now contains a counter clockwise image of dimensions 771 x 210.
-    //img.rows = 771;
-    //img.cols = 210;
-
-    @endverbatim
-
-  ***********************************************************************/
-void rotateCounterClockWise(image& img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;
-
-    //assigning the values of rows and columns of flip X
-    rows = img.rows;
-    cols = img.cols;
-
-    //temporary 2D arrays
-    pixel** redGrayTemp = nullptr;
-    pixel** greenTemp = nullptr;
-    pixel** blueTemp = nullptr;
-
-    //allocate three new 2D arrays
-    redGrayTemp = alloc2D(cols, rows);
-    greenTemp = alloc2D(cols, rows);
-    blueTemp = alloc2D(cols, rows);
-
-    //if memory allocation fails
-    if ((redGrayTemp == nullptr) || (greenTemp == nullptr) || (blueTemp == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-
-    //two for loops 
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            redGrayTemp[img.cols -1 -j][i] = img.redGray[i][j];
-            greenTemp[img.cols - 1 - j][i] = img.green[i][j];
-            blueTemp[img.cols - 1 - j][i] = img.blue[i][j];
-
-        }
-    }
-
-    //freeing up the memory allocated to img.redgray, img.green, img.blue
-    free2D(img.redGray, img.rows);
-    free2D(img.green, img.rows);
-    free2D(img.blue, img.rows);
-
-    //making a new size for the img pointers
-    img.redGray = alloc2D(cols, rows);
-    img.green = alloc2D(cols, rows);
-    img.blue = alloc2D(cols, rows);
-
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-
-    //assigning each value of temporary arrays to structure
-    copy2D(img.redGray, redGrayTemp, cols, rows);
-    copy2D(img.green, greenTemp, cols, rows);
-    copy2D(img.blue, blueTemp, cols, rows);
-
-    //free up the memory allocated to the temporary arrays
-    free2D(redGrayTemp, cols);
-    free2D(greenTemp, cols);
-    free2D(blueTemp, cols);
-
-    //changing the values of rows and columns
-    img.rows = cols;
-    img.cols = rows;    
-
-    
-
-}
-
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
-  * dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
-  * The function checks if the memory has been allocated and exits with a zero if it did not.
-  * The dimensions of these arrays are rows x cols, since flipping on X axis does not affect dimensions.
-  * The function then proceeds to execute two loops which interchange the rows of the original
-  * image for the mirroring rows of the resulting image. The first row of the original image is now at the
-  * last row for the modified image. The mth row is now at the (rows - m)th row in the resulting image. The 
-  * values of row and column for img do not the change. The free2D function is called to delete the original 2D arrays of 
-  * the structure. They are then assigned new dimensions of cols x rows using the alloc2D function. Memory 
-  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
-  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
-  * The rows and columns parameters of the strucutre are also exchanged to reflect the dimensions of the new image.
-  *
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-    //flipping an image of dimensions 210 x 771 on the X axis
-    img.rows = 210;
-    img.cols = 771;
-
-    flipAxisX(img);
-
-    //img now contains a flipped image on X axis of dimensions 210 x 771.
-    //img.rows = 210;
-    //img.cols = 771;
-
-    @endverbatim
-
-  ***********************************************************************/
-void flipAxisX(image &img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;
-
-    //assigning the values of rows and columns of flip X
-    rows = img.rows;
-    cols = img.cols;
-
-    //temporary 2D arrays
-    pixel** redGrayTemp = nullptr;
-    pixel** greenTemp = nullptr;
-    pixel** blueTemp = nullptr;
-
-    //allocate three new 2D arrays
-    redGrayTemp = alloc2D(rows, cols);
-    greenTemp = alloc2D(rows, cols);
-    blueTemp = alloc2D(rows, cols);
-
-    if (redGrayTemp == nullptr || greenTemp == nullptr || blueTemp == nullptr)
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //two for loops 
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-
-            redGrayTemp[rows - i - 1][j] = img.redGray[i][j];
-            greenTemp[rows - i - 1][j] = img.green[i][j];
-            blueTemp[rows - i - 1][j] = img.blue[i][j];
-
-        }
-    }
-
-
-    //freeing up the memory allocated to img.redgray, img.green, img.blue
-    free2D(img.redGray, img.rows);
-    free2D(img.green, img.rows);
-    free2D(img.blue, img.rows);
-
-    //making a new size for the img pointers
-    img.redGray = alloc2D(rows, cols);
-    img.green = alloc2D(rows, cols);
-    img.blue = alloc2D(rows, cols);
-
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //assigning each value of temporary arrays to structure
-    copy2D(img.redGray, redGrayTemp, rows, cols);
-    copy2D(img.green, greenTemp, rows, cols);
-    copy2D(img.blue, blueTemp, rows, cols);
-
-    //free up the memory allocated to the temporary arrays
-    free2D(redGrayTemp, rows);
-    free2D(greenTemp, rows);
-    free2D(blueTemp, rows);
-
-    
-}
-
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
-  * dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
-  * The function checks if the memory has been allocated and exits with a zero if it did not.
-  * The dimensions of these arrays are rows x cols, since flipping on Y axis does not affect dimensions.
-  * The function then proceeds to execute two loops which interchange the columns of the original
-  * image for the mirroring columns of the resulting image. The first column of the original image is now at the
-  * last column for the modified image. The nth column is now at the (cols - n)th column in the resulting image. The
-  * values of row and column for img do not the change. The free2D function is called to delete the original 2D arrays of 
-  * the structure. They are then assigned new dimensions of rows x cols using the alloc2D function. Memory 
-  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
-  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
-  *
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-   //flipping an image of dimensions 210 x 771 on the Y axis
-    img.rows = 210;
-    img.cols = 771;
-
-    flipAxisY(img);
-
-    //img now contains a flipped image on Y axis of dimensions 210 x 771.
-    //img.rows = 210;
-    //img.cols = 771;
-
-    @endverbatim
-
-  ***********************************************************************/
-void flipAxisY(image& img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;
-
-    //assigning the values of rows and columns of flip X
-    rows = img.rows;
-    cols = img.cols;
-
-    //temporary 2D arrays
-    pixel** redGrayTemp = nullptr;
-    pixel** greenTemp = nullptr;
-    pixel** blueTemp = nullptr;
-
-    //allocate three new 2D arrays
-    redGrayTemp = alloc2D(rows, cols);
-    greenTemp = alloc2D(rows, cols);
-    blueTemp = alloc2D(rows, cols);
-
-    //if memory allocation fails
-    if (redGrayTemp == nullptr || greenTemp == nullptr || blueTemp == nullptr)
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //two for loops 
-    for (i = 0; i < img.rows; i++)
-    {
-        for (j = 0; j < img.cols; j++)
-        {
-            redGrayTemp[i][cols - j -1] = img.redGray[i][j];
-            greenTemp[i][cols - j - 1] = img.green[i][j];
-            blueTemp[i][cols - j - 1] = img.blue[i][j];
-
-        }
-    }
-
-
-    //freeing up the memory allocated to img.redgray, img.green, img.blue
-    free2D(img.redGray, img.rows);
-    free2D(img.green, img.rows);
-    free2D(img.blue, img.rows);
-
-    //making a new size for the img pointers
-    img.redGray = alloc2D(rows, cols);
-    img.green = alloc2D(rows, cols);
-    img.blue = alloc2D(rows, cols);
-
-    //if memory allocation fails
-    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
-    {
-        cout << "Memory Allocation Failed" << endl;
-        exit(0);
-    }
-
-    //assigning each value of temporary arrays to structure
-    copy2D(img.redGray, redGrayTemp, rows, cols);
-    copy2D(img.green, greenTemp, rows, cols);
-    copy2D(img.blue, blueTemp, rows, cols);
-
-    //free up the memory allocated to the temporary arrays
-    free2D(redGrayTemp, rows);
-    free2D(greenTemp, rows);
-    free2D(blueTemp, rows);
-}
-
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * The convertGrayScale function covnerts a coloured image to a grayscale image. This function takes a 
-  * struct of type image as input. The function then proceeds to execute two loops where the gray channel 
-  * is assigned a value equal to a function of the red, green, and blue channels of the image. The gray channel 
-  * equals 30% of the red channel, 60% of the green channel, and 10% of the blue channel. The value obtained 
-  * from taking fractional values of each channel is a double. Since the arrays of the structure store the pixel
-  * datatype, the double is typecasted to a pixel. The values of row and column for img do not the change. 
-  * 
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-   //grayscaling an image of dimensions 210 x 771
-    img.rows = 210;
-    img.cols = 771;
-
-    convertGrayScale(img);
-
-    //img now contains a grayscaled image of dimensions 210 x 771.
-    //img.rows = 210;
-    //img.cols = 771;
-
-    @endverbatim
-
-  ***********************************************************************/
-void convertGrayScale(image& img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;
-
-    //assigning the respective values
-    rows = img.rows;
-    cols = img.cols;
-
-        
-    //looping through each element of dynamic array
-    for (i = 0; i < rows; i++)
-    {
-        for (j = 0; j < cols; j++)
-        {
-            img.redGray[i][j] = (pixel) (0.3 * img.redGray[i][j] + 0.6 * img.green[i][j] + 0.1 * img.blue[i][j]);
-        }
-    }
-
-    
-}
-
-
-
-/** *********************************************************************
-  * @author Jonathan Mascarenhas
-  *
-  * @par Description:
-  * The convertSepia function anitiques an image. 
-  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
-  * dynamic arrays with pixel datatype. These arrays are named tr, tg, and tb respectively.
-  * The function checks if the memory has been allocated to tr, tg, and tb and exits with zero if not.
-  * The dimension of these arrays is rows x cols, since anitquing an image does not affect its dimensions.
-  * The function then proceeds to execute two loops where the tr, tg, and tb channels are assigned a value equal to
-  * a function of the red, green, and blue channels of the original image. If the value of any element of tr, 
-  * tg, or tb is greater than 255, then a value of 255 is assgined to them instead. The copy2D function is then 
-  * called to copy the values from tr, tg, and tb back into the 2D arrays of the structure. The temporary arrays 
-  * tr, tg, and tb are then freed up.
-  *
-  * @param[in,out] img - the struct of type image that is manipulated
-  *
-  * @returns none
-  *
-  * @par Example:
-    @verbatim
-
-   //antiquing an image of dimensions 210 x 771
-    img.rows = 210;
-    img.cols = 771;
-
-    convertSepia(img);
-
-    //img now contains an antiqued image of dimensions 210 x 771.
-    //img.rows = 210;
-    //img.cols = 771;
-
-    @endverbatim
-
-  ***********************************************************************/
-void convertSepia(image& img)
-{
-    //loop variables
-    int i = 0;
-    int j = 0;
-
-    //initializing variables
-    int rows = 0;
-    int cols = 0;
-
-    //more variables
-    int r, g, b;
-
-    //assigning the respective values
-    rows = img.rows;
-    cols = img.cols;
-
-    //creating a 2D pointer
-    pixel** tr = nullptr;
-    pixel** tg = nullptr;
-    pixel** tb = nullptr;
-
-    //allocating a dynamic 2D array for sepia
-    tr = alloc2D(img.rows, img.cols);
-    tg = alloc2D(img.rows, img.cols);
-    tb = alloc2D(img.rows, img.cols);
-
-    if (tr == nullptr || tg == nullptr || tb == nullptr)
-    {
-        cout << "Memory Allocation Error" << endl;
-        exit(0);
-    }
-
-    //looping through each element of dynamic array
-    for (i = 0; i < rows; i++)
-    {
-        for (j = 0; j < cols; j++)
-        {
-            r = (int) (0.393 * img.redGray[i][j] + 0.769 * img.green[i][j] + 0.189 * img.blue[i][j]);
-            g = (int) (0.349 * img.redGray[i][j] + 0.686 * img.green[i][j] + 0.168 * img.blue[i][j]);
-            b = (int) (0.272 * img.redGray[i][j] + 0.534 * img.green[i][j] + 0.131 * img.blue[i][j]);
-
-            if (r > 255)
-            {
-                tr[i][j] = 255;
-            }
-
-            else
-            {
-                tr[i][j] = r;
-            }
-
-            if (g > 255)
-            {
-                tg[i][j] = 255;
-            }
-
-            else
-            {
-                tg[i][j] = g;
-            }
-
-            if (b > 255)
-            {
-                tb[i][j] = 255;
-            }
-
-            else
-            {
-                tb[i][j] = b;
-            }
-
-            
-        }
-    }
-
-    //assigning the values back to the original array
-    copy2D(img.redGray, tr, rows, cols);
-    copy2D(img.green, tg, rows, cols);
-    copy2D(img.blue, tb, rows, cols);
-
-    //freeing up the temporary arrays
-    free2D(tr, rows);
-    free2D(tg, rows);
-    free2D(tb, rows);
-
-
-}
\ No newline at end of file
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that manipulate images 
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates a square channel of n x n pixels by 90 degrees in place. The channel is split into
+  * four quarters, and every pixel in the top left quarter is swapped around with the three pixels
+  * that it is rotated onto, so that all four move in a single step. Each group of four pixels is
+  * only touched once, so the rows of the top left quarter are split into strips that run in parallel.
+  *
+  * @param[in,out] channel - the 2D array of the channel.
+  * @param[in] n - the number of rows and columns of the channel.
+  * @param[in] clockwise - true to rotate clockwise, false to rotate counter clockwise.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    rotateSquare(img.redGray, 512, true);
+
+    //the red channel is rotated clockwise without any temporary arrays
+
+    @endverbatim
+
+  ***********************************************************************/
+static void rotateSquare(pixel** channel, int n, bool clockwise)
+{
+    parallelFor(0, n / 2, [&](int rowStart, int rowEnd)
+    {
+        int i, j;
+        pixel temp;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            for (j = 0; j < (n + 1) / 2; j++)
+            {
+                temp = channel[i][j];
+
+                if (clockwise)
+                {
+                    channel[i][j] = channel[n - 1 - j][i];
+                    channel[n - 1 - j][i] = channel[n - 1 - i][n - 1 - j];
+                    channel[n - 1 - i][n - 1 - j] = channel[j][n - 1 - i];
+                    channel[j][n - 1 - i] = temp;
+                }
+
+                else
+                {
+                    channel[i][j] = channel[j][n - 1 - i];
+                    channel[j][n - 1 - i] = channel[n - 1 - i][n - 1 - j];
+                    channel[n - 1 - i][n - 1 - j] = channel[n - 1 - j][i];
+                    channel[n - 1 - j][i] = temp;
+                }
+            }
+        }
+    });
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Transposes a channel of rows x cols pixels in place, so that it becomes cols x rows. Since alloc2D
+  * stores a channel as one block, the pixel at index k = i * cols + j of the block belongs at index
+  * j * rows + i, which equals k * rows modulo rows * cols - 1. Following where each pixel has to go
+  * splits the block into cycles of pixels that are moved round one place each. The visited bitset,
+  * one bit per pixel, marks the pixels that have been moved, so each cycle is only followed once. This
+  * needs no second copy of the channel. The array of row pointers is then replaced by one for the
+  * new dimensions.
+  *
+  * @param[in,out] channel - the 2D array of the channel.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] cols - the number of columns of the channel.
+  * @param[in,out] visited - the bitset, reused between channels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<unsigned long long> visited;
+
+    transposeInPlace(img.redGray, 210, 771, visited);
+
+    //img.redGray is now a 2D array of 771 x 210 with img.redGray[j][i] the old img.redGray[i][j]
+
+    @endverbatim
+
+  ***********************************************************************/
+static void transposeInPlace(pixel**& channel, int rows, int cols, vector<unsigned long long>& visited)
+{
+    //loop variables
+    long long i = 0;
+    long long start = 0;
+
+    long long n = (long long)rows * cols;
+    long long cur = 0;
+    long long next = 0;
+
+    pixel* block = channel[0];
+    pixel** rowPtrs = nullptr;
+    pixel value = 0;
+
+    //a single row or column is already laid out the same either way
+    if (rows > 1 && cols > 1)
+    {
+        visited.assign((size_t)((n + 63) / 64), 0);
+
+        //the first and last pixels never move
+        for (start = 1; start < n - 1; start++)
+        {
+            if (visited[start >> 6] & (1ULL << (start & 63)))
+            {
+                continue;
+            }
+
+            //move every pixel of the cycle to where it belongs
+            cur = start;
+            value = block[start];
+
+            do
+            {
+                next = cur * rows % (n - 1);
+
+                swap(value, block[next]);
+                visited[next >> 6] |= 1ULL << (next & 63);
+
+                cur = next;
+            } while (cur != start);
+        }
+    }
+
+    //row pointers for the new dimensions
+    rowPtrs = new (nothrow) pixel * [cols];
+
+    //if memory allocation fails
+    if (rowPtrs == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    for (i = 0; i < cols; i++)
+    {
+        rowPtrs[i] = block + i * rows;
+    }
+
+    delete [] channel;
+    channel = rowPtrs;
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates a channel of rows x cols pixels by 90 degrees in place, so that it becomes cols x rows.
+  * Square channels are rotated by rotateSquare. Other channels are transposed by transposeInPlace,
+  * after which reversing every row gives the clockwise rotation and reversing the order of the rows
+  * gives the counter clockwise rotation. Rows are reversed and exchanged in parallel strips.
+  *
+  * @param[in,out] channel - the 2D array of the channel.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] cols - the number of columns of the channel.
+  * @param[in] clockwise - true to rotate clockwise, false to rotate counter clockwise.
+  * @param[in,out] visited - the bitset used by transposeInPlace, reused between channels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<unsigned long long> visited;
+
+    rotateChannel(img.redGray, 210, 771, true, visited);
+
+    //img.redGray is now the clockwise rotated 2D array of 771 x 210
+
+    @endverbatim
+
+  ***********************************************************************/
+static void rotateChannel(pixel**& channel, int rows, int cols, bool clockwise, vector<unsigned long long>& visited)
+{
+    if (rows == cols)
+    {
+        rotateSquare(channel, rows, clockwise);
+        return;
+    }
+
+    transposeInPlace(channel, rows, cols, visited);
+
+    //reverse each row
+    if (clockwise)
+    {
+        parallelFor(0, cols, [&](int rowStart, int rowEnd)
+        {
+            int i;
+
+            for (i = rowStart; i < rowEnd; i++)
+            {
+                reverse(channel[i], channel[i] + rows);
+            }
+        });
+    }
+
+    //reverse the order of the rows
+    else
+    {
+        parallelFor(0, cols / 2, [&](int rowStart, int rowEnd)
+        {
+            int i;
+
+            for (i = rowStart; i < rowEnd; i++)
+            {
+                swap_ranges(channel[i], channel[i] + rows, channel[cols - 1 - i]);
+            }
+        });
+    }
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This function takes a struct of type image as input and rotates it clockwise in place. Each of the red,
+  * green, and blue channels is rotated by rotateChannel within the memory it already has, so no temporary
+  * arrays are allocated. A square image is rotated by swapping groups of four pixels. Any other image is
+  * transposed by following the cycles of pixels that have to move, which needs a bitset of one bit per pixel,
+  * and then every row is reversed. The first row of the original image ends up at the last column of the
+  * modified image. The bitset is shared by the three channels, so the peak memory is only an eighth of a
+  * channel above the image itself. The rows and columns parameters of the strucutre are exchanged to reflect
+  * the dimensions of the new image.
+  *
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+    
+    //rotating an image of dimensions 210 x 771 clockwise
+    img.rows = 210;
+    img.cols = 771;
+
+    rotateClockwise(img);
+
+    //img now contains a clockwise image of dimensions 771 x 210.
+    //img.rows = 771;
+    //img.cols = 210;
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateClockWise(image &img)
+{
+    //bitset for the transpose
+    vector<unsigned long long> visited;
+
+    rotateChannel(img.redGray, img.rows, img.cols, true, visited);
+    rotateChannel(img.green, img.rows, img.cols, true, visited);
+    rotateChannel(img.blue, img.rows, img.cols, true, visited);
+
+    //changing the values of rows and columns
+    swap(img.rows, img.cols);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This function takes a struct of type image as input and rotates it counter clockwise in place. Each of
+  * the red, green, and blue channels is rotated by rotateChannel within the memory it already has, so no
+  * temporary arrays are allocated. A square image is rotated by swapping groups of four pixels. Any other
+  * image is transposed by following the cycles of pixels that have to move, and then the order of the rows
+  * is reversed. The first row of the original image ends up at the first column of the modified image.
+  * The rows and columns parameters of the strucutre are exchanged to reflect the dimensions of the new image.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating an image of dimensions 210 x 771 counter clockwise
+    img.rows = 210;
+    img.cols = 771;
+
+    rotateCounterClockwise(img);
+
+    //img now contains a counter clockwise image of dimensions 771 x 210.
+    //img.rows = 771;
+    //img.cols = 210;
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateCounterClockWise(image& img)
+{
+    //bitset for the transpose
+    vector<unsigned long long> visited;
+
+    rotateChannel(img.redGray, img.rows, img.cols, false, visited);
+    rotateChannel(img.green, img.rows, img.cols, false, visited);
+    rotateChannel(img.blue, img.rows, img.cols, false, visited);
+
+    //changing the values of rows and columns
+    swap(img.rows, img.cols);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
+  * dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
+  * The function checks if the memory has been allocated and exits with a zero if it did not.
+  * The dimensions of these arrays are rows x cols, since flipping on X axis does not affect dimensions.
+  * The function then proceeds to execute two loops which interchange the rows of the original
+  * image for the mirroring rows of the resulting image. The first row of the original image is now at the
+  * last row for the modified image. The mth row is now at the (rows - m)th row in the resulting image. The 
+  * values of row and column for img do not the change. The free2D function is called to delete the original 2D arrays of 
+  * the structure. They are then assigned new dimensions of cols x rows using the alloc2D function. Memory 
+  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
+  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
+  * The rows and columns parameters of the strucutre are also exchanged to reflect the dimensions of the new image.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //flipping an image of dimensions 210 x 771 on the X axis
+    img.rows = 210;
+    img.cols = 771;
+
+    flipAxisX(img);
+
+    //img now contains a flipped image on X axis of dimensions 210 x 771.
+    //img.rows = 210;
+    //img.cols = 771;
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipAxisX(image &img)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    //initializing variables
+    int rows = 0;
+    int cols = 0;
+
+    //assigning the values of rows and columns of flip X
+    rows = img.rows;
+    cols = img.cols;
+
+    //temporary 2D arrays
+    pixel** redGrayTemp = nullptr;
+    pixel** greenTemp = nullptr;
+    pixel** blueTemp = nullptr;
+
+    //allocate three new 2D arrays
+    redGrayTemp = alloc2D(rows, cols);
+    greenTemp = alloc2D(rows, cols);
+    blueTemp = alloc2D(rows, cols);
+
+    if (redGrayTemp == nullptr || greenTemp == nullptr || blueTemp == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //two for loops 
+    for (i = 0; i < img.rows; i++)
+    {
+        for (j = 0; j < img.cols; j++)
+        {
+
+            redGrayTemp[rows - i - 1][j] = img.redGray[i][j];
+            greenTemp[rows - i - 1][j] = img.green[i][j];
+            blueTemp[rows - i - 1][j] = img.blue[i][j];
+
+        }
+    }
+
+
+    //freeing up the memory allocated to img.redgray, img.green, img.blue
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+
+    //making a new size for the img pointers
+    img.redGray = alloc2D(rows, cols);
+    img.green = alloc2D(rows, cols);
+    img.blue = alloc2D(rows, cols);
+
+
+    //if memory allocation fails
+    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //assigning each value of temporary arrays to structure
+    copy2D(img.redGray, redGrayTemp, rows, cols);
+    copy2D(img.green, greenTemp, rows, cols);
+    copy2D(img.blue, blueTemp, rows, cols);
+
+    //free up the memory allocated to the temporary arrays
+    free2D(redGrayTemp, rows);
+    free2D(greenTemp, rows);
+    free2D(blueTemp, rows);
+
+    
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
+  * dynamic arrays with pixel datatype, each for red, green, and blue channels respectively.
+  * The function checks if the memory has been allocated and exits with a zero if it did not.
+  * The dimensions of these arrays are rows x cols, since flipping on Y axis does not affect dimensions.
+  * The function then proceeds to execute two loops which interchange the columns of the original
+  * image for the mirroring columns of the resulting image. The first column of the original image is now at the
+  * last column for the modified image. The nth column is now at the (cols - n)th column in the resulting image. The
+  * values of row and column for img do not the change. The free2D function is called to delete the original 2D arrays of 
+  * the structure. They are then assigned new dimensions of rows x cols using the alloc2D function. Memory 
+  * allocation success is checked for again. Then the data from the temporary arrays is copied into the newly 
+  * allocated arrays of the structure. The memory allocated to the temporary arrays is then freed up. 
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+   //flipping an image of dimensions 210 x 771 on the Y axis
+    img.rows = 210;
+    img.cols = 771;
+
+    flipAxisY(img);
+
+    //img now contains a flipped image on Y axis of dimensions 210 x 771.
+    //img.rows = 210;
+    //img.cols = 771;
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipAxisY(image& img)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    //initializing variables
+    int rows = 0;
+    int cols = 0;
+
+    //assigning the values of rows and columns of flip X
+    rows = img.rows;
+    cols = img.cols;
+
+    //temporary 2D arrays
+    pixel** redGrayTemp = nullptr;
+    pixel** greenTemp = nullptr;
+    pixel** blueTemp = nullptr;
+
+    //allocate three new 2D arrays
+    redGrayTemp = alloc2D(rows, cols);
+    greenTemp = alloc2D(rows, cols);
+    blueTemp = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if (redGrayTemp == nullptr || greenTemp == nullptr || blueTemp == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //two for loops 
+    for (i = 0; i < img.rows; i++)
+    {
+        for (j = 0; j < img.cols; j++)
+        {
+            redGrayTemp[i][cols - j -1] = img.redGray[i][j];
+            greenTemp[i][cols - j - 1] = img.green[i][j];
+            blueTemp[i][cols - j - 1] = img.blue[i][j];
+
+        }
+    }
+
+
+    //freeing up the memory allocated to img.redgray, img.green, img.blue
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+
+    //making a new size for the img pointers
+    img.redGray = alloc2D(rows, cols);
+    img.green = alloc2D(rows, cols);
+    img.blue = alloc2D(rows, cols);
+
+    //if memory allocation fails
+    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //assigning each value of temporary arrays to structure
+    copy2D(img.redGray, redGrayTemp, rows, cols);
+    copy2D(img.green, greenTemp, rows, cols);
+    copy2D(img.blue, blueTemp, rows, cols);
+
+    //free up the memory allocated to the temporary arrays
+    free2D(redGrayTemp, rows);
+    free2D(greenTemp, rows);
+    free2D(blueTemp, rows);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * The convertGrayScale function covnerts a coloured image to a grayscale image. This function takes a 
+  * struct of type image as input. The function then proceeds to execute two loops where the gray channel 
+  * is assigned a value equal to a function of the red, green, and blue channels of the image. The gray channel 
+  * equals 30% of the red channel, 60% of the green channel, and 10% of the blue channel. The value obtained 
+  * from taking fractional values of each channel is a double. Since the arrays of the structure store the pixel
+  * datatype, the double is typecasted to a pixel. The values of row and column for img do not the change. 
+  * 
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+   //grayscaling an image of dimensions 210 x 771
+    img.rows = 210;
+    img.cols = 771;
+
+    convertGrayScale(img);
+
+    //img now contains a grayscaled image of dimensions 210 x 771.
+    //img.rows = 210;
+    //img.cols = 771;
+
+    @endverbatim
+
+  ***********************************************************************/
+void convertGrayScale(image& img)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    //initializing variables
+    int rows = 0;
+    int cols = 0;
+
+    //assigning the respective values
+    rows = img.rows;
+    cols = img.cols;
+
+        
+    //looping through each element of dynamic array
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < cols; j++)
+        {
+            img.redGray[i][j] = (pixel) (0.3 * img.redGray[i][j] + 0.6 * img.green[i][j] + 0.1 * img.blue[i][j]);
+        }
+    }
+
+    
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Copies the gray channel of a grayscale image into the green and blue channels. convertGrayScale only
+  * updates the gray channel, so this is needed before anything reads all three channels of a grayscale
+  * image, or turns it into a color image. The rows are split across threads.
+  *
+  * @param[in,out] img - the grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    convertGrayScale(img);
+    spreadGray(img);
+
+    //the three channels of img are the same
+
+    @endverbatim
+
+  ***********************************************************************/
+void spreadGray(image& img)
+{
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i = 0;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            memcpy(img.green[i], img.redGray[i], img.cols);
+            memcpy(img.blue[i], img.redGray[i], img.cols);
+        }
+    });
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * The convertSepia function anitiques an image. 
+  * This function takes a struct of type image as input. It then proceeds to allocated three new temporary 2D
+  * dynamic arrays with pixel datatype. These arrays are named tr, tg, and tb respectively.
+  * The function checks if the memory has been allocated to tr, tg, and tb and exits with zero if not.
+  * The dimension of these arrays is rows x cols, since anitquing an image does not affect its dimensions.
+  * The function then proceeds to execute two loops where the tr, tg, and tb channels are assigned a value equal to
+  * a function of the red, green, and blue channels of the original image. If the value of any element of tr, 
+  * tg, or tb is greater than 255, then a value of 255 is assgined to them instead. The copy2D function is then 
+  * called to copy the values from tr, tg, and tb back into the 2D arrays of the structure. The temporary arrays 
+  * tr, tg, and tb are then freed up.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+   //antiquing an image of dimensions 210 x 771
+    img.rows = 210;
+    img.cols = 771;
+
+    convertSepia(img);
+
+    //img now contains an antiqued image of dimensions 210 x 771.
+    //img.rows = 210;
+    //img.cols = 771;
+
+    @endverbatim
+
+  ***********************************************************************/
+void convertSepia(image& img)
+{
+    //loop variables
+    int i = 0;
+    int j = 0;
+
+    //initializing variables
+    int rows = 0;
+    int cols = 0;
+
+    //more variables
+    int r, g, b;
+
+    //assigning the respective values
+    rows = img.rows;
+    cols = img.cols;
+
+    //creating a 2D pointer
+    pixel** tr = nullptr;
+    pixel** tg = nullptr;
+    pixel** tb = nullptr;
+
+    //allocating a dynamic 2D array for sepia
+    tr = alloc2D(img.rows, img.cols);
+    tg = alloc2D(img.rows, img.cols);
+    tb = alloc2D(img.rows, img.cols);
+
+    if (tr == nullptr || tg == nullptr || tb == nullptr)
+    {
+        cout << "Memory Allocation Error" << endl;
+        exit(0);
+    }
+
+    //looping through each element of dynamic array
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < cols; j++)
+        {
+            r = (int) (0.393 * img.redGray[i][j] + 0.769 * img.green[i][j] + 0.189 * img.blue[i][j]);
+            g = (int) (0.349 * img.redGray[i][j] + 0.686 * img.green[i][j] + 0.168 * img.blue[i][j]);
+            b = (int) (0.272 * img.redGray[i][j] + 0.534 * img.green[i][j] + 0.131 * img.blue[i][j]);
+
+            if (r > 255)
+            {
+                tr[i][j] = 255;
+            }
+
+            else
+            {
+                tr[i][j] = r;
+            }
+
+            if (g > 255)
+            {
+                tg[i][j] = 255;
+            }
+
+            else
+            {
+                tg[i][j] = g;
+            }
+
+            if (b > 255)
+            {
+                tb[i][j] = 255;
+            }
+
+            else
+            {
+                tb[i][j] = b;
+            }
+
+            
+        }
+    }
+
+    //assigning the values back to the original array
+    copy2D(img.redGray, tr, rows, cols);
+    copy2D(img.green, tg, rows, cols);
+    copy2D(img.blue, tb, rows, cols);
+
+    //freeing up the temporary arrays
+    free2D(tr, rows);
+    free2D(tg, rows);
+    free2D(tb, rows);
+
+
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates the pixels of the source view clockwise into the destination view. The destination
+  * must have the rows and columns of the source swapped. The rotation is done by copying through
+  * a rotated view of the source, so no temporary arrays are needed. The views must not overlap.
+  *
+  * @param[in] src - the view to rotate.
+  * @param[in] dst - the view that receives the rotated pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating a 64 x 64 region of img clockwise into tile
+    rotateClockWise(cropView(makeView(img), 0, 0, 64, 64), makeView(tile));
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateClockWise(const imageView& src, const imageView& dst)
+{
+    copyView(rotateViewCW(src), dst);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates the pixels of the source view counter clockwise into the destination view. The
+  * destination must have the rows and columns of the source swapped. The views must not overlap.
+  *
+  * @param[in] src - the view to rotate.
+  * @param[in] dst - the view that receives the rotated pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating a 64 x 64 region of img counter clockwise into tile
+    rotateCounterClockWise(cropView(makeView(img), 0, 0, 64, 64), makeView(tile));
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateCounterClockWise(const imageView& src, const imageView& dst)
+{
+    copyView(rotateViewCCW(src), dst);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Flips the pixels of the source view on the X axis into the destination view, which must have
+  * the same dimensions. The views must not overlap.
+  *
+  * @param[in] src - the view to flip.
+  * @param[in] dst - the view that receives the flipped pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //flipping the whole of img on the X axis into copy
+    flipAxisX(makeView(img), makeView(copy));
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipAxisX(const imageView& src, const imageView& dst)
+{
+    copyView(flipViewX(src), dst);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Flips the pixels of the source view on the Y axis into the destination view, which must have
+  * the same dimensions. The views must not overlap.
+  *
+  * @param[in] src - the view to flip.
+  * @param[in] dst - the view that receives the flipped pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //flipping the whole of img on the Y axis into copy
+    flipAxisY(makeView(img), makeView(copy));
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipAxisY(const imageView& src, const imageView& dst)
+{
+    copyView(flipViewY(src), dst);
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts the pixels of the source view to grayscale and stores them in the destination view,
+  * which must have the same dimensions. The same weights as convertGrayScale are used. Unlike
+  * convertGrayScale the gray value is stored in all three channels, so that a grayscale region
+  * looks gray in a color image. The source and destination may be the same view.
+  *
+  * @param[in] src - the view to convert.
+  * @param[in] dst - the view that receives the gray pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //graying out a region of img in place
+    imageView region = cropView(makeView(img), 10, 10, 100, 50);
+
+    convertGrayScale(region, region);
+
+    @endverbatim
+
+  ***********************************************************************/
+void convertGrayScale(const imageView& src, const imageView& dst)
+{
+    if (src.rows != dst.rows || src.cols != dst.cols)
+    {
+        cout << "Image Dimensions Do Not Match" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, src.rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j;
+        ptrdiff_t s, d;
+        pixel gray;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            for (j = 0; j < src.cols; j++)
+            {
+                s = i * src.rowStride + j * src.colStride;
+                d = i * dst.rowStride + j * dst.colStride;
+
+                gray = (pixel)(0.3 * src.red[s] + 0.6 * src.green[s] + 0.1 * src.blue[s]);
+
+                dst.red[d] = gray;
+                dst.green[d] = gray;
+                dst.blue[d] = gray;
+            }
+        }
+    });
+}
+
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Antiques the pixels of the source view and stores them in the destination view, which must
+  * have the same dimensions. The same weights and clamping as convertSepia are used. Each pixel
+  * is read before it is written, so the source and destination may be the same view and no
+  * temporary arrays are needed.
+  *
+  * @param[in] src - the view to antique.
+  * @param[in] dst - the view that receives the antiqued pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //antiquing a region of img in place
+    imageView region = cropView(makeView(img), 10, 10, 100, 50);
+
+    convertSepia(region, region);
+
+    @endverbatim
+
+  ***********************************************************************/
+void convertSepia(const imageView& src, const imageView& dst)
+{
+    if (src.rows != dst.rows || src.cols != dst.cols)
+    {
+        cout << "Image Dimensions Do Not Match" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, src.rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j, r, g, b;
+        ptrdiff_t s, d;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            for (j = 0; j < src.cols; j++)
+            {
+                s = i * src.rowStride + j * src.colStride;
+                d = i * dst.rowStride + j * dst.colStride;
+
+                r = (int) (0.393 * src.red[s] + 0.769 * src.green[s] + 0.189 * src.blue[s]);
+                g = (int) (0.349 * src.red[s] + 0.686 * src.green[s] + 0.168 * src.blue[s]);
+                b = (int) (0.272 * src.red[s] + 0.534 * src.green[s] + 0.131 * src.blue[s]);
+
+                dst.red[d] = (pixel)min(r, 255);
+                dst.green[d] = (pixel)min(g, 255);
+                dst.blue[d] = (pixel)min(b, 255);
+            }
+        }
+    });
+}
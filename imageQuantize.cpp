@@ -0,0 +1,1053 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that reduce images to a small palette of colors, with or without dithering
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of bits of each channel that pick a cell of the color lookup table, and a bin of the
+ *        histogram when the image has too many colors to count each one.
+ */
+const int QUANT_BITS = 5;
+
+/**
+ * @brief Number of cells of the color lookup table, and the most bins the histogram has.
+ */
+const int QUANT_BINS = 1 << (3 * QUANT_BITS);
+
+/**
+ * @brief The most different colors the histogram counts one by one. An image with more is counted in
+ *        bins of QUANT_BITS bits per channel, so that median cut and k-means stay fast.
+ */
+const size_t QUANT_EXACT = 4096;
+
+/**
+ * @brief The histogram is built from at most about this many pixels, spread evenly over the image.
+ */
+const long long QUANT_SAMPLES = 1 << 20;
+
+/**
+ * @brief Number of k-means passes that refine the median cut palette.
+ */
+const int KMEANS_ITERATIONS = 4;
+
+/**
+ * @brief Number of columns a row of Floyd-Steinberg dithering finishes before it tells the next row.
+ */
+const int FLOYD_BLOCK = 64;
+
+/**
+ * @brief The 8 x 8 Bayer matrix. Each value from 0 to 63 appears once, spread as evenly as possible.
+ */
+static const unsigned char BAYER[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 } };
+
+
+/**
+ * @brief A bin of the color histogram: the number of sampled pixels that fell into it and the sum
+ *        of their values, so the mean color of the bin is known exactly.
+ */
+struct colorBin
+{
+    unsigned long long count = 0;       /**< Number of pixels in the bin. */
+    unsigned long long sum[3] = {};     /**< Sum of the red, green, and blue values of the pixels. */
+};
+
+
+/**
+ * @brief The palette colors that can be the closest to a color of each cell of the lookup table. A
+ *        pixel is compared with the few candidates of its cell at full precision, so it gets exactly
+ *        the closest color of the palette without a search of the whole palette.
+ */
+struct colorLookup
+{
+    vector<int> first;                  /**< Where the candidates of each cell start, and where the last ends. */
+    vector<unsigned char> candidates;   /**< The candidates of every cell, closest to the cell first. */
+    vector<int> nearest;                /**< The squared distance of each candidate from its cell. */
+    int colors[256][3] = {};            /**< The palette colors. */
+};
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the bin of the histogram and the lookup table that a color falls into, from the top
+  * QUANT_BITS bits of each channel.
+  *
+  * @param[in] r - the red value.
+  * @param[in] g - the green value.
+  * @param[in] b - the blue value.
+  *
+  * @returns the index of the bin
+  *
+  * @par Example:
+    @verbatim
+
+    int bin = colorBinOf(255, 0, 0);
+
+    //bin is 31 << 10
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline int colorBinOf(int r, int g, int b)
+{
+    return (r >> (8 - QUANT_BITS)) << (2 * QUANT_BITS) | (g >> (8 - QUANT_BITS)) << QUANT_BITS | b >> (8 - QUANT_BITS);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the index of the palette color closest to a color, by squared distance.
+  *
+  * @param[in] palette - the colors, red, green, and blue for each.
+  * @param[in] c - the color.
+  *
+  * @returns the index of the closest color
+  *
+  * @par Example:
+    @verbatim
+
+    double c[3] = { 250, 10, 10 };
+
+    int k = nearestColor(palette, c);
+
+    //palette[3 * k] to palette[3 * k + 2] is the reddest color of the palette
+
+    @endverbatim
+
+  ***********************************************************************/
+static int nearestColor(const vector<double>& palette, const double c[3])
+{
+    //loop variable
+    size_t k = 0;
+
+    int best = 0;
+    double bestDistance = 1e300;
+    double d = 0;
+    double dr, dg, db;
+
+    for (k = 0; k < palette.size() / 3; k++)
+    {
+        dr = c[0] - palette[3 * k];
+        dg = c[1] - palette[3 * k + 1];
+        db = c[2] - palette[3 * k + 2];
+        d = dr * dr + dg * dg + db * db;
+
+        if (d < bestDistance)
+        {
+            bestDistance = d;
+            best = (int)k;
+        }
+    }
+
+    return best;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Counts the colors of an evenly spaced sample of at most about QUANT_SAMPLES pixels into a histogram.
+  * The colors of the sample are gathered in parallel and grouped into bins by the top QUANT_BITS bits
+  * of each channel. If that leaves few enough bins, the colors are sorted with a radix sort, 8 bits at
+  * a time, and if there are at most QUANT_EXACT different colors each becomes a bin of its own, so
+  * median cut can split any two colors apart, as it must for a palette of 256 grays. Only bins with
+  * pixels are kept, in order of color, so the histogram does not depend on the number of threads.
+  *
+  * @param[in] img - the image.
+  * @param[out] bins - the histogram.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<colorBin> bins;
+
+    sampleHistogram(img, bins);
+
+    //an image of 256 gray levels has 256 bins
+
+    @endverbatim
+
+  ***********************************************************************/
+static void sampleHistogram(image& img, vector<colorBin>& bins)
+{
+    //loop variables
+    size_t s = 0;
+    int pass = 0;
+    int d = 0;
+    int c = 0;
+
+    long long pixels = (long long)img.rows * img.cols;
+    long long step = max(1LL, pixels / QUANT_SAMPLES);
+    long long samples = (pixels + step - 1) / step;
+    size_t offsets[256];
+    size_t total = 0;
+    size_t distinct = 0;
+    unsigned int color = 0;
+
+    vector<unsigned int> colors((size_t)samples);
+    vector<unsigned int> sorted;
+    vector<colorBin> grouped(QUANT_BINS);
+
+    parallelFor(0, (int)samples, [&](int sampleStart, int sampleEnd)
+    {
+        int k = 0;
+        long long p = 0;
+        int i = 0;
+        int j = 0;
+
+        for (k = sampleStart; k < sampleEnd; k++)
+        {
+            p = k * step;
+            i = (int)(p / img.cols);
+            j = (int)(p % img.cols);
+
+            colors[k] = (unsigned int)img.redGray[i][j] << 16 | (unsigned int)img.green[i][j] << 8 | img.blue[i][j];
+        }
+    });
+
+    //the colors grouped by the top bits of each channel
+    for (s = 0; s < colors.size(); s++)
+    {
+        color = colors[s];
+        d = colorBinOf(color >> 16, (color >> 8) & 0xff, color & 0xff);
+
+        grouped[d].count++;
+        grouped[d].sum[0] += color >> 16;
+        grouped[d].sum[1] += (color >> 8) & 0xff;
+        grouped[d].sum[2] += color & 0xff;
+    }
+
+    bins.clear();
+
+    for (d = 0; d < QUANT_BINS; d++)
+    {
+        if (grouped[d].count > 0)
+        {
+            bins.push_back(grouped[d]);
+        }
+    }
+
+    //too many colors to count one by one
+    if (bins.size() > QUANT_EXACT)
+    {
+        return;
+    }
+
+    //sorted by blue, then green, then red
+    sorted.resize(colors.size());
+
+    for (pass = 0; pass < 3; pass++)
+    {
+        fill(offsets, offsets + 256, (size_t)0);
+
+        for (s = 0; s < colors.size(); s++)
+        {
+            offsets[(colors[s] >> (8 * pass)) & 0xff]++;
+        }
+
+        total = 0;
+
+        for (d = 0; d < 256; d++)
+        {
+            swap(total, offsets[d]);
+            total += offsets[d];
+        }
+
+        for (s = 0; s < colors.size(); s++)
+        {
+            sorted[offsets[(colors[s] >> (8 * pass)) & 0xff]++] = colors[s];
+        }
+
+        colors.swap(sorted);
+    }
+
+    for (s = 0; s < colors.size(); s++)
+    {
+        distinct += s == 0 || colors[s] != colors[s - 1] ? 1 : 0;
+    }
+
+    if (distinct > QUANT_EXACT)
+    {
+        return;
+    }
+
+    //a bin for each different color
+    bins.clear();
+
+    for (s = 0; s < colors.size(); s++)
+    {
+        color = colors[s];
+
+        if (s == 0 || color != colors[s - 1])
+        {
+            bins.push_back(colorBin());
+        }
+
+        bins.back().count++;
+
+        for (c = 0; c < 3; c++)
+        {
+            bins.back().sum[c] += (color >> (16 - 8 * c)) & 0xff;
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Builds a palette of at most colors colors for the image. The colors of a sample of pixels are
+  * counted into a histogram, and median cut splits the colors of the histogram into boxes: the box
+  * with the widest range in any channel is sorted along that channel and cut where half of its pixels
+  * are on each side, until there are enough boxes or none can be cut. The mean of each box is a color
+  * of the palette. KMEANS_ITERATIONS passes of k-means then move each color to the mean of the bins
+  * closest to it, which lowers the error of the palette further.
+  *
+  * @param[in] img - the image.
+  * @param[in] colors - the largest number of colors, 1 or more.
+  * @param[out] palette - the colors, red, green, and blue for each.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<double> palette;
+
+    buildPalette(img, 16, palette);
+
+    //palette holds 16 colors, or fewer if the image has fewer
+
+    @endverbatim
+
+  ***********************************************************************/
+void buildPalette(image& img, int colors, vector<double>& palette)
+{
+    //loop variables
+    size_t k = 0;
+    size_t b = 0;
+    int c = 0;
+    int pass = 0;
+
+    vector<colorBin> bins;
+    vector<pair<size_t, size_t>> boxes;
+    vector<colorBin> clusters;
+
+    size_t widest = 0;
+    int widestChannel = 0;
+    double widestRange = 0;
+    double lo[3], hi[3], mean[3];
+    size_t start, end, cut;
+    unsigned long long half, seen;
+
+    //the mean color of a bin
+    auto binMean = [](const colorBin& bin, int channel)
+    {
+        return (double)bin.sum[channel] / bin.count;
+    };
+
+    sampleHistogram(img, bins);
+
+    //median cut, starting with one box of every bin
+    boxes.push_back(make_pair((size_t)0, bins.size()));
+
+    while ((int)boxes.size() < colors)
+    {
+        widestRange = 0;
+
+        for (k = 0; k < boxes.size(); k++)
+        {
+            for (c = 0; c < 3; c++)
+            {
+                lo[c] = 256;
+                hi[c] = -1;
+            }
+
+            for (b = boxes[k].first; b < boxes[k].second; b++)
+            {
+                for (c = 0; c < 3; c++)
+                {
+                    lo[c] = min(lo[c], binMean(bins[b], c));
+                    hi[c] = max(hi[c], binMean(bins[b], c));
+                }
+            }
+
+            for (c = 0; c < 3; c++)
+            {
+                if (boxes[k].second - boxes[k].first > 1 && hi[c] - lo[c] > widestRange)
+                {
+                    widestRange = hi[c] - lo[c];
+                    widest = k;
+                    widestChannel = c;
+                }
+            }
+        }
+
+        //every box is a single color
+        if (widestRange == 0)
+        {
+            break;
+        }
+
+        start = boxes[widest].first;
+        end = boxes[widest].second;
+        c = widestChannel;
+
+        sort(bins.begin() + start, bins.begin() + end, [&](const colorBin& x, const colorBin& y)
+        {
+            return binMean(x, c) < binMean(y, c);
+        });
+
+        //half of the pixels of the box on each side, and at least one bin
+        half = 0;
+
+        for (b = start; b < end; b++)
+        {
+            half += bins[b].count;
+        }
+
+        half /= 2;
+        seen = 0;
+
+        for (cut = start; cut < end - 1; cut++)
+        {
+            seen += bins[cut].count;
+
+            if (seen >= half)
+            {
+                break;
+            }
+        }
+
+        cut++;
+
+        boxes[widest].second = cut;
+        boxes.push_back(make_pair(cut, end));
+    }
+
+    //the mean of each box
+    palette.clear();
+
+    for (k = 0; k < boxes.size(); k++)
+    {
+        half = 0;
+        mean[0] = mean[1] = mean[2] = 0;
+
+        for (b = boxes[k].first; b < boxes[k].second; b++)
+        {
+            half += bins[b].count;
+
+            for (c = 0; c < 3; c++)
+            {
+                mean[c] += bins[b].sum[c];
+            }
+        }
+
+        for (c = 0; c < 3; c++)
+        {
+            palette.push_back(half > 0 ? mean[c] / half : 0);
+        }
+    }
+
+    //k-means, each color moves to the mean of the bins closest to it
+    for (pass = 0; pass < KMEANS_ITERATIONS; pass++)
+    {
+        clusters.assign(palette.size() / 3, colorBin());
+
+        for (b = 0; b < bins.size(); b++)
+        {
+            for (c = 0; c < 3; c++)
+            {
+                mean[c] = binMean(bins[b], c);
+            }
+
+            k = nearestColor(palette, mean);
+            clusters[k].count += bins[b].count;
+
+            for (c = 0; c < 3; c++)
+            {
+                clusters[k].sum[c] += bins[b].sum[c];
+            }
+        }
+
+        for (k = 0; k < clusters.size(); k++)
+        {
+            for (c = 0; c < 3 && clusters[k].count > 0; c++)
+            {
+                palette[3 * k + c] = binMean(clusters[k], c);
+            }
+        }
+    }
+
+    for (k = 0; k < palette.size(); k++)
+    {
+        palette[k] = floor(palette[k] + 0.5);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Builds the lookup table of the palette. Every cell of the table covers the colors with the same top
+  * QUANT_BITS bits in each channel. Of the palette colors, the one whose farthest distance from the
+  * cell is smallest bounds how far the closest color of any color in the cell can be, and only the
+  * colors whose nearest distance from the cell is within that bound are kept as candidates of the
+  * cell, closest to the cell first. The distances are added up from tables of each channel, and the
+  * cells are split across threads, once to count the candidates and once to store them.
+  *
+  * @param[in] palette - the colors, red, green, and blue for each.
+  * @param[out] lookup - the candidates of each cell.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    buildLookup(palette, lookup);
+
+    k = lookupColor(lookup, r, g, b);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void buildLookup(const vector<double>& palette, colorLookup& lookup)
+{
+    //loop variables
+    int k = 0;
+    int c = 0;
+    int v = 0;
+    int b = 0;
+
+    int count = (int)palette.size() / 3;
+    int side = 1 << QUANT_BITS;
+    int low = 0;
+    int high = 0;
+    int near = 0;
+    int far = 0;
+
+    //the nearest and farthest squared distance of each color from each cell along each channel
+    vector<int> nearTable[3];
+    vector<int> farTable[3];
+
+    //the largest squared distance a color of each cell can have from its closest palette color
+    vector<int> bound(QUANT_BINS);
+
+    for (k = 0; k < count; k++)
+    {
+        for (c = 0; c < 3; c++)
+        {
+            lookup.colors[k][c] = (int)palette[3 * k + c];
+        }
+    }
+
+    for (c = 0; c < 3; c++)
+    {
+        nearTable[c].resize((size_t)side * count);
+        farTable[c].resize((size_t)side * count);
+
+        for (v = 0; v < side; v++)
+        {
+            low = v << (8 - QUANT_BITS);
+            high = low + (1 << (8 - QUANT_BITS)) - 1;
+
+            for (k = 0; k < count; k++)
+            {
+                near = max(0, max(low - lookup.colors[k][c], lookup.colors[k][c] - high));
+                far = max(abs(lookup.colors[k][c] - low), abs(lookup.colors[k][c] - high));
+
+                nearTable[c][v * count + k] = near * near;
+                farTable[c][v * count + k] = far * far;
+            }
+        }
+    }
+
+    lookup.first.assign(QUANT_BINS + 1, 0);
+
+    parallelFor(0, QUANT_BINS, [&](int cellStart, int cellEnd)
+    {
+        int cell = 0;
+        int m = 0;
+        const int* nearRow[3];
+        const int* farRow[3];
+
+        for (cell = cellStart; cell < cellEnd; cell++)
+        {
+            for (m = 0; m < 3; m++)
+            {
+                nearRow[m] = nearTable[m].data() + ((cell >> ((2 - m) * QUANT_BITS)) & (side - 1)) * count;
+                farRow[m] = farTable[m].data() + ((cell >> ((2 - m) * QUANT_BITS)) & (side - 1)) * count;
+            }
+
+            bound[cell] = INT_MAX;
+
+            for (m = 0; m < count; m++)
+            {
+                bound[cell] = min(bound[cell], farRow[0][m] + farRow[1][m] + farRow[2][m]);
+            }
+
+            for (m = 0; m < count; m++)
+            {
+                lookup.first[cell + 1] += nearRow[0][m] + nearRow[1][m] + nearRow[2][m] <= bound[cell] ? 1 : 0;
+            }
+        }
+    });
+
+    for (b = 0; b < QUANT_BINS; b++)
+    {
+        lookup.first[b + 1] += lookup.first[b];
+    }
+
+    lookup.candidates.resize(lookup.first[QUANT_BINS]);
+    lookup.nearest.resize(lookup.first[QUANT_BINS]);
+
+    parallelFor(0, QUANT_BINS, [&](int cellStart, int cellEnd)
+    {
+        int cell = 0;
+        int m = 0;
+        int d = 0;
+        const int* nearRow[3];
+
+        vector<pair<int, int>> found;
+
+        for (cell = cellStart; cell < cellEnd; cell++)
+        {
+            for (m = 0; m < 3; m++)
+            {
+                nearRow[m] = nearTable[m].data() + ((cell >> ((2 - m) * QUANT_BITS)) & (side - 1)) * count;
+            }
+
+            found.clear();
+
+            for (m = 0; m < count; m++)
+            {
+                d = nearRow[0][m] + nearRow[1][m] + nearRow[2][m];
+
+                if (d <= bound[cell])
+                {
+                    found.push_back(make_pair(d, m));
+                }
+            }
+
+            sort(found.begin(), found.end());
+
+            for (m = 0; m < (int)found.size(); m++)
+            {
+                lookup.nearest[lookup.first[cell] + m] = found[m].first;
+                lookup.candidates[lookup.first[cell] + m] = (unsigned char)found[m].second;
+            }
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the index of the palette color closest to a color, by squared distance, from the candidates
+  * of its cell of the lookup table. The candidates are tried closest to the cell first, and once a
+  * candidate is farther from the cell than the best color is from the pixel, no later one can be
+  * closer. Of equally close colors the first in the palette is returned, as nearestColor does.
+  *
+  * @param[in] lookup - the lookup table from buildLookup.
+  * @param[in] r - the red value.
+  * @param[in] g - the green value.
+  * @param[in] b - the blue value.
+  *
+  * @returns the index of the closest color
+  *
+  * @par Example:
+    @verbatim
+
+    index = lookupColor(lookup, 250, 10, 10);
+
+    //the reddest color of the palette
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline int lookupColor(const colorLookup& lookup, int r, int g, int b)
+{
+    //loop variable
+    int k = 0;
+
+    int cell = colorBinOf(r, g, b);
+    int best = 0;
+    int bestDistance = INT_MAX;
+    int index = 0;
+    int d = 0;
+    const int* color = nullptr;
+
+    for (k = lookup.first[cell]; k < lookup.first[cell + 1] && lookup.nearest[k] <= bestDistance; k++)
+    {
+        index = lookup.candidates[k];
+        color = lookup.colors[index];
+        d = (r - color[0]) * (r - color[0]) + (g - color[1]) * (g - color[1]) + (b - color[2]) * (b - color[2]);
+
+        if (d < bestDistance || (d == bestDistance && index < best))
+        {
+            bestDistance = d;
+            best = index;
+        }
+    }
+
+    return best;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns how far the colors of a palette are apart in each channel: for each color the closest other
+  * color is found, and the largest difference of any channel between the two is averaged over the
+  * palette. Ordered dithering moves every channel over this range, so that neighbouring pixels are
+  * pushed to different colors just often enough to average out to the original.
+  *
+  * @param[in] palette - the colors, red, green, and blue for each.
+  *
+  * @returns the mean difference, 0 for a single color
+  *
+  * @par Example:
+    @verbatim
+
+    //a palette of black and white
+    double spread = paletteSpread(palette);
+
+    //spread is 255
+
+    @endverbatim
+
+  ***********************************************************************/
+static double paletteSpread(const vector<double>& palette)
+{
+    //loop variables
+    size_t k = 0;
+    size_t m = 0;
+
+    size_t count = palette.size() / 3;
+    double total = 0;
+    double closest = 0;
+    double gap = 0;
+    double d = 0;
+
+    if (count < 2)
+    {
+        return 0;
+    }
+
+    for (k = 0; k < count; k++)
+    {
+        closest = 1e300;
+
+        for (m = 0; m < count; m++)
+        {
+            d = pow(palette[3 * k] - palette[3 * m], 2) + pow(palette[3 * k + 1] - palette[3 * m + 1], 2) +
+                pow(palette[3 * k + 2] - palette[3 * m + 2], 2);
+
+            if (m != k && d < closest)
+            {
+                closest = d;
+                gap = max(fabs(palette[3 * k] - palette[3 * m]), max(fabs(palette[3 * k + 1] - palette[3 * m + 1]),
+                    fabs(palette[3 * k + 2] - palette[3 * m + 2])));
+            }
+        }
+
+        total += gap;
+    }
+
+    return total / count;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Maps every pixel to a palette color with ordered dithering. Before the lookup each pixel is moved
+  * by an amount from the 8 x 8 Bayer matrix at its position, scaled to the spread of the palette, so
+  * a flat area becomes a fixed pattern of the colors around it. Every pixel depends only on its own
+  * value and position, so the rows are split across threads and the offsets of a row are added in a
+  * plain loop the compiler can vectorize. With no offsets this is mapping to the closest color.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] palette - the colors, red, green, and blue for each.
+  * @param[in] lookup - the lookup table of the palette.
+  * @param[in] spread - how far the offsets reach, 0 for no dithering.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ditherOrdered(img, palette, lookup, paletteSpread(palette));
+
+    @endverbatim
+
+  ***********************************************************************/
+static void ditherOrdered(image& img, const vector<double>& palette, const colorLookup& lookup, double spread)
+{
+    //loop variable
+    int k = 0;
+
+    //the offset of each position of the matrix, centered on 0
+    int offsets[8][8];
+    pixel colors[256][3];
+
+    for (k = 0; k < 64; k++)
+    {
+        offsets[k / 8][k % 8] = (int)floor(spread * ((BAYER[k / 8][k % 8] + 0.5) / 64 - 0.5) + 0.5);
+    }
+
+    for (k = 0; k < (int)palette.size() / 3; k++)
+    {
+        colors[k][0] = (pixel)palette[3 * k];
+        colors[k][1] = (pixel)palette[3 * k + 1];
+        colors[k][2] = (pixel)palette[3 * k + 2];
+    }
+
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i = 0;
+        int j = 0;
+        int c = 0;
+        int index = 0;
+        const int* row = nullptr;
+
+        vector<int> moved[3];
+        pixel* planes[3];
+
+        for (c = 0; c < 3; c++)
+        {
+            moved[c].resize(img.cols);
+        }
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            row = offsets[i % 8];
+            planes[0] = img.redGray[i];
+            planes[1] = img.green[i];
+            planes[2] = img.blue[i];
+
+            for (c = 0; c < 3; c++)
+            {
+                for (j = 0; j < img.cols; j++)
+                {
+                    moved[c][j] = min(255, max(0, planes[c][j] + row[j % 8]));
+                }
+            }
+
+            for (j = 0; j < img.cols; j++)
+            {
+                index = lookupColor(lookup, moved[0][j], moved[1][j], moved[2][j]);
+
+                for (c = 0; c < 3; c++)
+                {
+                    planes[c][j] = colors[index][c];
+                }
+            }
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Maps every pixel to a palette color with Floyd-Steinberg error diffusion. The difference between
+  * each pixel and its color is passed on, 7/16 to the pixel on its right and 3/16, 5/16, and 1/16 to the
+  * three pixels below it. A pixel needs the error of the three pixels above it, so a row can run as soon
+  * as the row above is two columns ahead of it. The rows are dealt out to the threads in turn, and each
+  * row waits on the number of columns the row above has finished, which that row publishes every
+  * FLOYD_BLOCK columns, so all the threads work at once on a diagonal wavefront. The errors are summed
+  * in the same order whatever the number of threads, so the result is always the same. The errors for
+  * a row are kept in a ring with a row for each thread and two spare, which are never in use twice at
+  * the same time.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] palette - the colors, red, green, and blue for each.
+  * @param[in] lookup - the lookup table of the palette.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ditherFloyd(img, palette, lookup);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void ditherFloyd(image& img, const vector<double>& palette, const colorLookup& lookup)
+{
+    //loop variable
+    int t = 0;
+
+    int threads = max(1, min(threadCount(), img.rows));
+    int ring = threads + 2;
+
+    //the errors passed down to each row, in sixteenths, three channels per column with a column on each side
+    vector<vector<int>> below(ring, vector<int>((size_t)(img.cols + 2) * 3, 0));
+    vector<atomic<int>> finished(img.rows);
+    vector<thread> workers;
+
+    for (t = 0; t < img.rows; t++)
+    {
+        finished[t].store(0);
+    }
+
+    auto dither = [&](int first)
+    {
+        int i = 0;
+        int j = 0;
+        int c = 0;
+        int index = 0;
+        int need = 0;
+        int value[3];
+        int error[3];
+        int right[3];
+
+        int* current = nullptr;
+        int* next = nullptr;
+        pixel* planes[3];
+
+        for (i = first; i < img.rows; i += threads)
+        {
+            current = below[i % ring].data() + 3;
+            next = below[(i + 1) % ring].data() + 3;
+            planes[0] = img.redGray[i];
+            planes[1] = img.green[i];
+            planes[2] = img.blue[i];
+
+            fill(below[(i + 1) % ring].begin(), below[(i + 1) % ring].end(), 0);
+            right[0] = right[1] = right[2] = 0;
+
+            for (j = 0; j < img.cols; j++)
+            {
+                //the row above must be past the pixel up and to the right
+                if (i > 0 && j % FLOYD_BLOCK == 0)
+                {
+                    need = min(img.cols, j + FLOYD_BLOCK + 1);
+
+                    while (finished[i - 1].load(memory_order_acquire) < need)
+                    {
+                        this_thread::yield();
+                    }
+                }
+
+                for (c = 0; c < 3; c++)
+                {
+                    value[c] = min(255, max(0, planes[c][j] + ((right[c] + current[3 * j + c] + 8) >> 4)));
+                }
+
+                index = lookupColor(lookup, value[0], value[1], value[2]);
+
+                for (c = 0; c < 3; c++)
+                {
+                    planes[c][j] = (pixel)palette[3 * index + c];
+                    error[c] = value[c] - planes[c][j];
+
+                    right[c] = 7 * error[c];
+                    next[3 * (j - 1) + c] += 3 * error[c];
+                    next[3 * j + c] += 5 * error[c];
+                    next[3 * (j + 1) + c] += error[c];
+                }
+
+                if ((j + 1) % FLOYD_BLOCK == 0 || j == img.cols - 1)
+                {
+                    finished[i].store(j + 1, memory_order_release);
+                }
+            }
+        }
+    };
+
+    for (t = 1; t < threads; t++)
+    {
+        workers.emplace_back(dither, t);
+    }
+
+    dither(0);
+
+    for (t = 0; t < (int)workers.size(); t++)
+    {
+        workers[t].join();
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reduces the image to a palette of at most colors colors built by buildPalette. Each pixel is mapped
+  * to the closest color, or dithered with the 8 x 8 Bayer matrix or with Floyd-Steinberg error diffusion,
+  * which keep the average color of an area close to the original at the cost of a pattern or some noise.
+  * A grayscale image only has its gray channel up to date, so it is copied into the other two first,
+  * and the palette is then made of grays.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] colors - the largest number of colors, from 2 to 256.
+  * @param[in] method - DITHER_NONE, DITHER_BAYER, or DITHER_FLOYD.
+  * @param[in] channels - the number of channels, 3 or 1 for a grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    quantizeImage(img, 16, DITHER_FLOYD, 3);
+
+    //img has at most 16 different colors
+
+    @endverbatim
+
+  ***********************************************************************/
+void quantizeImage(image& img, int colors, ditherMethod method, int channels)
+{
+    vector<double> palette;
+    colorLookup lookup;
+
+    if (img.rows == 0 || img.cols == 0)
+    {
+        return;
+    }
+
+    if (channels == 1)
+    {
+        spreadGray(img);
+    }
+
+    buildPalette(img, colors, palette);
+    buildLookup(palette, lookup);
+
+    if (method == DITHER_FLOYD)
+    {
+        ditherFloyd(img, palette, lookup);
+    }
+
+    else
+    {
+        ditherOrdered(img, palette, lookup, method == DITHER_BAYER ? paletteSpread(palette) : 0);
+    }
+}
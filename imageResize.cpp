@@ -0,0 +1,774 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that resize images and generate thumbnails
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of fractional bits in the fixed point filter weights.
+ */
+const int RESIZE_PRECISION = 14;
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the filters are applied one sample at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESIZE_SSE2
+#endif
+
+
+/**
+ * @brief The filter weights that produce a single output row or column.
+ */
+struct resizeWeights
+{
+    int start;              /**< First source row or column that contributes. */
+    vector<int> weights;    /**< Fixed point weight of each contributing source sample. */
+    vector<short> narrow;   /**< The same weights in 16 bits for SSE2, empty if one does not fit. */
+};
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Evaluates the resampling filter at a distance x from the center of the output sample.
+  * The box filter is 1 inside half a sample and 0 outside. The bilinear filter falls off
+  * linearly to 0 one sample away. The Lanczos-3 filter is a sinc windowed by a wider sinc
+  * and reaches 0 three samples away.
+  *
+  * @param[in] filter - the filter to evaluate.
+  * @param[in] x - the distance from the center of the output sample in source samples.
+  *
+  * @returns the unnormalized weight of the filter at x
+  *
+  * @par Example:
+    @verbatim
+
+    double w = filterWeight(FILTER_BILINEAR, 0.25);
+
+    //w is 0.75
+
+    @endverbatim
+
+  ***********************************************************************/
+static double filterWeight(resizeFilter filter, double x)
+{
+    const double pi = 3.14159265358979323846;
+
+    if (x < 0)
+    {
+        x = -x;
+    }
+
+    if (filter == FILTER_BOX)
+    {
+        return x <= 0.5 ? 1.0 : 0.0;
+    }
+
+    if (filter == FILTER_BILINEAR)
+    {
+        return x < 1.0 ? 1.0 - x : 0.0;
+    }
+
+    //lanczos-3
+    if (x < 1e-8)
+    {
+        return 1.0;
+    }
+
+    if (x >= 3.0)
+    {
+        return 0.0;
+    }
+
+    return 3.0 * sin(pi * x) * sin(pi * x / 3.0) / (pi * pi * x * x);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns how far the filter reaches from the center of an output sample, in output samples.
+  *
+  * @param[in] filter - the filter that is used.
+  *
+  * @returns the support radius of the filter
+  *
+  * @par Example:
+    @verbatim
+
+    double s = filterSupport(FILTER_LANCZOS3);
+
+    //s is 3.0
+
+    @endverbatim
+
+  ***********************************************************************/
+static double filterSupport(resizeFilter filter)
+{
+    if (filter == FILTER_BOX)
+    {
+        return 0.5;
+    }
+
+    if (filter == FILTER_BILINEAR)
+    {
+        return 1.0;
+    }
+
+    return 3.0;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Precomputes the weights for every output sample of one resize pass. When downscaling, the
+  * filter is stretched by the scale factor so that every source sample contributes to the output.
+  * The weights of each output sample are normalized so that they add up to one, and are then
+  * converted to fixed point with RESIZE_PRECISION fractional bits. Any rounding error is added to
+  * the largest weight so the fixed point weights add up to exactly one as well, which keeps flat
+  * areas of the image flat. The weights are also kept in 16 bits when they all fit, which lets SSE2
+  * multiply and add pairs of them at once.
+  *
+  * @param[in] inSize - the number of source rows or columns.
+  * @param[in] outSize - the number of output rows or columns.
+  * @param[in] filter - the filter that is used.
+  *
+  * @returns one set of weights for each output row or column
+  *
+  * @par Example:
+    @verbatim
+
+    vector<resizeWeights> w = computeWeights(771, 200, FILTER_LANCZOS3);
+
+    //w[j] contains the source columns and weights of output column j
+
+    @endverbatim
+
+  ***********************************************************************/
+static vector<resizeWeights> computeWeights(int inSize, int outSize, resizeFilter filter)
+{
+    //loop variables
+    int i = 0;
+    int k = 0;
+
+    vector<resizeWeights> result(outSize);
+    vector<double> w;
+
+    double scale = (double)inSize / outSize;
+    double filterScale = scale > 1.0 ? scale : 1.0;
+    double support = filterSupport(filter) * filterScale;
+    double center = 0;
+    double total = 0;
+
+    int first = 0;
+    int last = 0;
+    int sum = 0;
+    int largest = 0;
+    bool fits = false;
+
+    for (i = 0; i < outSize; i++)
+    {
+        center = (i + 0.5) * scale;
+
+        first = (int)(center - support + 0.5);
+        last = (int)(center + support + 0.5);
+
+        if (first < 0)
+        {
+            first = 0;
+        }
+
+        if (last > inSize)
+        {
+            last = inSize;
+        }
+
+        if (last <= first)
+        {
+            last = first + 1;
+        }
+
+        //weights of the contributing source samples
+        w.assign(last - first, 0.0);
+        total = 0;
+
+        for (k = 0; k < last - first; k++)
+        {
+            w[k] = filterWeight(filter, (first + k + 0.5 - center) / filterScale);
+            total += w[k];
+        }
+
+        //convert to fixed point
+        result[i].start = first;
+        result[i].weights.assign(last - first, 0);
+        sum = 0;
+        largest = 0;
+
+        for (k = 0; k < last - first; k++)
+        {
+            if (total != 0)
+            {
+                result[i].weights[k] = (int)lround(w[k] / total * (1 << RESIZE_PRECISION));
+            }
+
+            sum += result[i].weights[k];
+
+            if (result[i].weights[k] > result[i].weights[largest])
+            {
+                largest = k;
+            }
+        }
+
+        result[i].weights[largest] += (1 << RESIZE_PRECISION) - sum;
+
+        //16 bit copy, the weights near the edges can grow past it when the total is small
+        fits = true;
+
+        for (k = 0; k < last - first; k++)
+        {
+            if (abs(result[i].weights[k]) > SHRT_MAX)
+            {
+                fits = false;
+            }
+        }
+
+        if (fits)
+        {
+            result[i].narrow.assign(result[i].weights.begin(), result[i].weights.end());
+        }
+    }
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rounds a fixed point filter result back to a pixel and clamps it to the range 0 - 255.
+  * The Lanczos filter has negative lobes, so results can fall outside of that range.
+  *
+  * @param[in] acc - the accumulated fixed point value.
+  *
+  * @returns the clamped pixel value
+  *
+  * @par Example:
+    @verbatim
+
+    pixel p = clampFixed(255 << RESIZE_PRECISION);
+
+    //p is 255
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline pixel clampFixed(int acc)
+{
+    acc = (acc + (1 << (RESIZE_PRECISION - 1))) >> RESIZE_PRECISION;
+
+    if (acc < 0)
+    {
+        return 0;
+    }
+
+    if (acc > 255)
+    {
+        return 255;
+    }
+
+    return (pixel)acc;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Resizes a single channel from rows x cols to newRows x newCols in two separable passes. The
+  * horizontal pass filters every source row into a temporary array of rows x newCols. The
+  * vertical pass then filters the temporary rows into the output. In the vertical pass each
+  * source row is multiplied by its weight and added to a row of accumulators, which keeps
+  * the inner loop a straight run over contiguous memory that the compiler vectorizes. With SSE2
+  * and 16 bit weights, the horizontal pass multiplies 8 or 4 taps at once with madd, and the
+  * vertical pass keeps the sums of 8 output pixels in registers and adds two source rows at a
+  * time, interleaved so that madd multiplies each pair of rows by its pair of weights. The sums
+  * are the same integers in any order, so the result does not depend on SSE2. Both passes split
+  * the rows into strips that run in parallel. The old channel is freed and replaced by the
+  * resized one.
+  *
+  * @param[in,out] channel - the 2D array of the channel to resize.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] newRows - the number of rows after resizing.
+  * @param[in] newCols - the number of columns after resizing.
+  * @param[in] wRows - the precomputed weights of each output row.
+  * @param[in] wCols - the precomputed weights of each output column.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    resizeChannel(img.redGray, 210, 105, 385, wRows, wCols);
+
+    //img.redGray is now a 2D array of 105 x 385
+
+    @endverbatim
+
+  ***********************************************************************/
+static void resizeChannel(pixel**& channel, int rows, int newRows, int newCols,
+    const vector<resizeWeights>& wRows, const vector<resizeWeights>& wCols)
+{
+    pixel** temp = nullptr;
+    pixel** result = nullptr;
+
+    temp = alloc2D(rows, newCols);
+    result = alloc2D(newRows, newCols);
+
+    //if memory allocation fails
+    if (temp == nullptr || result == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //horizontal pass
+    parallelFor(0, rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j, k, acc;
+
+#ifdef RESIZE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum;
+        int four = 0;
+#endif
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            const pixel* src = channel[i];
+
+            for (j = 0; j < newCols; j++)
+            {
+                const pixel* s = src + wCols[j].start;
+                const int* w = wCols[j].weights.data();
+                int taps = (int)wCols[j].weights.size();
+
+                acc = 0;
+                k = 0;
+
+#ifdef RESIZE_SSE2
+                if (!wCols[j].narrow.empty())
+                {
+                    const short* n = wCols[j].narrow.data();
+
+                    sum = zero;
+
+                    for (; k + 8 <= taps; k += 8)
+                    {
+                        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s + k)), zero),
+                            _mm_loadu_si128((const __m128i*)(n + k))));
+                    }
+
+                    if (k + 4 <= taps)
+                    {
+                        memcpy(&four, s + k, 4);
+                        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(four), zero),
+                            _mm_loadl_epi64((const __m128i*)(n + k))));
+                        k += 4;
+                    }
+
+                    //add the four sums together
+                    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+                    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+                    acc = _mm_cvtsi128_si32(sum);
+                }
+#endif
+
+                for (; k < taps; k++)
+                {
+                    acc += w[k] * s[k];
+                }
+
+                temp[i][j] = clampFixed(acc);
+            }
+        }
+    });
+
+    //vertical pass
+    parallelFor(0, newRows, [&](int rowStart, int rowEnd)
+    {
+        int i, j, k, w;
+        int done = 0;
+        vector<int> acc(newCols);
+
+#ifdef RESIZE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi32(1 << (RESIZE_PRECISION - 1));
+        __m128i lo, hi, a, b, pair;
+        const pixel* below = nullptr;
+#endif
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            int start = wRows[i].start;
+            int taps = (int)wRows[i].weights.size();
+
+            done = 0;
+
+#ifdef RESIZE_SSE2
+            if (!wRows[i].narrow.empty())
+            {
+                const short* n = wRows[i].narrow.data();
+
+                for (j = 0; j + 8 <= newCols; j += 8)
+                {
+                    lo = hi = zero;
+
+                    for (k = 0; k < taps; k += 2)
+                    {
+                        //an odd last row is paired with itself and a weight of 0
+                        below = k + 1 < taps ? temp[start + k + 1] : temp[start + k];
+                        pair = _mm_set1_epi32((int)((unsigned short)n[k] | ((unsigned)(k + 1 < taps ? (unsigned short)n[k + 1] : 0) << 16)));
+
+                        a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(temp[start + k] + j)), zero);
+                        b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(below + j)), zero);
+
+                        lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), pair));
+                        hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), pair));
+                    }
+
+                    //round and clamp like clampFixed
+                    lo = _mm_srai_epi32(_mm_add_epi32(lo, half), RESIZE_PRECISION);
+                    hi = _mm_srai_epi32(_mm_add_epi32(hi, half), RESIZE_PRECISION);
+                    lo = _mm_packs_epi32(lo, hi);
+
+                    _mm_storel_epi64((__m128i*)(result[i] + j), _mm_packus_epi16(lo, lo));
+                }
+
+                done = j;
+            }
+#endif
+
+            //the columns that are left
+            fill(acc.begin() + done, acc.end(), 0);
+
+            for (k = 0; k < taps; k++)
+            {
+                const pixel* src = temp[start + k];
+                int* a = acc.data();
+
+                w = wRows[i].weights[k];
+
+                for (j = done; j < newCols; j++)
+                {
+                    a[j] += w * src[j];
+                }
+            }
+
+            for (j = done; j < newCols; j++)
+            {
+                result[i][j] = clampFixed(acc[j]);
+            }
+        }
+    });
+
+    //replace the channel
+    free2D(temp, rows);
+    free2D(channel, rows);
+    channel = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Resizes the image to newRows x newCols using the box, bilinear, or Lanczos-3 filter. The
+  * filter weights for every output row and column are computed once and shared by all three
+  * channels. Each channel is then resized in two separable passes by resizeChannel. The rows
+  * and columns of the structure are updated to the new dimensions. If there is not enough memory
+  * for the weights, a message is outputted and the program exits, as when alloc2D fails.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] newRows - the number of rows after resizing.
+  * @param[in] newCols - the number of columns after resizing.
+  * @param[in] filter - the filter used for resampling.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //resizing an image of dimensions 210 x 771
+    img.rows = 210;
+    img.cols = 771;
+
+    resizeImage(img, 105, 385, FILTER_LANCZOS3);
+
+    //img now contains the resized image of dimensions 105 x 385.
+    //img.rows = 105;
+    //img.cols = 385;
+
+    @endverbatim
+
+  ***********************************************************************/
+void resizeImage(image& img, int newRows, int newCols, resizeFilter filter)
+{
+    vector<resizeWeights> wRows;
+    vector<resizeWeights> wCols;
+
+    if (newRows <= 0 || newCols <= 0)
+    {
+        cout << "Invalid Resize Dimensions" << endl;
+        exit(0);
+    }
+
+    //precompute the weights of every output row and column, a table for a huge size may not fit
+    try
+    {
+        wRows = computeWeights(img.rows, newRows, filter);
+        wCols = computeWeights(img.cols, newCols, filter);
+    }
+
+    catch (const bad_alloc&)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    resizeChannel(img.redGray, img.rows, newRows, newCols, wRows, wCols);
+    resizeChannel(img.green, img.rows, newRows, newCols, wRows, wCols);
+    resizeChannel(img.blue, img.rows, newRows, newCols, wRows, wCols);
+
+    //changing the values of rows and columns
+    img.rows = newRows;
+    img.cols = newCols;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Shrinks a single channel by an integer factor by averaging each factor x factor block of
+  * pixels. The blocks on the right and bottom edges may be smaller when the dimensions are not
+  * a multiple of the factor, and are averaged over the pixels they actually contain. For every
+  * output row the factor source rows are first added into a row of column sums, and then every
+  * factor column sums are added and divided. The sums are 64 bits, since a block of a large factor
+  * can add up to more than 32 bits hold. The output rows are split into parallel strips.
+  *
+  * @param[in,out] channel - the 2D array of the channel to shrink.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] cols - the number of columns of the channel.
+  * @param[in] factor - the downscale factor.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    downscaleChannel(img.redGray, 210, 771, 2);
+
+    //img.redGray is now a 2D array of 105 x 386
+
+    @endverbatim
+
+  ***********************************************************************/
+static void downscaleChannel(pixel**& channel, int rows, int cols, int factor)
+{
+    int newRows = (int)(((long long)rows + factor - 1) / factor);
+    int newCols = (int)(((long long)cols + factor - 1) / factor);
+
+    pixel** result = nullptr;
+
+    result = alloc2D(newRows, newCols);
+
+    //if memory allocation fails
+    if (result == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, newRows, [&](int rowStart, int rowEnd)
+    {
+        int i, j, k, blockRows, blockCols;
+        long long sum, count;
+        vector<long long> colSum(cols);
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            blockRows = min(factor, rows - i * factor);
+
+            //add up the rows of the block
+            fill(colSum.begin(), colSum.end(), 0);
+
+            for (k = 0; k < blockRows; k++)
+            {
+                const pixel* src = channel[i * factor + k];
+                long long* c = colSum.data();
+
+                for (j = 0; j < cols; j++)
+                {
+                    c[j] += src[j];
+                }
+            }
+
+            //add up the columns of the block
+            for (j = 0; j < newCols; j++)
+            {
+                blockCols = min(factor, cols - j * factor);
+                count = (long long)blockRows * blockCols;
+                sum = 0;
+
+                for (k = 0; k < blockCols; k++)
+                {
+                    sum += colSum[j * factor + k];
+                }
+
+                result[i][j] = (pixel)((sum + count / 2) / count);
+            }
+        }
+    });
+
+    free2D(channel, rows);
+    channel = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Shrinks the image by an integer factor by averaging each factor x factor block of pixels.
+  * This is much faster than resizeImage since there are no weights to apply. The new dimensions
+  * are the old dimensions divided by the factor, rounded up.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] factor - the downscale factor.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //shrinking an image of dimensions 210 x 771
+    img.rows = 210;
+    img.cols = 771;
+
+    downscaleBox(img, 2);
+
+    //img now contains the shrunk image of dimensions 105 x 386.
+    //img.rows = 105;
+    //img.cols = 386;
+
+    @endverbatim
+
+  ***********************************************************************/
+void downscaleBox(image& img, int factor)
+{
+    if (factor <= 1)
+    {
+        return;
+    }
+
+    downscaleChannel(img.redGray, img.rows, img.cols, factor);
+    downscaleChannel(img.green, img.rows, img.cols, factor);
+    downscaleChannel(img.blue, img.rows, img.cols, factor);
+
+    //changing the values of rows and columns
+    img.rows = (int)(((long long)img.rows + factor - 1) / factor);
+    img.cols = (int)(((long long)img.cols + factor - 1) / factor);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Shrinks the image so that its longest side is maxSize pixels while keeping the aspect ratio.
+  * Images that are already small enough are left alone. When the image is more than four times
+  * larger than the thumbnail, it is first shrunk by an integer factor with downscaleBox so that
+  * it stays at least twice the size of the thumbnail. The Lanczos-3 filter then only has to
+  * cover the last, small step, which gives the same quality at a fraction of the cost.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] maxSize - the longest side of the thumbnail.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //making a thumbnail of an image of dimensions 2100 x 7710
+    img.rows = 2100;
+    img.cols = 7710;
+
+    thumbnail(img, 256);
+
+    //img now contains a thumbnail of dimensions 70 x 256.
+    //img.rows = 70;
+    //img.cols = 256;
+
+    @endverbatim
+
+  ***********************************************************************/
+void thumbnail(image& img, int maxSize)
+{
+    int newRows = 0;
+    int newCols = 0;
+    int factor = 0;
+
+    if (maxSize <= 0)
+    {
+        cout << "Invalid Thumbnail Size" << endl;
+        exit(0);
+    }
+
+    if (img.rows <= maxSize && img.cols <= maxSize)
+    {
+        return;
+    }
+
+    //keep the aspect ratio
+    if (img.cols >= img.rows)
+    {
+        newCols = maxSize;
+        newRows = (int)((long long)img.rows * maxSize / img.cols);
+    }
+
+    else
+    {
+        newRows = maxSize;
+        newCols = (int)((long long)img.cols * maxSize / img.rows);
+    }
+
+    if (newRows < 1)
+    {
+        newRows = 1;
+    }
+
+    if (newCols < 1)
+    {
+        newCols = 1;
+    }
+
+    //fast integer reduction while the image is much larger than the thumbnail
+    factor = min(img.rows / newRows, img.cols / newCols) / 2;
+
+    if (factor >= 2)
+    {
+        downscaleBox(img, factor);
+    }
+
+    resizeImage(img, newRows, newCols, FILTER_LANCZOS3);
+}
@@ -0,0 +1,617 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that compute histograms and statistics of images
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Bytes of the file that streamStats reads at a time.
+ */
+const size_t STATS_CHUNK = 1 << 22;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Counts n values, spaced step pixels apart, into a histogram. The values are spread over four
+  * separate histograms that are added together at the end. When the same value repeats, as it
+  * does in flat areas of an image, consecutive increments then go to different counters and do
+  * not have to wait for each other.
+  *
+  * @param[in] p - the first value.
+  * @param[in] n - the number of values.
+  * @param[in] step - the distance between two values, 1 for a channel and 3 for interleaved rgb.
+  * @param[in,out] hist - the histogram that the counts are added to.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned long long hist[256] = { 0 };
+
+    countValues(img.redGray[i], img.cols, 1, hist);
+
+    //hist holds the counts of row i of the red channel
+
+    @endverbatim
+
+  ***********************************************************************/
+static void countValues(const pixel* p, size_t n, size_t step, unsigned long long hist[256])
+{
+    //loop variables
+    size_t j = 0;
+    int v = 0;
+
+    unsigned long long sub[4][256];
+
+    memset(sub, 0, sizeof(sub));
+
+    for (j = 0; j + 3 < n; j += 4)
+    {
+        sub[0][p[j * step]]++;
+        sub[1][p[(j + 1) * step]]++;
+        sub[2][p[(j + 2) * step]]++;
+        sub[3][p[(j + 3) * step]]++;
+    }
+
+    for (; j < n; j++)
+    {
+        sub[0][p[j * step]]++;
+    }
+
+    for (v = 0; v < 256; v++)
+    {
+        hist[v] += sub[0][v] + sub[1][v] + sub[2][v] + sub[3][v];
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Fills in the minimum, maximum, and mean of every channel and the number of pixels from the
+  * histograms that are already in the structure.
+  *
+  * @param[in,out] stats - the statistics, with the histograms filled in.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    finishStats(stats);
+
+    //stats.minimum, stats.maximum, and stats.mean are filled in
+
+    @endverbatim
+
+  ***********************************************************************/
+static void finishStats(imageStats& stats)
+{
+    //loop variables
+    int c = 0;
+    int v = 0;
+
+    double total = 0;
+
+    stats.pixels = 0;
+
+    for (v = 0; v < 256; v++)
+    {
+        stats.pixels += stats.histogram[0][v];
+    }
+
+    for (c = 0; c < stats.channels; c++)
+    {
+        stats.minimum[c] = 255;
+        stats.maximum[c] = 0;
+        total = 0;
+
+        for (v = 0; v < 256; v++)
+        {
+            if (stats.histogram[c][v] != 0)
+            {
+                stats.minimum[c] = min(stats.minimum[c], v);
+                stats.maximum[c] = max(stats.maximum[c], v);
+            }
+
+            total += (double)v * stats.histogram[c][v];
+        }
+
+        stats.mean[c] = stats.pixels > 0 ? total / stats.pixels : 0.0;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Computes the histogram, minimum, maximum, and mean of each channel of the image. The rows are
+  * split into strips that run in parallel, and every strip counts into its own histograms. The strip
+  * histograms are added into the result once the strip is done, so the threads never share a counter
+  * while they are counting. For a grayscale image channels is 1 and only img.redGray is counted.
+  *
+  * @param[in] img - the image to measure.
+  * @param[out] stats - the statistics of the image.
+  * @param[in] channels - the number of channels to measure, 3 or 1.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    imageStats stats;
+
+    computeStats(img, stats, 3);
+
+    //stats.histogram[0][v] is the number of red pixels with value v
+
+    @endverbatim
+
+  ***********************************************************************/
+void computeStats(image& img, imageStats& stats, int channels)
+{
+    pixel** planes[3] = { img.redGray, img.green, img.blue };
+    mutex merge;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.channels = channels;
+
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        int i, c, v;
+        unsigned long long local[3][256];
+
+        memset(local, 0, sizeof(local));
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            for (c = 0; c < channels; c++)
+            {
+                countValues(planes[c][i], img.cols, 1, local[c]);
+            }
+        }
+
+        //add the strip into the result
+        lock_guard<mutex> lock(merge);
+
+        for (c = 0; c < channels; c++)
+        {
+            for (v = 0; v < 256; v++)
+            {
+                stats.histogram[c][v] += local[c][v];
+            }
+        }
+    });
+
+    finishStats(stats);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Computes the statistics of a file without storing the image. The header is read and the image
+  * data is then read in chunks of whole rows of about STATS_CHUNK bytes. For binary files each chunk
+  * is counted in parallel strips that each have their own histograms, like computeStats. Ascii files
+  * are parsed in parallel a batch at a time by streamAsciiSamples, and QOI files are decoded a batch at a time. Black and white files are counted as
+  * grayscale values of 0 and 255. PAM files are counted like binary files, without their alpha values. Only one chunk is in memory at any time, so the statistics of a file
+  * of any size are computed in a single pass.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[out] stats - the statistics of the image in the file.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    ifstream fin;
+    imageStats stats;
+
+    openInputFile(fin, "cats.ppm");
+    streamStats(fin, stats);
+
+    //stats holds the statistics of cats.ppm
+
+    @endverbatim
+
+  ***********************************************************************/
+void streamStats(ifstream& bfin, imageStats& stats)
+{
+    //loop variable
+    int i = 0;
+
+    image img;
+    int max_pix_val = 0;
+    int phase = 0;
+    int chunkRows = 0;
+    int count = 0;
+    size_t rowBytes = 0;
+
+    //PAM files have depth values per pixel, the last one alpha if there is one
+    bool pam = false;
+    int depth = 0;
+    bool alpha = false;
+    bool bilevel = false;
+    int stride = 0;
+
+    vector<pixel> buffer;
+    mutex merge;
+
+    memset(&stats, 0, sizeof(stats));
+
+    //QOI, decoded a batch at a time
+    if (readQoiHeader(bfin, img, max_pix_val))
+    {
+        stats.channels = 3;
+
+        streamQoiSamples(bfin, (unsigned long long)img.rows * img.cols, [&](const pixel* samples, size_t n)
+        {
+            int c = 0;
+
+            for (c = 0; c < 3; c++)
+            {
+                countValues(samples + c, n / 3, 3, stats.histogram[c]);
+            }
+        });
+
+        finishStats(stats);
+        return;
+    }
+
+    //reading in image header
+    pam = readPamHeader(bfin, img, max_pix_val, depth, alpha, bilevel);
+
+    if (!pam)
+    {
+        readHeader(bfin, img, max_pix_val);
+    }
+
+    if (img.magicNumber == "P3" || img.magicNumber == "P6")
+    {
+        stats.channels = 3;
+    }
+
+    else if (img.magicNumber == "P2" || img.magicNumber == "P5" || isBilevel(img))
+    {
+        stats.channels = 1;
+    }
+
+    else
+    {
+        cout << "Invalid Magic Number" << endl;
+        exit(0);
+    }
+
+    stride = pam ? depth : stats.channels;
+    rowBytes = (size_t)img.cols * stride;
+
+    //black and white, a batch of rows at a time
+    if (isBilevel(img) && !pam)
+    {
+        streamBilevelRows(bfin, img, img.magicNumber == "P1", [&](const pixel* rows, int n)
+        {
+            countValues(rows, (size_t)n * img.cols, 1, stats.histogram[0]);
+        });
+
+        finishStats(stats);
+        return;
+    }
+
+    //ascii, parsed in parallel a batch at a time
+    if (img.magicNumber == "P3" || img.magicNumber == "P2")
+    {
+        streamAsciiSamples(bfin, (unsigned long long)img.rows * img.cols * stats.channels, [&](const pixel* samples, size_t n)
+        {
+            int c = 0;
+            size_t first = 0;
+
+            //a batch can end in the middle of a pixel, phase is the channel of its first value
+            for (c = 0; c < stats.channels; c++)
+            {
+                first = (size_t)((c - phase + stats.channels) % stats.channels);
+
+                if (first < n)
+                {
+                    countValues(samples + first, (n - first + stats.channels - 1) / stats.channels, stats.channels, stats.histogram[c]);
+                }
+            }
+
+            phase = (int)((phase + n) % stats.channels);
+        });
+
+        finishStats(stats);
+        return;
+    }
+
+    //binary, a chunk of rows at a time
+    chunkRows = (int)max((size_t)1, STATS_CHUNK / rowBytes);
+    buffer.resize(rowBytes * chunkRows);
+
+    for (i = 0; i < img.rows; i += chunkRows)
+    {
+        count = min(chunkRows, img.rows - i);
+        bfin.read((char*)buffer.data(), rowBytes * count);
+
+        parallelFor(0, count, [&](int rowStart, int rowEnd)
+        {
+            int r, c, v;
+            unsigned long long local[3][256];
+
+            memset(local, 0, sizeof(local));
+
+            for (r = rowStart; r < rowEnd; r++)
+            {
+                for (c = 0; c < stats.channels; c++)
+                {
+                    countValues(buffer.data() + r * rowBytes + c, img.cols, stride, local[c]);
+                }
+            }
+
+            //add the strip into the result
+            lock_guard<mutex> lock(merge);
+
+            for (c = 0; c < stats.channels; c++)
+            {
+                for (v = 0; v < 256; v++)
+                {
+                    stats.histogram[c][v] += local[c][v];
+                }
+            }
+        });
+    }
+
+    //black and white PAM values are 0 and 1
+    if (bilevel)
+    {
+        stats.histogram[0][255] += stats.histogram[0][1];
+        stats.histogram[0][1] = 0;
+    }
+
+    finishStats(stats);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Prints the minimum, maximum, and mean of every channel followed by its histogram. The
+  * histogram is printed as 256 counts separated by spaces, starting with the count of value 0.
+  * The format and precision of cout are put back afterwards, so later output is not changed.
+  *
+  * @param[in] stats - the statistics to print.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    printStats(stats);
+
+    //pixels 161910
+    //red min 0 max 255 mean 127.42
+    //red histogram 12 40 ...
+
+    @endverbatim
+
+  ***********************************************************************/
+void printStats(const imageStats& stats)
+{
+    //loop variables
+    int c = 0;
+    int v = 0;
+
+    const char* names[3] = { "red", "green", "blue" };
+
+    //the means are printed with 2 decimals
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+
+    if (stats.channels == 1)
+    {
+        names[0] = "gray";
+    }
+
+    cout << "pixels " << stats.pixels << "\n";
+
+    for (c = 0; c < stats.channels; c++)
+    {
+        cout << names[c] << " min " << stats.minimum[c] << " max " << stats.maximum[c]
+             << " mean " << fixed << setprecision(2) << stats.mean[c] << "\n";
+    }
+
+    for (c = 0; c < stats.channels; c++)
+    {
+        cout << names[c] << " histogram";
+
+        for (v = 0; v < 256; v++)
+        {
+            cout << " " << stats.histogram[c][v];
+        }
+
+        cout << "\n";
+    }
+
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Replaces every pixel of a channel with its entry in a lookup table. The rows are split into
+  * strips that run in parallel.
+  *
+  * @param[in,out] channel - the 2D array of the channel.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] cols - the number of columns of the channel.
+  * @param[in] table - the new value for every old value.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel invert[256];
+
+    for (v = 0; v < 256; v++)
+    {
+        invert[v] = 255 - v;
+    }
+
+    applyTable(img.redGray, img.rows, img.cols, invert);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void applyTable(pixel** channel, int rows, int cols, const pixel table[256])
+{
+    parallelFor(0, rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            pixel* p = channel[i];
+
+            for (j = 0; j < cols; j++)
+            {
+                p[j] = table[p[j]];
+            }
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Stretches each channel so that its darkest value becomes 0 and its brightest value becomes 255.
+  * The statistics are computed first, and each channel is then mapped through a lookup table.
+  * Channels with a single value are left alone.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] channels - the number of channels to stretch, 3 or 1 for a grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //an image whose red values run from 40 to 200
+    autoLevels(img, 3);
+
+    //the red values now run from 0 to 255
+
+    @endverbatim
+
+  ***********************************************************************/
+void autoLevels(image& img, int channels)
+{
+    //loop variables
+    int c = 0;
+    int v = 0;
+
+    imageStats stats;
+    pixel table[256];
+    pixel** planes[3] = { img.redGray, img.green, img.blue };
+
+    computeStats(img, stats, channels);
+
+    for (c = 0; c < channels; c++)
+    {
+        if (stats.maximum[c] <= stats.minimum[c])
+        {
+            continue;
+        }
+
+        for (v = 0; v < 256; v++)
+        {
+            table[v] = (pixel)(min(max(v - stats.minimum[c], 0), stats.maximum[c] - stats.minimum[c]) * 255 /
+                (stats.maximum[c] - stats.minimum[c]));
+        }
+
+        applyTable(planes[c], img.rows, img.cols, table);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Equalizes the histogram of each channel so that its values are spread evenly over 0 to 255.
+  * The cumulative histogram of the channel is turned into a lookup table, where each value maps to
+  * the fraction of pixels at or below it. The darkest value present maps to 0.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] channels - the number of channels to equalize, 3 or 1 for a grayscale image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //a dark, low contrast image
+    equalizeHistogram(img, 3);
+
+    //the values of each channel now cover the whole range
+
+    @endverbatim
+
+  ***********************************************************************/
+void equalizeHistogram(image& img, int channels)
+{
+    //loop variables
+    int c = 0;
+    int v = 0;
+
+    imageStats stats;
+    pixel table[256];
+    pixel** planes[3] = { img.redGray, img.green, img.blue };
+
+    unsigned long long cdf = 0;
+    unsigned long long first = 0;
+
+    computeStats(img, stats, channels);
+
+    for (c = 0; c < channels; c++)
+    {
+        cdf = 0;
+        first = stats.histogram[c][stats.minimum[c]];
+
+        if (stats.pixels <= first)
+        {
+            continue;
+        }
+
+        for (v = 0; v < 256; v++)
+        {
+            cdf += stats.histogram[c][v];
+
+            if (cdf <= first)
+            {
+                table[v] = 0;
+            }
+
+            else
+            {
+                table[v] = (pixel)(((cdf - first) * 255 + (stats.pixels - first) / 2) / (stats.pixels - first));
+            }
+        }
+
+        applyTable(planes[c], img.rows, img.cols, table);
+    }
+}
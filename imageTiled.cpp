@@ -0,0 +1,623 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that store images in square tiles and manipulate them tile by tile
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the position of row i and column j inside the buffer of a tiled channel. The tiles are
+  * stored one after another, row of tiles by row of tiles, and the pixels inside a tile are stored
+  * row by row. Since TILE_SIZE is a power of two, the position is found with shifts and masks.
+  *
+  * @param[in] t - the tiled image.
+  * @param[in] i - the row.
+  * @param[in] j - the column.
+  *
+  * @returns the index of the pixel in each channel buffer
+  *
+  * @par Example:
+    @verbatim
+
+    pixel p = t.red[tileIndex(t, 100, 70)];
+
+    //p is the red value at row 100 and column 70
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline size_t tileIndex(const tiledImage& t, int i, int j)
+{
+    size_t tile = (size_t)(i >> TILE_SHIFT) * t.tileCols + (j >> TILE_SHIFT);
+
+    return (tile << (2 * TILE_SHIFT)) + ((size_t)(i & (TILE_SIZE - 1)) << TILE_SHIFT) + (j & (TILE_SIZE - 1));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Allocates the three channel buffers of a tiled image of rows x cols pixels. The number of tiles is
+  * rounded up, so the tiles on the right and bottom edges have unused pixels. If memory allocation
+  * fails, a message is outputted and the program exits.
+  *
+  * @param[out] t - the tiled image.
+  * @param[in] rows - the number of rows.
+  * @param[in] cols - the number of columns.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    tiledImage t;
+
+    allocTiled(t, 210, 771);
+
+    //t has 4 x 13 tiles of 64 x 64 pixels
+
+    @endverbatim
+
+  ***********************************************************************/
+static void allocTiled(tiledImage& t, int rows, int cols)
+{
+    size_t size = 0;
+
+    t.rows = rows;
+    t.cols = cols;
+    t.tileRows = (rows + TILE_SIZE - 1) >> TILE_SHIFT;
+    t.tileCols = (cols + TILE_SIZE - 1) >> TILE_SHIFT;
+
+    size = ((size_t)t.tileRows * t.tileCols) << (2 * TILE_SHIFT);
+
+    t.red = new (nothrow) pixel[size];
+    t.green = new (nothrow) pixel[size];
+    t.blue = new (nothrow) pixel[size];
+
+    //if memory allocation fails
+    if (t.red == nullptr || t.green == nullptr || t.blue == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Frees the three channel buffers of a tiled image and sets them to nullptr.
+  *
+  * @param[in,out] t - the tiled image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    freeTiled(t);
+
+    //t.red, t.green, and t.blue are nullptr
+
+    @endverbatim
+
+  ***********************************************************************/
+void freeTiled(tiledImage& t)
+{
+    delete [] t.red;
+    delete [] t.green;
+    delete [] t.blue;
+
+    t.red = nullptr;
+    t.green = nullptr;
+    t.blue = nullptr;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts an image from rows of pixels into tiles. Each row of tiles is filled from TILE_SIZE rows
+  * of the image, and the rows of tiles are split into strips that run in parallel. The arrays of the
+  * image are freed once they have been copied, so only one copy of the image is kept.
+  *
+  * @param[in,out] img - the image to convert. Its arrays are freed.
+  * @param[out] t - the tiled image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    tiledImage t;
+
+    toTiled(img, t);
+
+    //t holds the pixels of img in tiles of 64 x 64
+
+    @endverbatim
+
+  ***********************************************************************/
+void toTiled(image& img, tiledImage& t)
+{
+    allocTiled(t, img.rows, img.cols);
+
+    parallelFor(0, t.tileRows, [&](int tileStart, int tileEnd)
+    {
+        int i, j, count;
+
+        for (i = tileStart * TILE_SIZE; i < min(tileEnd * TILE_SIZE, img.rows); i++)
+        {
+            for (j = 0; j < img.cols; j += TILE_SIZE)
+            {
+                count = min(TILE_SIZE, img.cols - j);
+
+                memcpy(t.red + tileIndex(t, i, j), img.redGray[i] + j, count);
+                memcpy(t.green + tileIndex(t, i, j), img.green[i] + j, count);
+                memcpy(t.blue + tileIndex(t, i, j), img.blue[i] + j, count);
+            }
+        }
+    });
+
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts a tiled image back into rows of pixels so that it can be outputted. The arrays of the image
+  * are allocated with alloc2D and the rows and columns of the structure are set from the tiled image.
+  * The tiled buffers are freed once they have been copied.
+  *
+  * @param[in,out] t - the tiled image. Its buffers are freed.
+  * @param[in,out] img - the image that receives the pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    fromTiled(t, img);
+
+    //img holds the pixels of t in rows again
+
+    @endverbatim
+
+  ***********************************************************************/
+void fromTiled(tiledImage& t, image& img)
+{
+    img.rows = t.rows;
+    img.cols = t.cols;
+
+    //dynamically allocating 3 2D arrays
+    img.redGray = alloc2D(img.rows, img.cols);
+    img.green = alloc2D(img.rows, img.cols);
+    img.blue = alloc2D(img.rows, img.cols);
+
+    //if memory allocation fails
+    if ((img.redGray == nullptr) || (img.green == nullptr) || (img.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, t.tileRows, [&](int tileStart, int tileEnd)
+    {
+        int i, j, count;
+
+        for (i = tileStart * TILE_SIZE; i < min(tileEnd * TILE_SIZE, img.rows); i++)
+        {
+            for (j = 0; j < img.cols; j += TILE_SIZE)
+            {
+                count = min(TILE_SIZE, img.cols - j);
+
+                memcpy(img.redGray[i] + j, t.red + tileIndex(t, i, j), count);
+                memcpy(img.green[i] + j, t.green + tileIndex(t, i, j), count);
+                memcpy(img.blue[i] + j, t.blue + tileIndex(t, i, j), count);
+            }
+        }
+    });
+
+    freeTiled(t);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Moves the pixels of a tiled image to new positions, one destination tile at a time. For the pixel
+  * at row i and column j of the result, the source pixel is at
+  *
+  *     source row    = rowBase + rowI * i + rowJ * j
+  *     source column = colBase + colI * i + colJ * j
+  *
+  * where every coefficient is 0, 1, or -1, which covers the flips and the 90 degree rotations. All the
+  * source pixels of one destination tile come from at most four source tiles, so both the reads and
+  * the writes stay inside a few kilobytes of memory. Moving one column to the right in the result moves
+  * the source by one row or one column, which is a fixed step inside a source tile, so each row of a
+  * destination tile is copied in at most two runs, one per source tile, with the position found once per
+  * run. The rows of destination tiles are split into strips that run in parallel. The old buffers are
+  * freed and replaced.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  * @param[in] newRows - the number of rows of the result.
+  * @param[in] newCols - the number of columns of the result.
+  * @param[in] map - the six coefficients rowBase, rowI, rowJ, colBase, colI, colJ.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //flipping on the Y axis, source column is cols - 1 - j
+    int map[6] = { 0, 1, 0, t.cols - 1, 0, -1 };
+
+    remapTiled(t, t.rows, t.cols, map);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void remapTiled(tiledImage& t, int newRows, int newCols, const int map[6])
+{
+    tiledImage result;
+
+    //the source moves along its column or along its row, forwards or backwards
+    bool alongColumn = map[2] != 0;
+    int direction = alongColumn ? map[2] : map[5];
+    ptrdiff_t step = alongColumn ? (ptrdiff_t)direction * TILE_SIZE : direction;
+
+    allocTiled(result, newRows, newCols);
+
+    parallelFor(0, result.tileRows, [&](int tileStart, int tileEnd)
+    {
+        int ti, tj, i, j, k, si, sj, iEnd, jEnd, offset, run;
+        const pixel *sr, *sg, *sb;
+        pixel *dr, *dg, *db;
+
+        for (ti = tileStart; ti < tileEnd; ti++)
+        {
+            for (tj = 0; tj < result.tileCols; tj++)
+            {
+                iEnd = min((ti + 1) * TILE_SIZE, newRows);
+                jEnd = min((tj + 1) * TILE_SIZE, newCols);
+
+                for (i = ti * TILE_SIZE; i < iEnd; i++)
+                {
+                    j = tj * TILE_SIZE;
+                    dr = result.red + tileIndex(result, i, j);
+                    dg = result.green + (dr - result.red);
+                    db = result.blue + (dr - result.red);
+
+                    //one run for each source tile that the row crosses
+                    while (j < jEnd)
+                    {
+                        si = map[0] + map[1] * i + map[2] * j;
+                        sj = map[3] + map[4] * i + map[5] * j;
+                        sr = t.red + tileIndex(t, si, sj);
+                        sg = t.green + (sr - t.red);
+                        sb = t.blue + (sr - t.red);
+
+                        offset = (alongColumn ? si : sj) & (TILE_SIZE - 1);
+                        run = min(jEnd - j, direction > 0 ? TILE_SIZE - offset : offset + 1);
+
+                        for (k = 0; k < run; k++)
+                        {
+                            dr[k] = sr[k * step];
+                            dg[k] = sg[k * step];
+                            db[k] = sb[k * step];
+                        }
+
+                        dr += run;
+                        dg += run;
+                        db += run;
+                        j += run;
+                    }
+                }
+            }
+        }
+    });
+
+    freeTiled(t);
+    t = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates a tiled image clockwise, tile by tile. Row i and column j of the result is row rows - 1 - j
+  * and column i of the original, so the rows and columns are exchanged.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating a tiled image of dimensions 210 x 771 clockwise
+    rotateTiledCW(t);
+
+    //t.rows = 771;
+    //t.cols = 210;
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateTiledCW(tiledImage& t)
+{
+    int map[6] = { t.rows - 1, 0, -1, 0, 1, 0 };
+
+    remapTiled(t, t.cols, t.rows, map);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates a tiled image counter clockwise, tile by tile. Row i and column j of the result is row j
+  * and column cols - 1 - i of the original, so the rows and columns are exchanged.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating a tiled image of dimensions 210 x 771 counter clockwise
+    rotateTiledCCW(t);
+
+    //t.rows = 771;
+    //t.cols = 210;
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateTiledCCW(tiledImage& t)
+{
+    int map[6] = { 0, 0, 1, t.cols - 1, -1, 0 };
+
+    remapTiled(t, t.cols, t.rows, map);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Flips a tiled image on the X axis, tile by tile. Row i of the result is row rows - 1 - i of the
+  * original.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    flipTiledX(t);
+
+    //the first row of t is now the last row
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipTiledX(tiledImage& t)
+{
+    int map[6] = { t.rows - 1, -1, 0, 0, 0, 1 };
+
+    remapTiled(t, t.rows, t.cols, map);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Flips a tiled image on the Y axis, tile by tile. Column j of the result is column cols - 1 - j of
+  * the original.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    flipTiledY(t);
+
+    //the first column of t is now the last column
+
+    @endverbatim
+
+  ***********************************************************************/
+void flipTiledY(tiledImage& t)
+{
+    int map[6] = { 0, 1, 0, t.cols - 1, 0, -1 };
+
+    remapTiled(t, t.rows, t.cols, map);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts a tiled image to grayscale with the same weights as convertGrayScale. Like convertGrayScale,
+  * the gray value is only stored in the red channel. Since each pixel only depends on itself, the whole
+  * buffer is processed in order, including the unused pixels of the edge tiles.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    grayTiled(t);
+
+    //t.red holds the gray values
+
+    @endverbatim
+
+  ***********************************************************************/
+void grayTiled(tiledImage& t)
+{
+    parallelFor(0, t.tileRows * t.tileCols, [&](int tileStart, int tileEnd)
+    {
+        size_t k;
+        size_t first = (size_t)tileStart << (2 * TILE_SHIFT);
+        size_t last = (size_t)tileEnd << (2 * TILE_SHIFT);
+
+        for (k = first; k < last; k++)
+        {
+            t.red[k] = (pixel)(0.3 * t.red[k] + 0.6 * t.green[k] + 0.1 * t.blue[k]);
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Antiques a tiled image with the same weights and clamping as convertSepia. Each pixel is read
+  * before it is written, so no temporary buffers are needed.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    sepiaTiled(t);
+
+    //t is now antiqued
+
+    @endverbatim
+
+  ***********************************************************************/
+void sepiaTiled(tiledImage& t)
+{
+    parallelFor(0, t.tileRows * t.tileCols, [&](int tileStart, int tileEnd)
+    {
+        size_t k;
+        size_t first = (size_t)tileStart << (2 * TILE_SHIFT);
+        size_t last = (size_t)tileEnd << (2 * TILE_SHIFT);
+        int r, g, b;
+
+        for (k = first; k < last; k++)
+        {
+            r = (int) (0.393 * t.red[k] + 0.769 * t.green[k] + 0.189 * t.blue[k]);
+            g = (int) (0.349 * t.red[k] + 0.686 * t.green[k] + 0.168 * t.blue[k]);
+            b = (int) (0.272 * t.red[k] + 0.534 * t.green[k] + 0.131 * t.blue[k]);
+
+            t.red[k] = (pixel)min(r, 255);
+            t.green[k] = (pixel)min(g, 255);
+            t.blue[k] = (pixel)min(b, 255);
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if an operation from the command line has a tiled version.
+  *
+  * @param[in] op - the operation.
+  *
+  * @returns true if the operation can be applied to a tiled image
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    tiledOperation(op);
+
+    //returns true for --rotateCW
+
+    @endverbatim
+
+  ***********************************************************************/
+bool tiledOperation(const operation& op)
+{
+    return op.option == "--rotateCW" || op.option == "--rotateCCW" || op.option == "--flipX" ||
+        op.option == "--flipY" || op.option == "--grayscale" || op.option == "--sepia";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies an operation from the command line to a tiled image by calling the matching tiled function.
+  * grayOutput is set to true once the image has been converted to grayscale.
+  *
+  * @param[in,out] t - the tiled image that is manipulated.
+  * @param[in] op - the operation to apply, one for which tiledOperation returns true.
+  * @param[in,out] grayOutput - set to true if the image should be written as grayscale.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    applyTiledOperation(t, op, grayOutput);
+
+    //t is rotated if op is --rotateCW
+
+    @endverbatim
+
+  ***********************************************************************/
+void applyTiledOperation(tiledImage& t, const operation& op, bool& grayOutput)
+{
+    if (op.option == "--rotateCW")
+    {
+        rotateTiledCW(t);
+    }
+
+    else if (op.option == "--rotateCCW")
+    {
+        rotateTiledCCW(t);
+    }
+
+    else if (op.option == "--flipX")
+    {
+        flipTiledX(t);
+    }
+
+    else if (op.option == "--flipY")
+    {
+        flipTiledY(t);
+    }
+
+    else if (op.option == "--sepia")
+    {
+        sepiaTiled(t);
+    }
+
+    else if (op.option == "--grayscale")
+    {
+        grayTiled(t);
+        grayOutput = true;
+    }
+}
@@ -0,0 +1,551 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that create and copy views into images without copying them
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view of the whole image. The view points at the first pixel of each channel, steps
+  * one pixel to move right and img.cols pixels to move down. Nothing is copied, so any change made
+  * through the view is a change to the image, and the view must not be used after the image is freed.
+  *
+  * @param[in] img - the image to view.
+  *
+  * @returns a view of the whole image
+  *
+  * @par Example:
+    @verbatim
+
+    imageView v = makeView(img);
+
+    //v.rows == img.rows, v.cols == img.cols
+    //v.red[i * v.rowStride + j * v.colStride] is img.redGray[i][j]
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView makeView(image& img)
+{
+    imageView v;
+
+    v.red = img.redGray[0];
+    v.green = img.green[0];
+    v.blue = img.blue[0];
+    v.rows = img.rows;
+    v.cols = img.cols;
+    v.rowStride = img.cols;
+    v.colStride = 1;
+
+    return v;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view of the region of w x h pixels whose top left corner is column x and row y of
+  * another view. Only the origin pointers and the size change, the strides stay the same. If the
+  * region does not fit inside the view, a message is outputted and the program exits.
+  *
+  * @param[in] v - the view to crop.
+  * @param[in] x - the first column of the region.
+  * @param[in] y - the first row of the region.
+  * @param[in] w - the width of the region.
+  * @param[in] h - the height of the region.
+  *
+  * @returns a view of the region
+  *
+  * @par Example:
+    @verbatim
+
+    imageView face = cropView(makeView(img), 120, 40, 64, 64);
+
+    //face is the 64 x 64 region starting at column 120 and row 40
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView cropView(const imageView& v, int x, int y, int w, int h)
+{
+    imageView result = v;
+    ptrdiff_t offset = 0;
+
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > v.cols || y + h > v.rows)
+    {
+        cout << "Region Outside Of Image" << endl;
+        exit(0);
+    }
+
+    offset = y * v.rowStride + x * v.colStride;
+
+    result.red = v.red + offset;
+    result.green = v.green + offset;
+    result.blue = v.blue + offset;
+    result.rows = h;
+    result.cols = w;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view that is flipped on the X axis. The origin moves to the last row and the row
+  * stride is negated, so the first row of the result is the last row of the view.
+  *
+  * @param[in] v - the view to flip.
+  *
+  * @returns the flipped view
+  *
+  * @par Example:
+    @verbatim
+
+    imageView flipped = flipViewX(makeView(img));
+
+    //row 0 of flipped is row img.rows - 1 of img
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView flipViewX(const imageView& v)
+{
+    imageView result = v;
+    ptrdiff_t offset = (v.rows - 1) * v.rowStride;
+
+    result.red = v.red + offset;
+    result.green = v.green + offset;
+    result.blue = v.blue + offset;
+    result.rowStride = -v.rowStride;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view that is flipped on the Y axis. The origin moves to the last column and the
+  * column stride is negated, so the first column of the result is the last column of the view.
+  *
+  * @param[in] v - the view to flip.
+  *
+  * @returns the flipped view
+  *
+  * @par Example:
+    @verbatim
+
+    imageView mirrored = flipViewY(makeView(img));
+
+    //column 0 of mirrored is column img.cols - 1 of img
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView flipViewY(const imageView& v)
+{
+    imageView result = v;
+    ptrdiff_t offset = (v.cols - 1) * v.colStride;
+
+    result.red = v.red + offset;
+    result.green = v.green + offset;
+    result.blue = v.blue + offset;
+    result.colStride = -v.colStride;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view that is rotated clockwise. Row i and column j of the result is row
+  * v.rows - 1 - j and column i of the view, so the strides are swapped and the origin moves
+  * to the bottom left corner of the view.
+  *
+  * @param[in] v - the view to rotate.
+  *
+  * @returns the rotated view, with the rows and columns swapped
+  *
+  * @par Example:
+    @verbatim
+
+    imageView turned = rotateViewCW(makeView(img));
+
+    //turned.rows == img.cols, turned.cols == img.rows
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView rotateViewCW(const imageView& v)
+{
+    imageView result = v;
+    ptrdiff_t offset = (v.rows - 1) * v.rowStride;
+
+    result.red = v.red + offset;
+    result.green = v.green + offset;
+    result.blue = v.blue + offset;
+    result.rows = v.cols;
+    result.cols = v.rows;
+    result.rowStride = v.colStride;
+    result.colStride = -v.rowStride;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view that is rotated counter clockwise. Row i and column j of the result is row j
+  * and column v.cols - 1 - i of the view, so the strides are swapped and the origin moves to the
+  * top right corner of the view.
+  *
+  * @param[in] v - the view to rotate.
+  *
+  * @returns the rotated view, with the rows and columns swapped
+  *
+  * @par Example:
+    @verbatim
+
+    imageView turned = rotateViewCCW(makeView(img));
+
+    //turned.rows == img.cols, turned.cols == img.rows
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView rotateViewCCW(const imageView& v)
+{
+    imageView result = v;
+    ptrdiff_t offset = (v.cols - 1) * v.colStride;
+
+    result.red = v.red + offset;
+    result.green = v.green + offset;
+    result.blue = v.blue + offset;
+    result.rows = v.cols;
+    result.cols = v.rows;
+    result.rowStride = -v.colStride;
+    result.colStride = v.rowStride;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view that is transposed. Row i and column j of the result is row j and column i of
+  * the view, so the dimensions and the strides are swapped and the origin stays where it is.
+  *
+  * @param[in] v - the view to transpose.
+  *
+  * @returns the transposed view, with the rows and columns swapped
+  *
+  * @par Example:
+    @verbatim
+
+    imageView t = transposeView(makeView(img));
+
+    //t.rows == img.cols, t.cols == img.rows
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView transposeView(const imageView& v)
+{
+    imageView result = v;
+
+    result.rows = v.cols;
+    result.cols = v.rows;
+    result.rowStride = v.colStride;
+    result.colStride = v.rowStride;
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Creates a view with an orientation applied to it. The orientation is a combination of the bits
+  * ORIENT_TRANSPOSE, ORIENT_FLIP_X, and ORIENT_FLIP_Y; the transpose is applied first and then the
+  * flips. Every flip and 90 degree rotation, and any chain of them, is one of these eight orientations.
+  *
+  * @param[in] v - the view to orient.
+  * @param[in] orient - the orientation.
+  *
+  * @returns the oriented view
+  *
+  * @par Example:
+    @verbatim
+
+    //rotating clockwise is a transpose followed by a flip on the Y axis
+    imageView turned = orientView(makeView(img), ORIENT_TRANSPOSE | ORIENT_FLIP_Y);
+
+    //turned is the same as rotateViewCW(makeView(img))
+
+    @endverbatim
+
+  ***********************************************************************/
+imageView orientView(const imageView& v, int orient)
+{
+    imageView result = v;
+
+    if (orient & ORIENT_TRANSPOSE)
+    {
+        result = transposeView(result);
+    }
+
+    if (orient & ORIENT_FLIP_X)
+    {
+        result = flipViewX(result);
+    }
+
+    if (orient & ORIENT_FLIP_Y)
+    {
+        result = flipViewY(result);
+    }
+
+    return result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the orientation that is the same as applying first and then second. A flip on the X axis
+  * followed by a transpose is a transpose followed by a flip on the Y axis, so when second transposes
+  * the flips of first trade places before they are combined with the flips of second.
+  *
+  * @param[in] first - the orientation applied first.
+  * @param[in] second - the orientation applied second.
+  *
+  * @returns the combined orientation
+  *
+  * @par Example:
+    @verbatim
+
+    int cw = ORIENT_TRANSPOSE | ORIENT_FLIP_Y;
+
+    int orient = combineOrientation(cw, cw);
+
+    //orient is ORIENT_FLIP_X | ORIENT_FLIP_Y, a rotation by 180 degrees
+
+    @endverbatim
+
+  ***********************************************************************/
+int combineOrientation(int first, int second)
+{
+    int flips = first & (ORIENT_FLIP_X | ORIENT_FLIP_Y);
+
+    //the flips of first move across the transpose of second
+    if (second & ORIENT_TRANSPOSE)
+    {
+        flips = ((flips & ORIENT_FLIP_X) ? ORIENT_FLIP_Y : 0) | ((flips & ORIENT_FLIP_Y) ? ORIENT_FLIP_X : 0);
+    }
+
+    return ((first ^ second) & ORIENT_TRANSPOSE) | (flips ^ (second & (ORIENT_FLIP_X | ORIENT_FLIP_Y)));
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the orientation that undoes another one. Without a transpose every orientation undoes
+  * itself. With a transpose the flips have to be undone before it, which swaps them.
+  *
+  * @param[in] orient - the orientation to undo.
+  *
+  * @returns the inverse orientation
+  *
+  * @par Example:
+    @verbatim
+
+    int ccw = inverseOrientation(ORIENT_TRANSPOSE | ORIENT_FLIP_Y);
+
+    //ccw is ORIENT_TRANSPOSE | ORIENT_FLIP_X, a counter clockwise rotation
+
+    @endverbatim
+
+  ***********************************************************************/
+int inverseOrientation(int orient)
+{
+    if (!(orient & ORIENT_TRANSPOSE))
+    {
+        return orient;
+    }
+
+    return ORIENT_TRANSPOSE | ((orient & ORIENT_FLIP_X) ? ORIENT_FLIP_Y : 0) | ((orient & ORIENT_FLIP_Y) ? ORIENT_FLIP_X : 0);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Copies every pixel of the source view into the destination view. Both views must have the
+  * same dimensions, otherwise a message is outputted and the program exits. The rows are split
+  * into strips that run in parallel. When both views step one pixel to the right, each row of
+  * each channel is copied with a single memcpy. The two views must not overlap.
+  *
+  * @param[in] src - the view to copy from.
+  * @param[in] dst - the view to copy into.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //copying the top left 64 x 64 pixels of img into thumb
+    copyView(cropView(makeView(img), 0, 0, 64, 64), makeView(thumb));
+
+    @endverbatim
+
+  ***********************************************************************/
+void copyView(const imageView& src, const imageView& dst)
+{
+    if (src.rows != dst.rows || src.cols != dst.cols)
+    {
+        cout << "Image Dimensions Do Not Match" << endl;
+        exit(0);
+    }
+
+    parallelFor(0, src.rows, [&](int rowStart, int rowEnd)
+    {
+        int i, j;
+
+        for (i = rowStart; i < rowEnd; i++)
+        {
+            const pixel* sr = src.red + i * src.rowStride;
+            const pixel* sg = src.green + i * src.rowStride;
+            const pixel* sb = src.blue + i * src.rowStride;
+            pixel* dr = dst.red + i * dst.rowStride;
+            pixel* dg = dst.green + i * dst.rowStride;
+            pixel* db = dst.blue + i * dst.rowStride;
+
+            //contiguous rows
+            if (src.colStride == 1 && dst.colStride == 1)
+            {
+                memcpy(dr, sr, src.cols);
+                memcpy(dg, sg, src.cols);
+                memcpy(db, sb, src.cols);
+                continue;
+            }
+
+            for (j = 0; j < src.cols; j++)
+            {
+                dr[j * dst.colStride] = sr[j * src.colStride];
+                dg[j * dst.colStride] = sg[j * src.colStride];
+                db[j * dst.colStride] = sb[j * src.colStride];
+            }
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Replaces the image with a copy of a view. New arrays the size of the view are allocated and
+  * the view is copied into them before the old arrays are freed, so the view may point into the
+  * image itself. This is how a crop or any other view becomes an image that can be outputted.
+  *
+  * @param[in,out] img - the struct of type image that is replaced.
+  * @param[in] v - the view to copy.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //keeping only a 100 x 100 region of img
+    viewToImage(img, cropView(makeView(img), 10, 20, 100, 100));
+
+    //img.rows = 100;
+    //img.cols = 100;
+
+    @endverbatim
+
+  ***********************************************************************/
+void viewToImage(image& img, const imageView& v)
+{
+    image result = img;
+
+    result.rows = v.rows;
+    result.cols = v.cols;
+
+    //allocate arrays for the view
+    result.redGray = alloc2D(v.rows, v.cols);
+    result.green = alloc2D(v.rows, v.cols);
+    result.blue = alloc2D(v.rows, v.cols);
+
+    //if memory allocation fails
+    if ((result.redGray == nullptr) || (result.green == nullptr) || (result.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    copyView(v, makeView(result));
+
+    //freeing up the old arrays
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+
+    img = result;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Crops the image to the region of w x h pixels whose top left corner is column x and row y.
+  * Only the pixels inside the region are copied.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] x - the first column of the region.
+  * @param[in] y - the first row of the region.
+  * @param[in] w - the width of the region.
+  * @param[in] h - the height of the region.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //cropping an image of dimensions 210 x 771
+    img.rows = 210;
+    img.cols = 771;
+
+    cropImage(img, 100, 10, 300, 150);
+
+    //img now contains the region of dimensions 150 x 300.
+    //img.rows = 150;
+    //img.cols = 300;
+
+    @endverbatim
+
+  ***********************************************************************/
+void cropImage(image& img, int x, int y, int w, int h)
+{
+    viewToImage(img, cropView(makeView(img), x, y, w, h));
+}
@@ -0,0 +1,540 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that rotate images by any angle and apply affine warps
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Width and height of the output tiles that the warp is done in.
+ */
+const int WARP_TILE = 64;
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the pixels are sampled one at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WARP_SSE2
+#endif
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the value of a channel at row i and column j, or 0 if the position lies outside
+  * of the image. Used for the pixels on the border of the source image, where some of the
+  * four neighbours of a bilinear sample are missing.
+  *
+  * @param[in] channel - the 2D array of the channel.
+  * @param[in] rows - the number of rows of the channel.
+  * @param[in] cols - the number of columns of the channel.
+  * @param[in] i - the row.
+  * @param[in] j - the column.
+  *
+  * @returns the pixel value, 0 outside of the image
+  *
+  * @par Example:
+    @verbatim
+
+    int p = pixelOrZero(img.redGray, img.rows, img.cols, -1, 5);
+
+    //p is 0
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline int pixelOrZero(pixel** channel, int rows, int cols, long long i, long long j)
+{
+    if (i < 0 || j < 0 || i >= rows || j >= cols)
+    {
+        return 0;
+    }
+
+    return channel[i][j];
+}
+
+
+#ifdef WARP_SSE2
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns true if all four neighbours of the 16.16 fixed point source position are inside the source.
+  *
+  * @param[in] sx - the source column, 16.16 fixed point.
+  * @param[in] sy - the source row, 16.16 fixed point.
+  * @param[in] rows - the number of rows of the source image.
+  * @param[in] cols - the number of columns of the source image.
+  *
+  * @returns true if the position can be sampled without checking its neighbours
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    warpInside(5 << 16, 7 << 16, 10, 10);
+
+    //returns true
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline bool warpInside(long long sx, long long sy, int rows, int cols)
+{
+    return sx >= 0 && sy >= 0 && (sx >> 16) < cols - 1 && (sy >> 16) < rows - 1;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Samples 8 output pixels whose four neighbours are all inside the source, with the same weights and
+  * rounding as warpRun. The two neighbours of each pixel in the upper row are gathered next to each
+  * other and multiplied by 256 - fx and fx with madd, and likewise for the lower row. The two sums fit
+  * in 16 bits without a sign, and are multiplied by 256 - fy and fy with the low and high halves of a
+  * 16 bit multiply. The total is the same integer as in warpRun, so the result does not depend on SSE2.
+  *
+  * @param[in] src - the three channels of the source image.
+  * @param[out] dst - the first of the 8 pixels in each of the three output channels.
+  * @param[in] sx - the source column of the first pixel, 16.16 fixed point.
+  * @param[in] sy - the source row of the first pixel, 16.16 fixed point.
+  * @param[in] dx - the step of the source column per output pixel.
+  * @param[in] dy - the step of the source row per output pixel.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel* const out[3] = { dst[0] + j, dst[1] + j, dst[2] + j };
+
+    warpEight(src, out, sx, sy, dx, dy);
+
+    //8 pixels starting at column j are filled in
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline void warpEight(pixel** const src[3], pixel* const dst[3], long long sx, long long sy,
+    long long dx, long long dy)
+{
+    //loop variables
+    int k = 0;
+    int c = 0;
+
+    int ix[8], iy[8];
+    short wx[16], wy0[8], wy1[8];
+    short upper[8], lower[8];
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi32(32768);
+    const __m128i sign = _mm_set1_epi16((short)0x8000);
+    __m128i pairs, h0, h1, lo, hi, x0, x1, y0, y1;
+
+    for (k = 0; k < 8; k++, sx += dx, sy += dy)
+    {
+        ix[k] = (int)(sx >> 16);
+        iy[k] = (int)(sy >> 16);
+
+        wx[2 * k + 1] = (short)((sx >> 8) & 255);
+        wx[2 * k] = (short)(256 - wx[2 * k + 1]);
+        wy1[k] = (short)((sy >> 8) & 255);
+        wy0[k] = (short)(256 - wy1[k]);
+    }
+
+    x0 = _mm_loadu_si128((const __m128i*)wx);
+    x1 = _mm_loadu_si128((const __m128i*)(wx + 8));
+    y0 = _mm_loadu_si128((const __m128i*)wy0);
+    y1 = _mm_loadu_si128((const __m128i*)wy1);
+
+    for (c = 0; c < 3; c++)
+    {
+        for (k = 0; k < 8; k++)
+        {
+            memcpy(upper + k, src[c][iy[k]] + ix[k], 2);
+            memcpy(lower + k, src[c][iy[k] + 1] + ix[k], 2);
+        }
+
+        //each row as 8 sums of two neighbours, at most 65280, moved into 16 bits by taking off 32768
+        pairs = _mm_set_epi16(upper[7], upper[6], upper[5], upper[4], upper[3], upper[2], upper[1], upper[0]);
+        lo = _mm_madd_epi16(_mm_unpacklo_epi8(pairs, zero), x0);
+        hi = _mm_madd_epi16(_mm_unpackhi_epi8(pairs, zero), x1);
+        h0 = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(lo, offset), _mm_sub_epi32(hi, offset)), sign);
+
+        pairs = _mm_set_epi16(lower[7], lower[6], lower[5], lower[4], lower[3], lower[2], lower[1], lower[0]);
+        lo = _mm_madd_epi16(_mm_unpacklo_epi8(pairs, zero), x0);
+        hi = _mm_madd_epi16(_mm_unpackhi_epi8(pairs, zero), x1);
+        h1 = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(lo, offset), _mm_sub_epi32(hi, offset)), sign);
+
+        //the 32 bit products of the rows and their weights
+        lo = _mm_add_epi32(_mm_unpacklo_epi16(_mm_mullo_epi16(h0, y0), _mm_mulhi_epu16(h0, y0)),
+            _mm_unpacklo_epi16(_mm_mullo_epi16(h1, y1), _mm_mulhi_epu16(h1, y1)));
+        hi = _mm_add_epi32(_mm_unpackhi_epi16(_mm_mullo_epi16(h0, y0), _mm_mulhi_epu16(h0, y0)),
+            _mm_unpackhi_epi16(_mm_mullo_epi16(h1, y1), _mm_mulhi_epu16(h1, y1)));
+
+        lo = _mm_srli_epi32(_mm_add_epi32(lo, offset), 16);
+        hi = _mm_srli_epi32(_mm_add_epi32(hi, offset), 16);
+        lo = _mm_packs_epi32(lo, hi);
+
+        _mm_storel_epi64((__m128i*)dst[c], _mm_packus_epi16(lo, lo));
+    }
+}
+#endif
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Fills one run of output pixels of a warp. The source position of the first pixel is given in
+  * 16.16 fixed point, and each following pixel steps by dx and dy, so no multiplications are needed
+  * to find the source positions. The top 8 bits of the fraction are used as bilinear weights. When
+  * all four neighbours are inside the source image they are read directly; on the border the missing
+  * neighbours count as black, and positions that are entirely outside of the source are black.
+  * All three channels are sampled with the same weights. With SSE2, while the first and the eighth of the
+  * next 8 pixels have all four neighbours inside, the 8 are sampled at once by warpEight. The positions
+  * move in a straight line, so the pixels between them are inside as well.
+  *
+  * @param[in] src - the three channels of the source image.
+  * @param[in] rows - the number of rows of the source image.
+  * @param[in] cols - the number of columns of the source image.
+  * @param[out] dst - the first pixel of the run in each of the three output channels.
+  * @param[in] count - the number of pixels in the run.
+  * @param[in] sx - the source column of the first pixel, 16.16 fixed point.
+  * @param[in] sy - the source row of the first pixel, 16.16 fixed point.
+  * @param[in] dx - the step of the source column per output pixel.
+  * @param[in] dy - the step of the source row per output pixel.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel* src[3] = { img.redGray, img.green, img.blue };
+    pixel* dst[3] = { red[i] + j, green[i] + j, blue[i] + j };
+
+    warpRun(src, img.rows, img.cols, dst, 64, sx, sy, dx, dy);
+
+    //64 pixels of row i starting at column j are filled in
+
+    @endverbatim
+
+  ***********************************************************************/
+static void warpRun(pixel** const src[3], int rows, int cols, pixel* const dst[3], int count,
+    long long sx, long long sy, long long dx, long long dy)
+{
+    //loop variables
+    int j = 0;
+    int c = 0;
+
+    long long ix = 0;
+    long long iy = 0;
+    int fx = 0;
+    int fy = 0;
+    int w00, w01, w10, w11;
+
+    for (j = 0; j < count; j++, sx += dx, sy += dy)
+    {
+#ifdef WARP_SSE2
+        while (j + 8 <= count && warpInside(sx, sy, rows, cols) && warpInside(sx + 7 * dx, sy + 7 * dy, rows, cols))
+        {
+            pixel* const out[3] = { dst[0] + j, dst[1] + j, dst[2] + j };
+
+            warpEight(src, out, sx, sy, dx, dy);
+
+            j += 8;
+            sx += 8 * dx;
+            sy += 8 * dy;
+        }
+
+        if (j == count)
+        {
+            break;
+        }
+#endif
+
+        ix = sx >> 16;
+        iy = sy >> 16;
+
+        //entirely outside of the source
+        if (ix < -1 || iy < -1 || ix >= cols || iy >= rows)
+        {
+            dst[0][j] = 0;
+            dst[1][j] = 0;
+            dst[2][j] = 0;
+            continue;
+        }
+
+        //bilinear weights, they add up to 65536
+        fx = (int)((sx >> 8) & 255);
+        fy = (int)((sy >> 8) & 255);
+
+        w00 = (256 - fx) * (256 - fy);
+        w01 = fx * (256 - fy);
+        w10 = (256 - fx) * fy;
+        w11 = fx * fy;
+
+        //all four neighbours inside the source
+        if (ix >= 0 && iy >= 0 && ix < cols - 1 && iy < rows - 1)
+        {
+            for (c = 0; c < 3; c++)
+            {
+                const pixel* r0 = src[c][iy] + ix;
+                const pixel* r1 = src[c][iy + 1] + ix;
+
+                dst[c][j] = (pixel)((r0[0] * w00 + r0[1] * w01 + r1[0] * w10 + r1[1] * w11 + 32768) >> 16);
+            }
+        }
+
+        //on the border
+        else
+        {
+            for (c = 0; c < 3; c++)
+            {
+                dst[c][j] = (pixel)((pixelOrZero(src[c], rows, cols, iy, ix) * w00 +
+                    pixelOrZero(src[c], rows, cols, iy, ix + 1) * w01 +
+                    pixelOrZero(src[c], rows, cols, iy + 1, ix) * w10 +
+                    pixelOrZero(src[c], rows, cols, iy + 1, ix + 1) * w11 + 32768) >> 16);
+            }
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies an affine warp to the image. The inverse matrix maps the column and row of every output
+  * pixel back to a position in the source image:
+  *
+  *     source column = inverse[0] * x + inverse[1] * y + inverse[2]
+  *     source row    = inverse[3] * x + inverse[4] * y + inverse[5]
+  *
+  * where x and y are measured from the top left corner and pixel centers sit at .5. The output is
+  * filled in tiles of WARP_TILE x WARP_TILE pixels, so that the source pixels needed by a tile are
+  * close together even when the image is rotated, and the rows of tiles are split into strips that
+  * run in parallel. Within a tile each row is filled by warpRun, which steps the source position
+  * in fixed point. Pixels that map outside of the source are black. The old arrays are freed and
+  * the rows and columns of the structure are set to the new dimensions.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] inverse - the matrix that maps output positions to source positions.
+  * @param[in] newRows - the number of rows of the output.
+  * @param[in] newCols - the number of columns of the output.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //shifting an image 10 pixels to the right
+    double inverse[6] = { 1, 0, -10, 0, 1, 0 };
+
+    warpAffine(img, inverse, img.rows, img.cols);
+
+    //img is shifted and the first 10 columns are black
+
+    @endverbatim
+
+  ***********************************************************************/
+void warpAffine(image& img, const double inverse[6], int newRows, int newCols)
+{
+    pixel** red = nullptr;
+    pixel** green = nullptr;
+    pixel** blue = nullptr;
+
+    int tileRows = (newRows + WARP_TILE - 1) / WARP_TILE;
+    int tileCols = (newCols + WARP_TILE - 1) / WARP_TILE;
+
+    if (newRows <= 0 || newCols <= 0)
+    {
+        cout << "Invalid Warp Dimensions" << endl;
+        exit(0);
+    }
+
+    //allocate the output arrays
+    red = alloc2D(newRows, newCols);
+    green = alloc2D(newRows, newCols);
+    blue = alloc2D(newRows, newCols);
+
+    //if memory allocation fails
+    if (red == nullptr || green == nullptr || blue == nullptr)
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    //fixed point steps along an output row
+    long long dx = llround(inverse[0] * 65536.0);
+    long long dy = llround(inverse[3] * 65536.0);
+
+    pixel** const src[3] = { img.redGray, img.green, img.blue };
+
+    parallelFor(0, tileRows, [&](int tileStart, int tileEnd)
+    {
+        int t, u, i, first, count;
+        double x, y;
+        long long sx, sy;
+
+        for (t = tileStart; t < tileEnd; t++)
+        {
+            for (u = 0; u < tileCols; u++)
+            {
+                first = u * WARP_TILE;
+                count = min(WARP_TILE, newCols - first);
+
+                for (i = t * WARP_TILE; i < min((t + 1) * WARP_TILE, newRows); i++)
+                {
+                    //source position of the first pixel, moved from pixel centers to pixel corners
+                    x = first + 0.5;
+                    y = i + 0.5;
+
+                    sx = llround((inverse[0] * x + inverse[1] * y + inverse[2] - 0.5) * 65536.0);
+                    sy = llround((inverse[3] * x + inverse[4] * y + inverse[5] - 0.5) * 65536.0);
+
+                    pixel* const dst[3] = { red[i] + first, green[i] + first, blue[i] + first };
+
+                    warpRun(src, img.rows, img.cols, dst, count, sx, sy, dx, dy);
+                }
+            }
+        }
+    });
+
+    //replacing the arrays of the structure
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+
+    img.redGray = red;
+    img.green = green;
+    img.blue = blue;
+
+    //changing the values of rows and columns
+    img.rows = newRows;
+    img.cols = newCols;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Rotates the image clockwise by any angle in degrees. Negative angles rotate counter clockwise.
+  * The output is made just large enough to hold the whole rotated image and the corners that are
+  * not covered are black. The rotation is about the center of the image, and is turned into the
+  * inverse matrix that warpAffine needs.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] degrees - the angle to rotate by, clockwise.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //deskewing a scan of dimensions 3000 x 2000 that is 2 degrees off
+    img.rows = 3000;
+    img.cols = 2000;
+
+    rotateAngle(img, -2.0);
+
+    //img now contains the straightened scan of dimensions 3069 x 2104.
+
+    @endverbatim
+
+  ***********************************************************************/
+void rotateAngle(image& img, double degrees)
+{
+    const double pi = 3.14159265358979323846;
+
+    double angle = degrees * pi / 180.0;
+    double c = cos(angle);
+    double s = sin(angle);
+
+    double inverse[6];
+
+    int newRows = 0;
+    int newCols = 0;
+
+    //centers of the source and output
+    double cx = img.cols / 2.0;
+    double cy = img.rows / 2.0;
+    double ncx = 0;
+    double ncy = 0;
+
+    //size of the bounding box of the rotated image
+    newCols = (int)ceil(fabs(img.cols * c) + fabs(img.rows * s) - 1e-6);
+    newRows = (int)ceil(fabs(img.cols * s) + fabs(img.rows * c) - 1e-6);
+
+    ncx = newCols / 2.0;
+    ncy = newRows / 2.0;
+
+    //rotate back by the angle about the centers
+    inverse[0] = c;
+    inverse[1] = s;
+    inverse[2] = cx - c * ncx - s * ncy;
+    inverse[3] = -s;
+    inverse[4] = c;
+    inverse[5] = cy + s * ncx - c * ncy;
+
+    warpAffine(img, inverse, newRows, newCols);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies the affine transform given by the matrix to the image. The matrix maps a source column
+  * x and row y to the output position
+  *
+  *     output column = matrix[0] * x + matrix[1] * y + matrix[2]
+  *     output row    = matrix[3] * x + matrix[4] * y + matrix[5]
+  *
+  * which covers scaling, shearing, rotating, and translating. The output keeps the dimensions of the
+  * source image. The matrix is inverted and passed on to warpAffine. If the matrix cannot be inverted,
+  * a message is outputted and the program exits.
+  *
+  * @param[in,out] img - the struct of type image that is manipulated
+  * @param[in] matrix - the forward transform.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //shearing an image to the right by half a pixel per row
+    double matrix[6] = { 1, 0.5, 0, 0, 1, 0 };
+
+    affineTransform(img, matrix);
+
+    @endverbatim
+
+  ***********************************************************************/
+void affineTransform(image& img, const double matrix[6])
+{
+    double det = matrix[0] * matrix[4] - matrix[1] * matrix[3];
+    double inverse[6];
+
+    if (fabs(det) < 1e-12)
+    {
+        cout << "Invalid Affine Matrix" << endl;
+        exit(0);
+    }
+
+    //invert the 2x2 part and the translation
+    inverse[0] = matrix[4] / det;
+    inverse[1] = -matrix[1] / det;
+    inverse[3] = -matrix[3] / det;
+    inverse[4] = matrix[0] / det;
+    inverse[2] = -(inverse[0] * matrix[2] + inverse[1] * matrix[5]);
+    inverse[5] = -(inverse[3] * matrix[2] + inverse[4] * matrix[5]);
+
+    warpAffine(img, inverse, img.rows, img.cols);
+}
@@ -1,93 +1,547 @@
-#pragma once
-
-/** *********************************************************************
- * @file
- *
- * @brief Contains the includes, definitions, strucutre, typedef, and 
- *        the prototypes for all the functions used in the program.
- ***********************************************************************/
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <iomanip>
-using namespace std;
-
-/**
- * @brief Prevents multiple declarations
- * 
- */
-#ifndef __NETPBM__H__
-#define __NETPBM__H__
-
-/************************************************************************
- *             Typedefs and Strucutres
- ***********************************************************************/
-
- /**
- * @brief The datatype of the 2D arrays used to store image data.
- */
-typedef unsigned char pixel;
-
-
- /**
- * @brief Holds the image data from the file. Passed around to different functions in the program. 
- *        Passed by reference only when necessary.
- */
-struct image
-{
-    string magicNumber;   /**< The number which specifies if the file contains binary or ascii data. */
-    string comment;       /**< The comments which start with a # symbol. Saved and printed to output file. */
-    int rows;             /**< Height of the image. */
-    int cols;             /**< Width of the image. */
-    pixel** redGray;      /**< Dynamic 2D array which stores all the data for the red channel of the image. */
-    pixel** green;        /**< Dynamic 2D array which stores all the data for the green channel of the image. */
-    pixel** blue;         /**< Dynamic 2D array which stores all the data for the blue channel of the image. */
-
-};
-
-
-
-/************************************************************************
- *                         Function Prototypes
- ***********************************************************************/
-
-//imageFileIO prototypes
-bool openInputFile(ifstream& bfin, string filename);
-
-void readMagicNum(ifstream& bfin, image& img, int& max_pix_val);
-
-void readFileP3(ifstream& fin, image &img, int &max_pix_val);
-
-void readFileP6(ifstream& fin, image& img, int& max_pix_val);
-
-void outputP3(ofstream& fout, image img, string basename, int max_pix_val);
-
-void outputP6(ofstream& fout, image img, string basename, int max_pix_val);
-
-void outputGrayP2(ofstream& fout, image img, string basename, int max_pix_val);
-
-void outputGrayP5(ofstream& fout, image img, string basename, int max_pix_val);
-
-void outputUsage();
-
-//memory prototypes
-//void alloc2D (pixel **&ptr, int row, int cols);
-pixel** alloc2D(int rows, int cols);
-
-void free2D (pixel**& ptr, int rows);
-
-void copy2D(pixel**& ptr1, pixel** ptr2, int rows, int cols);
-
-//image operations prototypes
-void rotateClockWise( image &img);
-
-void rotateCounterClockWise(image& img);
-
-void flipAxisX(image &img);
-
-void flipAxisY(image& img);
-
-void convertGrayScale(image& img);
-
-void convertSepia(image& img);
+#pragma once
+
+/** *********************************************************************
+ * @file
+ *
+ * @brief Contains the includes, definitions, strucutre, typedef, and 
+ *        the prototypes for all the functions used in the program.
+ ***********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <iomanip>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <cstddef>
+#include <climits>
+#include <chrono>
+#include <filesystem>
+using namespace std;
+
+/**
+ * @brief Prevents multiple declarations
+ * 
+ */
+#ifndef __NETPBM__H__
+#define __NETPBM__H__
+
+/************************************************************************
+ *             Typedefs and Strucutres
+ ***********************************************************************/
+
+ /**
+ * @brief The datatype of the 2D arrays used to store image data.
+ */
+typedef unsigned char pixel;
+
+
+ /**
+ * @brief Holds the image data from the file. Passed around to different functions in the program. 
+ *        Passed by reference only when necessary.
+ */
+struct image
+{
+    string magicNumber;   /**< The number which specifies if the file contains binary or ascii data. */
+    string comment;       /**< The comments which start with a # symbol. Saved and printed to output file. */
+    int rows;             /**< Height of the image. */
+    int cols;             /**< Width of the image. */
+    pixel** redGray;      /**< Dynamic 2D array which stores all the data for the red channel of the image. */
+    pixel** green;        /**< Dynamic 2D array which stores all the data for the green channel of the image. */
+    pixel** blue;         /**< Dynamic 2D array which stores all the data for the blue channel of the image. */
+    pixel** alpha = nullptr; /**< Dynamic 2D array of the opacity of each pixel, 0 to 255, or nullptr if the image is opaque. */
+
+};
+
+
+/**
+ * @brief Number of bytes at the start of a file that probeHeader reads.
+ */
+const int PROBE_BYTES = 4096;
+
+
+/**
+ * @brief The header of a netPBM file, as read by probeHeader without reading the image.
+ */
+struct imageHeader
+{
+    bool valid = false;             /**< True if the header is valid and the file is long enough. */
+    string error;                   /**< Why the file is not valid. */
+    string magicNumber;             /**< The magic number, P1 to P7, or qoif for QOI files. */
+    string comment;                 /**< The comment lines of the header. */
+    int cols = 0;                   /**< Width of the image. */
+    int rows = 0;                   /**< Height of the image. */
+    int maxValue = 0;               /**< Maximum pixel value, 1 for bilevel images. */
+    long long dataOffset = 0;       /**< Offset of the first byte of image data. */
+    long long fileSize = 0;         /**< Size of the file in bytes, compressed if it is a gzip file. */
+    bool compressed = false;        /**< True for a gzip file, whose size is not checked. */
+    long long expectedSize = 0;     /**< Size a binary file must have to hold every pixel, 0 for ascii. */
+};
+
+
+/**
+ * @brief A window into the channels of an image that does not own or copy any pixels.
+ *        The pixel at row i and column j of a channel is at channel[i * rowStride + j * colStride].
+ *        Negative strides give flipped views and swapped strides give rotated views.
+ */
+struct imageView
+{
+    pixel* red;             /**< The first pixel of the red channel, or of the gray channel. */
+    pixel* green;           /**< The first pixel of the green channel. */
+    pixel* blue;            /**< The first pixel of the blue channel. */
+    int rows;               /**< Height of the view. */
+    int cols;               /**< Width of the view. */
+    ptrdiff_t rowStride;    /**< Distance in pixels from a pixel to the one below it. May be negative. */
+    ptrdiff_t colStride;    /**< Distance in pixels from a pixel to the one on its right. May be negative. */
+};
+
+
+/**
+ * @brief The histogram and statistics of each channel of an image.
+ */
+struct imageStats
+{
+    int channels;                               /**< Number of channels measured, 3 for color and 1 for grayscale. */
+    unsigned long long pixels;                  /**< Number of pixels in the image. */
+    unsigned long long histogram[3][256];       /**< Number of pixels with each value, for every channel. */
+    int minimum[3];                             /**< Darkest value of every channel. */
+    int maximum[3];                             /**< Brightest value of every channel. */
+    double mean[3];                             /**< Average value of every channel. */
+};
+
+
+/**
+ * @brief The filters that can be used to resize an image.
+ */
+enum resizeFilter
+{
+    FILTER_BOX,         /**< Averages the source pixels covered by each output pixel. */
+    FILTER_BILINEAR,    /**< Linear interpolation between neighbouring pixels. */
+    FILTER_LANCZOS3     /**< Windowed sinc with three lobes. Sharpest, slowest. */
+};
+
+
+/**
+ * @brief The ways pixels can be mapped to the colors of a palette.
+ */
+enum ditherMethod
+{
+    DITHER_NONE,        /**< Each pixel becomes the closest color. */
+    DITHER_BAYER,       /**< Ordered dithering with an 8 x 8 Bayer matrix. Fully parallel. */
+    DITHER_FLOYD        /**< Floyd-Steinberg error diffusion. Smoothest, rows run on a wavefront. */
+};
+
+
+/**
+ * @brief What the edge detection in imageEdges.cpp writes for each pixel.
+ */
+enum edgeOutput
+{
+    EDGE_MAGNITUDE,     /**< The length of the gradient, 0 where the image is flat. */
+    EDGE_X,             /**< The horizontal gradient, 128 where the image is flat. */
+    EDGE_Y              /**< The vertical gradient, 128 where the image is flat. */
+};
+
+
+/**
+ * @brief Bits of an orientation, which is any combination of flips and 90 degree rotations.
+ *        The transpose is applied first, then the flips. ORIENT_NONE leaves the image as it is.
+ */
+const int ORIENT_NONE = 0;
+const int ORIENT_FLIP_Y = 1;        /**< Mirror the columns. */
+const int ORIENT_FLIP_X = 2;        /**< Mirror the rows. */
+const int ORIENT_TRANSPOSE = 4;     /**< Swap the rows and the columns. */
+
+
+/**
+ * @brief Width and height of the tiles of a tiled image, and its power of two.
+ */
+const int TILE_SHIFT = 6;
+const int TILE_SIZE = 1 << TILE_SHIFT;
+
+
+/**
+ * @brief An image stored in square tiles of TILE_SIZE x TILE_SIZE pixels instead of rows.
+ *        The tiles are stored row of tiles by row of tiles and the pixels of a tile row by row,
+ *        so pixels that are close together in the image are close together in memory.
+ */
+struct tiledImage
+{
+    int rows = 0;               /**< Height of the image. */
+    int cols = 0;               /**< Width of the image. */
+    int tileRows = 0;           /**< Number of rows of tiles, rounded up. */
+    int tileCols = 0;           /**< Number of columns of tiles, rounded up. */
+    pixel* red = nullptr;       /**< The tiles of the red channel, or of the gray channel. */
+    pixel* green = nullptr;     /**< The tiles of the green channel. */
+    pixel* blue = nullptr;      /**< The tiles of the blue channel. */
+};
+
+
+/**
+ * @brief The state that a QOI encoder or decoder carries from one pixel to the next, so an
+ *        image can be encoded or decoded a batch of pixels at a time.
+ */
+struct qoiState
+{
+    unsigned char index[64][4];     /**< Recently seen pixels, by their hash. */
+    unsigned char px[4];            /**< The previous pixel as red, green, blue, and alpha. */
+    int run;                        /**< Length of the current run of the previous pixel. */
+};
+
+
+/**
+ * @brief A single image operation from the command line together with its arguments.
+ */
+struct operation
+{
+    string option;          /**< The option code, for example --rotateCW. */
+    vector<string> args;    /**< The arguments that followed the option code. */
+};
+
+
+/**
+ * @brief One output of the --fanout mode: the operations applied to a shared copy of the
+ *        image, and the type and basename of the file that the result is written to.
+ */
+struct outputBranch
+{
+    vector<operation> ops;  /**< The operations in the order they were given. */
+    string opType;          /**< The output type, --ascii, --binary, --qoi, or --pam. */
+    string basename;        /**< The basename of the output file. */
+};
+
+
+/**
+ * @brief The state of an xxHash64 that is computed a piece at a time.
+ */
+struct xxHashState
+{
+    unsigned long long lane[4];     /**< The four lanes that 32 bytes at a time are mixed into. */
+    unsigned long long seed;        /**< The seed the hash was started with. */
+    unsigned long long total;       /**< Number of bytes added so far. */
+    unsigned char buffer[32];       /**< Bytes added that do not yet fill 32. */
+    size_t buffered;                /**< Number of bytes in buffer. */
+};
+
+
+
+/************************************************************************
+ *                         Function Prototypes
+ ***********************************************************************/
+
+//imageFileIO prototypes
+bool openInputFile(ifstream& bfin, string filename);
+
+void openOutputFile(ofstream& fout, string basename, string extension, bool binary);
+
+string outputFileName(string basename, string extension);
+
+string outputExtension(ios& stream);
+
+void closeOutputFile(ofstream& fout);
+
+void readMagicNum(ifstream& bfin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readHeader(ifstream& bfin, image& img, int& max_pix_val);
+
+void readFileP3(ifstream& fin, image &img, int &max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileP6(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileP2(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileP5(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileP1(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileP4(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFileQoi(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readFilePam(ifstream& fin, image& img, int& max_pix_val, int reduce = 1, int orient = ORIENT_NONE);
+
+void readRegion(ifstream& bfin, image& img, int& max_pix_val, const int region[4], int reduce = 1, int orient = ORIENT_NONE);
+
+void outputP3(ofstream& fout, image img, string basename, int max_pix_val, int orient = ORIENT_NONE);
+
+void outputP6(ofstream& fout, image img, string basename, int max_pix_val, int orient = ORIENT_NONE);
+
+void outputGrayP2(ofstream& fout, image img, string basename, int max_pix_val, int orient = ORIENT_NONE);
+
+void outputGrayP5(ofstream& fout, image img, string basename, int max_pix_val, int orient = ORIENT_NONE);
+
+void outputP1(ofstream& fout, image& img, string basename, int orient = ORIENT_NONE);
+
+void outputP4(ofstream& fout, image& img, string basename, int orient = ORIENT_NONE);
+
+void outputQoi(ofstream& fout, image img, string basename, int max_pix_val, bool grayOutput, int orient = ORIENT_NONE);
+
+void outputPam(ofstream& fout, image img, string basename, int max_pix_val, bool grayOutput, int orient = ORIENT_NONE);
+
+void outputImage(ofstream& fout, image& img, string opType, string basename, int max_pix_val, bool grayOutput, int orient);
+
+void outputUsage();
+
+bool probeHeader(string filename, imageHeader& header);
+
+void outputProbeJson(string filename, const imageHeader& header);
+
+//command line prototypes
+int optionArgCount(string option);
+
+bool parseIntList(string text, char separator, vector<int>& values);
+
+bool parseDoubleList(string text, char separator, vector<double>& values);
+
+bool parseCommandLine(int argc, char** argv, vector<operation>& ops, string& opType, string& basename, string& filename);
+
+void applyOperation(image& img, const operation& op, bool& grayOutput);
+
+void applyOperations(image& img, const vector<operation>& ops, bool& grayOutput);
+
+int decodeReduce(const vector<operation>& ops);
+
+bool decodeRegion(const vector<operation>& ops, int region[4]);
+
+bool parseFanout(int argc, char** argv, string& filename, vector<outputBranch>& branches);
+
+bool parseBatch(int argc, char** argv, vector<operation>& ops, string& opType, string& suffix, vector<string>& files);
+
+int orientationOf(const operation& op);
+
+int fuseDecodeOrientation(vector<operation>& ops);
+
+int fuseEncodeOrientation(vector<operation>& ops);
+
+//memory prototypes
+//void alloc2D (pixel **&ptr, int row, int cols);
+pixel** alloc2D(int rows, int cols);
+
+void free2D (pixel**& ptr, int rows);
+
+void copy2D(pixel**& ptr1, pixel** ptr2, int rows, int cols);
+
+void copyImage(image& src, image& dst);
+
+//thread prototypes
+int threadCount();
+
+void parallelFor(int first, int last, const function<void(int, int)>& body);
+
+//image operations prototypes
+void rotateClockWise( image &img);
+
+void rotateCounterClockWise(image& img);
+
+void flipAxisX(image &img);
+
+void flipAxisY(image& img);
+
+void convertGrayScale(image& img);
+
+void spreadGray(image& img);
+
+void convertSepia(image& img);
+
+void rotateClockWise(const imageView& src, const imageView& dst);
+
+void rotateCounterClockWise(const imageView& src, const imageView& dst);
+
+void flipAxisX(const imageView& src, const imageView& dst);
+
+void flipAxisY(const imageView& src, const imageView& dst);
+
+void convertGrayScale(const imageView& src, const imageView& dst);
+
+void convertSepia(const imageView& src, const imageView& dst);
+
+//image statistics prototypes
+void computeStats(image& img, imageStats& stats, int channels);
+
+void streamStats(ifstream& bfin, imageStats& stats);
+
+void printStats(const imageStats& stats);
+
+void autoLevels(image& img, int channels);
+
+void equalizeHistogram(image& img, int channels);
+
+//image view prototypes
+imageView makeView(image& img);
+
+imageView cropView(const imageView& v, int x, int y, int w, int h);
+
+imageView flipViewX(const imageView& v);
+
+imageView flipViewY(const imageView& v);
+
+imageView rotateViewCW(const imageView& v);
+
+imageView rotateViewCCW(const imageView& v);
+
+imageView transposeView(const imageView& v);
+
+imageView orientView(const imageView& v, int orient);
+
+int combineOrientation(int first, int second);
+
+int inverseOrientation(int orient);
+
+void copyView(const imageView& src, const imageView& dst);
+
+void viewToImage(image& img, const imageView& v);
+
+void cropImage(image& img, int x, int y, int w, int h);
+
+//image resize prototypes
+void resizeImage(image& img, int newRows, int newCols, resizeFilter filter);
+
+void downscaleBox(image& img, int factor);
+
+void thumbnail(image& img, int maxSize);
+
+//image quantize prototypes
+void buildPalette(image& img, int colors, vector<double>& palette);
+
+void quantizeImage(image& img, int colors, ditherMethod method, int channels);
+
+//image edges prototypes
+void detectEdges(image& img, bool scharr, edgeOutput output, bool& grayOutput);
+
+//image filter prototypes
+void medianFilter(image& img, int radius, int channels);
+
+void morphImage(image& img, int radius, bool dilate, int channels);
+
+//PAM and alpha prototypes
+bool readPamHeader(istream& bfin, image& img, int& max_pix_val, int& depth, bool& alpha, bool& bilevel);
+
+void writePamHeader(ostream& out, const string& comment, int cols, int rows, int depth, int max_pix_val, string type);
+
+void applyToAlpha(image& img, const function<void(image&)>& transform);
+
+void compositeImage(image& img, image& over, int x, int y);
+
+void overlayImage(image& img, string filename, int x, int y, bool& grayOutput);
+
+//image warp prototypes
+void warpAffine(image& img, const double inverse[6], int newRows, int newCols);
+
+void rotateAngle(image& img, double degrees);
+
+void affineTransform(image& img, const double matrix[6]);
+
+//tiled image prototypes
+void toTiled(image& img, tiledImage& t);
+
+void fromTiled(tiledImage& t, image& img);
+
+void freeTiled(tiledImage& t);
+
+void rotateTiledCW(tiledImage& t);
+
+void rotateTiledCCW(tiledImage& t);
+
+void flipTiledX(tiledImage& t);
+
+void flipTiledY(tiledImage& t);
+
+void grayTiled(tiledImage& t);
+
+void sepiaTiled(tiledImage& t);
+
+bool tiledOperation(const operation& op);
+
+void applyTiledOperation(tiledImage& t, const operation& op, bool& grayOutput);
+
+//transcode prototypes
+void streamAsciiSamples(ifstream& bfin, unsigned long long total, const function<void(const pixel*, size_t)>& consume);
+
+void transcodeImage(ifstream& bfin, ofstream& fout, string opType, string basename);
+
+//qoi prototypes
+void qoiReset(qoiState& state);
+
+void writeQoiHeader(ostream& out, int cols, int rows);
+
+bool readQoiHeader(ifstream& bfin, image& img, int& max_pix_val, bool* alpha = nullptr);
+
+void qoiEncode(qoiState& state, const pixel* rgb, size_t count, vector<unsigned char>& out);
+
+void qoiFinish(qoiState& state, vector<unsigned char>& out);
+
+size_t qoiDecode(qoiState& state, const unsigned char* in, size_t length, size_t& used, pixel* rgb, size_t count, int channels = 3);
+
+void streamQoiSamples(ifstream& bfin, unsigned long long pixels, const function<void(const pixel*, size_t)>& consume, int channels = 3);
+
+//bilevel prototypes
+bool isBilevel(const image& img);
+
+void thresholdImage(image& img, int level);
+
+void streamBilevelRows(ifstream& bfin, const image& img, bool ascii, const function<void(const pixel*, int)>& consume);
+
+void writeBilevelRows(ostream& fout, const pixel* gray, int cols, int rows, bool ascii);
+
+//gzip prototypes
+bool attachGzipInput(ifstream& fin);
+
+void attachGzipOutput(ofstream& fout);
+
+void finishGzipOutput(ofstream& fout);
+
+void detachGzip(ios& stream, streambuf* file);
+
+//fanout prototypes
+void runFanout(image& img, int max_pix_val, bool grayInput, const vector<outputBranch>& branches);
+
+//pipeline prototypes
+void runBatch(vector<operation> ops, string opType, string suffix, const vector<string>& files);
+
+//benchmark prototypes
+void runBenchmark(string filename);
+
+//compare prototypes
+void runCompare(string first, string second);
+
+//hash prototypes
+void xxHashInit(xxHashState& state, unsigned long long seed);
+
+void xxHashUpdate(xxHashState& state, const void* data, size_t size);
+
+unsigned long long xxHashFinal(const xxHashState& state);
+
+unsigned long long xxHash64(const void* data, size_t size, unsigned long long seed);
+
+unsigned int crc32c(unsigned int crc, const void* data, size_t size);
+
+bool takeChecksum(vector<operation>& ops);
+
+void setChecksum(ios& stream, bool enabled);
+
+bool checksumRequested(ios& stream);
+
+void attachChecksumOutput(ofstream& fout, string name);
+
+void finishChecksumOutput(ofstream& fout);
+
+//cache prototypes
+bool takeCacheDir(vector<operation>& ops, string& dir);
+
+string cacheKey(string filename, const vector<operation>& ops, string opType, string basename);
+
+bool cacheFetch(string dir, string key, string basename, ofstream& fout);
+
+void cacheStore(string dir, string key, string basename, ios& fout);
+
+void printCacheStats(string dir);
 #endif
\ No newline at end of file
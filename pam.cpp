@@ -0,0 +1,596 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains the PAM header functions and the alpha channel functions, including the overlay compositing
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief SSE2 is part of every x64 processor, so it is used whenever the compiler targets it.
+ *        Otherwise the overlay is blended one value at a time.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PAM_SSE2
+#endif
+
+/**
+ * @brief Longest line of a PAM header that is accepted.
+ */
+const size_t PAM_LINE = 1024;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Divides the product of two pixel values by 255 and rounds it, without a division. For any x
+  * from 0 to 255 * 255, adding 128 and then the result shifted right by 8, and shifting the sum
+  * right by 8, gives x / 255 rounded.
+  *
+  * @param[in] x - the product of two values from 0 to 255.
+  *
+  * @returns x / 255, rounded
+  *
+  * @par Example:
+    @verbatim
+
+    int v = div255(200 * 128);
+
+    //v is 100
+
+    @endverbatim
+
+  ***********************************************************************/
+static inline int div255(int x)
+{
+    x += 128;
+
+    return (x + (x >> 8)) >> 8;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the header of a PAM file from the start of the stream. A PAM header is the magic number P7
+  * followed by lines of a keyword and its value, WIDTH, HEIGHT, DEPTH, MAXVAL, and TUPLTYPE, and ends
+  * with the line ENDHDR. Comment lines start with a # and are saved in img.comment. The tuple type
+  * says what the DEPTH values of each pixel are. BLACKANDWHITE, GRAYSCALE, and RGB may be followed by
+  * _ALPHA, and a missing tuple type is taken from the depth: 1 is gray, 2 gray and alpha, 3 color,
+  * and 4 color and alpha. The image is given the magic number it is read as, P4 for black and white,
+  * P5 for gray, and P6 for color, so that it is written back the same way. Only values of one byte are
+  * supported. If the stream is not at a P7 header, it is put back at the start.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the file.
+  * @param[out] img - a strucutre of type image.
+  * @param[out] max_pix_val - maximum value of a pixel, 255 for black and white.
+  * @param[out] depth - the number of values of each pixel in the file.
+  * @param[out] alpha - true if the last value of each pixel is its alpha.
+  * @param[out] bilevel - true if the values are 0 and 1 for black and white.
+  *
+  * @returns true if the header is a valid PAM header, with the stream at the first byte of the image data
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    int depth;
+    bool alpha, bilevel;
+
+    if (readPamHeader(fin, img, max_pix_val, depth, alpha, bilevel))
+    {
+        //fin is at the first pixel, which has depth values
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+bool readPamHeader(istream& bfin, image& img, int& max_pix_val, int& depth, bool& alpha, bool& bilevel)
+{
+    string line;
+    string keyword;
+    string type;
+    long long value = 0;
+    long long width = 0;
+    long long height = 0;
+    long long maxval = 0;
+    bool valid = false;
+
+    depth = 0;
+    alpha = false;
+    bilevel = false;
+
+    bfin.clear();
+    bfin.seekg(0, ios::beg);
+
+    if (!getline(bfin, line) || line.size() > PAM_LINE || line.compare(0, 2, "P7") != 0 ||
+        line.find_first_not_of(" \t\r", 2) != string::npos)
+    {
+        bfin.clear();
+        bfin.seekg(0, ios::beg);
+        return false;
+    }
+
+    img.comment = "";
+
+    //a keyword and its value on each line
+    while (getline(bfin, line) && line.size() <= PAM_LINE)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (line[0] == '#')
+        {
+            img.comment += line + "\n";
+            continue;
+        }
+
+        istringstream fields(line);
+        fields >> keyword;
+
+        if (keyword == "ENDHDR")
+        {
+            break;
+        }
+
+        if (keyword == "TUPLTYPE")
+        {
+            fields >> type;
+            continue;
+        }
+
+        if (!(fields >> value) || value <= 0 || value > INT_MAX)
+        {
+            return false;
+        }
+
+        if (keyword == "WIDTH")
+        {
+            width = value;
+        }
+
+        else if (keyword == "HEIGHT")
+        {
+            height = value;
+        }
+
+        else if (keyword == "DEPTH")
+        {
+            depth = (int)value;
+        }
+
+        else if (keyword == "MAXVAL")
+        {
+            maxval = value;
+        }
+    }
+
+    if (keyword != "ENDHDR" || width == 0 || height == 0 || depth < 1 || depth > 4 || maxval == 0 || maxval > 255)
+    {
+        return false;
+    }
+
+    //the tuple type from the depth if it is missing
+    if (type.empty())
+    {
+        type = depth == 1 ? "GRAYSCALE" : depth == 2 ? "GRAYSCALE_ALPHA" : depth == 3 ? "RGB" : "RGB_ALPHA";
+    }
+
+    alpha = type.size() > 6 && type.compare(type.size() - 6, 6, "_ALPHA") == 0;
+    bilevel = type.compare(0, 13, "BLACKANDWHITE") == 0;
+
+    //the depth must match the tuple type
+    if (type.compare(0, 3, "RGB") == 0)
+    {
+        valid = depth == 3 + alpha;
+    }
+
+    else if (bilevel || type.compare(0, 9, "GRAYSCALE") == 0)
+    {
+        valid = depth == 1 + alpha;
+    }
+
+    if (!valid)
+    {
+        return false;
+    }
+
+    img.magicNumber = depth - alpha == 3 ? "P6" : bilevel ? "P4" : "P5";
+    img.cols = (int)width;
+    img.rows = (int)height;
+    max_pix_val = bilevel ? 255 : (int)maxval;
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes the header of a PAM file: the magic number P7, the comment of the image, the width, height,
+  * depth, maximum value, and tuple type, and the line ENDHDR. The image data follows straight after it.
+  *
+  * @param[in,out] out - the stream to write to.
+  * @param[in] comment - the comment lines, each starting with a #.
+  * @param[in] cols - width of the image.
+  * @param[in] rows - height of the image.
+  * @param[in] depth - the number of values of each pixel.
+  * @param[in] max_pix_val - maximum value of a pixel.
+  * @param[in] type - the tuple type, such as RGB_ALPHA.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    writePamHeader(fout, img.comment, img.cols, img.rows, 4, 255, "RGB_ALPHA");
+
+    @endverbatim
+
+  ***********************************************************************/
+void writePamHeader(ostream& out, const string& comment, int cols, int rows, int depth, int max_pix_val, string type)
+{
+    out << "P7" << "\n";
+    out << comment;
+    out << "WIDTH " << cols << "\n";
+    out << "HEIGHT " << rows << "\n";
+    out << "DEPTH " << depth << "\n";
+    out << "MAXVAL " << max_pix_val << "\n";
+    out << "TUPLTYPE " << type << "\n";
+    out << "ENDHDR" << "\n";
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies a change of shape, such as a rotation, crop, or resize, to the alpha channel of an image
+  * the same way it is applied to the colors. The alpha channel is put in the red channel of a
+  * temporary image with copies of it in the green and blue channels, so every operation can be
+  * used on it unchanged, and the red channel of the result becomes the new alpha channel. The
+  * image itself is not changed, so transform is then applied to it by the caller. Does nothing for
+  * an image without an alpha channel.
+  *
+  * @param[in,out] img - the image, with the size it has before the change.
+  * @param[in] transform - the change, applied to the temporary image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    applyToAlpha(img, [](image& a) { rotateClockWise(a); });
+    rotateClockWise(img);
+
+    //the colors and the alpha channel are both rotated
+
+    @endverbatim
+
+  ***********************************************************************/
+void applyToAlpha(image& img, const function<void(image&)>& transform)
+{
+    image a;
+
+    if (img.alpha == nullptr)
+    {
+        return;
+    }
+
+    a.rows = img.rows;
+    a.cols = img.cols;
+    a.redGray = img.alpha;
+    a.green = alloc2D(a.rows, a.cols);
+    a.blue = alloc2D(a.rows, a.cols);
+
+    //if memory allocation fails
+    if ((a.green == nullptr) || (a.blue == nullptr))
+    {
+        cout << "Memory Allocation Failed" << endl;
+        exit(0);
+    }
+
+    memcpy(a.green[0], a.redGray[0], (size_t)a.rows * a.cols);
+    memcpy(a.blue[0], a.redGray[0], (size_t)a.rows * a.cols);
+
+    transform(a);
+
+    img.alpha = a.redGray;
+
+    free2D(a.green, a.rows);
+    free2D(a.blue, a.rows);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Blends count values of one channel of the overlay over the same channel of an opaque image. The
+  * overlay value is premultiplied by its alpha a, and the image value keeps 255 - a of itself:
+  * dst = src * a / 255 + dst * (255 - a) / 255. With SSE2 16 values are blended at once in 16 bit
+  * lanes, dividing by 255 with shifts as in div255.
+  *
+  * @param[in,out] dst - the values of the image.
+  * @param[in] src - the values of the overlay.
+  * @param[in] a - the alpha values of the overlay.
+  * @param[in] count - the number of values.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel dst[1] = { 0 };
+    pixel src[1] = { 255 };
+    pixel a[1] = { 128 };
+
+    blendOpaque(dst, src, a, 1);
+
+    //dst is 128
+
+    @endverbatim
+
+  ***********************************************************************/
+static void blendOpaque(pixel* dst, const pixel* src, const pixel* a, int count)
+{
+    //loop variable
+    int j = 0;
+
+#ifdef PAM_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8((char)0xff);
+    const __m128i half = _mm_set1_epi16(128);
+    __m128i s, d, w, inv, lo, hi;
+
+    //the premultiplied overlay plus the share of the image left, divided by 255
+    auto blend = [&](__m128i s16, __m128i d16, __m128i w16, __m128i inv16)
+    {
+        __m128i p = _mm_add_epi16(_mm_mullo_epi16(s16, w16), half);
+        __m128i q = _mm_add_epi16(_mm_mullo_epi16(d16, inv16), half);
+
+        p = _mm_srli_epi16(_mm_add_epi16(p, _mm_srli_epi16(p, 8)), 8);
+        q = _mm_srli_epi16(_mm_add_epi16(q, _mm_srli_epi16(q, 8)), 8);
+
+        return _mm_add_epi16(p, q);
+    };
+
+    for (j = 0; j + 16 <= count; j += 16)
+    {
+        s = _mm_loadu_si128((const __m128i*)(src + j));
+        d = _mm_loadu_si128((const __m128i*)(dst + j));
+        w = _mm_loadu_si128((const __m128i*)(a + j));
+        inv = _mm_xor_si128(w, ones);
+
+        lo = blend(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(w, zero), _mm_unpacklo_epi8(inv, zero));
+        hi = blend(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(w, zero), _mm_unpackhi_epi8(inv, zero));
+
+        _mm_storeu_si128((__m128i*)(dst + j), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; j < count; j++)
+    {
+        dst[j] = (pixel)min(255, div255(src[j] * a[j]) + div255(dst[j] * (255 - a[j])));
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Blends count pixels of the overlay over an image that has an alpha channel of its own. The result
+  * covers alpha a + da * (255 - a) / 255, and each color is the premultiplied overlay plus the
+  * premultiplied image scaled by 255 - a, divided by that alpha, so the colors stay straight. Pixels
+  * that end up fully transparent are 0.
+  *
+  * @param[in,out] dst - the red, green, and blue values of the image.
+  * @param[in,out] da - the alpha values of the image.
+  * @param[in] src - the red, green, and blue values of the overlay.
+  * @param[in] a - the alpha values of the overlay.
+  * @param[in] count - the number of pixels.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    blendAlpha(dst, img.alpha[i] + j0, src, over.alpha[r] + k0, count);
+
+    @endverbatim
+
+  ***********************************************************************/
+static void blendAlpha(pixel* dst[3], pixel* da, const pixel* src[3], const pixel* a, int count)
+{
+    //loop variables
+    int j = 0;
+    int c = 0;
+
+    int outA = 0;
+    int keep = 0;
+
+    for (j = 0; j < count; j++)
+    {
+        keep = da[j] * (255 - a[j]);
+        outA = a[j] + div255(keep);
+
+        for (c = 0; c < 3; c++)
+        {
+            dst[c][j] = outA == 0 ? 0 : (pixel)min(255, (src[c][j] * a[j] * 255 + dst[c][j] * keep + outA * 255 / 2) / (outA * 255));
+        }
+
+        da[j] = (pixel)outA;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Stamps an overlay image onto the image with its top left corner at column x and row y, blending
+  * by the alpha channel of the overlay. Parts of the overlay outside the image are cut off, and x and y
+  * may be negative. An overlay without an alpha channel is opaque and its rows are copied. Only the
+  * rows the overlay covers are touched, and they are split across threads. Into an opaque image the
+  * values are blended with blendOpaque, 16 at a time with SSE2; into an image with an alpha channel of
+  * its own they are blended with blendAlpha, which also updates that alpha channel.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] over - the overlay.
+  * @param[in] x - the column of the image the left edge of the overlay is at.
+  * @param[in] y - the row of the image the top edge of the overlay is at.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    compositeImage(img, logo, img.cols - logo.cols, img.rows - logo.rows);
+
+    //the logo is stamped in the bottom right corner
+
+    @endverbatim
+
+  ***********************************************************************/
+void compositeImage(image& img, image& over, int x, int y)
+{
+    int rowStart = max(0, y);
+    int rowEnd = (int)min<long long>(img.rows, (long long)y + over.rows);
+    int colStart = max(0, x);
+    int colEnd = (int)min<long long>(img.cols, (long long)x + over.cols);
+    int count = colEnd - colStart;
+
+    if (rowStart >= rowEnd || count <= 0)
+    {
+        return;
+    }
+
+    parallelFor(rowStart, rowEnd, [&](int first, int last)
+    {
+        int i = 0;
+        int c = 0;
+        int r = 0;
+        int k = colStart - x;
+
+        pixel** dstPlanes[3] = { img.redGray, img.green, img.blue };
+        pixel** srcPlanes[3] = { over.redGray, over.green, over.blue };
+        pixel* dst[3];
+        const pixel* src[3];
+
+        for (i = first; i < last; i++)
+        {
+            r = i - y;
+
+            for (c = 0; c < 3; c++)
+            {
+                dst[c] = dstPlanes[c][i] + colStart;
+                src[c] = srcPlanes[c][r] + k;
+            }
+
+            //opaque, a plain copy
+            if (over.alpha == nullptr)
+            {
+                for (c = 0; c < 3; c++)
+                {
+                    memcpy(dst[c], src[c], count);
+                }
+
+                if (img.alpha != nullptr)
+                {
+                    memset(img.alpha[i] + colStart, 255, count);
+                }
+            }
+
+            else if (img.alpha == nullptr)
+            {
+                for (c = 0; c < 3; c++)
+                {
+                    blendOpaque(dst[c], src[c], over.alpha[r] + k, count);
+                }
+            }
+
+            else
+            {
+                blendAlpha(dst, img.alpha[i] + colStart, src, over.alpha[r] + k, count);
+            }
+        }
+    });
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the overlay file, which may be a PAM file with an alpha channel or any other image file, and
+  * stamps it onto the image at column x and row y with compositeImage. A grayscale image stays grayscale
+  * when the overlay is grayscale too, and otherwise has its gray copied into all three channels by
+  * spreadGray and becomes a color image. A black and white image is
+  * no longer black and white afterwards. If the file cannot be opened, a message is outputted and the
+  * program exits.
+  *
+  * @param[in,out] img - the image.
+  * @param[in] filename - the overlay file.
+  * @param[in] x - the column of the image the left edge of the overlay is at.
+  * @param[in] y - the row of the image the top edge of the overlay is at.
+  * @param[in,out] grayOutput - set to false if the result is no longer grayscale.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --overlay logo.pam 16,16 --binary stamped cats.ppm
+    overlayImage(img, "logo.pam", 16, 16, grayOutput);
+
+    @endverbatim
+
+  ***********************************************************************/
+void overlayImage(image& img, string filename, int x, int y, bool& grayOutput)
+{
+    ifstream fin;
+    image over;
+    int max_pix_val = 0;
+
+    if (!(openInputFile(fin, filename)))
+    {
+        cout << "Unable to open input file: " << filename << endl;
+        exit(0);
+    }
+
+    readMagicNum(fin, over, max_pix_val);
+
+    fin.clear();
+    fin.close();
+
+    //a grayscale image becoming a color image needs its gray in all three channels
+    if (grayOutput && over.magicNumber != "P2" && over.magicNumber != "P5" && !isBilevel(over))
+    {
+        spreadGray(img);
+        grayOutput = false;
+    }
+
+    compositeImage(img, over, x, y);
+
+    if (isBilevel(img))
+    {
+        img.magicNumber = grayOutput ? "P5" : "P6";
+    }
+
+    free2D(over.redGray, over.rows);
+    free2D(over.green, over.rows);
+    free2D(over.blue, over.rows);
+    free2D(over.alpha, over.rows);
+}
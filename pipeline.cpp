@@ -0,0 +1,350 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that read, manipulate, and write a batch of images in a pipeline
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of images each queue of the pipeline holds, two for double buffering.
+ */
+const size_t PIPELINE_QUEUE = 2;
+
+/**
+ * @brief Number of workers that apply the operations. Each operation already splits its work
+ *        across every thread, so two workers are enough to keep the threads busy between images.
+ */
+const int PIPELINE_WORKERS = 2;
+
+
+/**
+ * @brief An image on its way through the pipeline, with what is needed to write it.
+ */
+struct pipelineJob
+{
+    image img;                  /**< The image. */
+    int maxValue = 0;           /**< Maximum pixel value. */
+    bool grayOutput = false;    /**< True if the image is written as grayscale. */
+    string basename;            /**< The basename of the output file. */
+    string cacheKey;            /**< The key of the output in the --cache directory, empty without one. */
+};
+
+
+/**
+ * @brief A queue of jobs between two stages of the pipeline. A stage that pushes into a full
+ *        queue or pops from an empty one waits, so no stage gets more than capacity images ahead.
+ */
+struct jobQueue
+{
+    mutex lock;                     /**< Guards the rest of the queue. */
+    condition_variable changed;     /**< Signalled when a job is pushed or popped or a producer is done. */
+    deque<pipelineJob> jobs;        /**< The jobs waiting for the next stage. */
+    int producers = 1;              /**< Number of stages still pushing into the queue. */
+};
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Adds a job to the end of a queue, waiting while the queue holds PIPELINE_QUEUE jobs.
+  *
+  * @param[in,out] q - the queue.
+  * @param[in] job - the job to add.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    queuePush(decoded, job);
+
+    //job is the last job in decoded
+
+    @endverbatim
+
+  ***********************************************************************/
+static void queuePush(jobQueue& q, const pipelineJob& job)
+{
+    unique_lock<mutex> guard(q.lock);
+
+    q.changed.wait(guard, [&]() { return q.jobs.size() < PIPELINE_QUEUE; });
+
+    q.jobs.push_back(job);
+    q.changed.notify_all();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Takes the first job from a queue, waiting while the queue is empty. Returns false once the queue
+  * is empty and every stage that pushes into it is done.
+  *
+  * @param[in,out] q - the queue.
+  * @param[out] job - the job that was taken.
+  *
+  * @returns true if a job was taken
+  * @returns false if there are no more jobs
+  *
+  * @par Example:
+    @verbatim
+
+    while (queuePop(decoded, job))
+    {
+        //manipulate job.img
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+static bool queuePop(jobQueue& q, pipelineJob& job)
+{
+    unique_lock<mutex> guard(q.lock);
+
+    q.changed.wait(guard, [&]() { return !q.jobs.empty() || q.producers == 0; });
+
+    if (q.jobs.empty())
+    {
+        return false;
+    }
+
+    job = q.jobs.front();
+    q.jobs.pop_front();
+    q.changed.notify_all();
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Tells a queue that one of the stages that push into it is done. Once every one of them is done,
+  * the stage that pops from it stops when it is empty.
+  *
+  * @param[in,out] q - the queue.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    queueDone(decoded);
+
+    //the workers stop once they have taken every image
+
+    @endverbatim
+
+  ***********************************************************************/
+static void queueDone(jobQueue& q)
+{
+    lock_guard<mutex> guard(q.lock);
+
+    q.producers--;
+    q.changed.notify_all();
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the basename for the output of an input file: the name of the file without its extension,
+  * or its two extensions if it ends in .gz, followed by suffix. The file stays in the same folder.
+  *
+  * @param[in] filename - the name of the input file.
+  * @param[in] suffix - added to the name.
+  *
+  * @returns the basename of the output file
+  *
+  * @par Example:
+    @verbatim
+
+    string basename = batchBasename("photos\\cats.ppm", "_small");
+
+    //basename is photos\cats_small
+
+    @endverbatim
+
+  ***********************************************************************/
+static string batchBasename(string filename, string suffix)
+{
+    size_t dot = 0;
+    size_t slash = filename.find_last_of("/\\");
+
+    //a compressed file loses the .gz as well
+    if (filename.size() > 3 && filename.compare(filename.size() - 3, 3, ".gz") == 0)
+    {
+        filename.erase(filename.size() - 3);
+    }
+
+    dot = filename.rfind('.');
+
+    if (dot != string::npos && (slash == string::npos || dot > slash))
+    {
+        filename.erase(dot);
+    }
+
+    return filename + suffix;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Applies the same operations to every file of a batch and writes each result, with reading, the
+  * operations, and writing running at the same time as three stages:
+  *
+  * - The reader decodes one file after another and pushes each image into the decoded queue.
+  * - PIPELINE_WORKERS workers take images from the decoded queue, apply the operations, and push
+  *   them into the finished queue.
+  * - The writer takes images from the finished queue, outputs them, and frees them.
+  *
+  * Each queue holds at most PIPELINE_QUEUE images, so while one image is being manipulated the next one
+  * is already being read and the last one is being written, and memory stays bounded however long the
+  * batch is. The total time approaches the slowest stage instead of the sum of all three. Leading and
+  * trailing flips and rotations are fused into the reader and writer as they are for a single file.
+  * Files that cannot be opened are reported and skipped. With --cache, a file whose output is in the
+  * cache is copied out by the reader and never enters the pipeline, and every other output is added
+  * to the cache by the writer. With --checksum every output file gets a checksum file beside it.
+  *
+  * @param[in] ops - the operations from the command line.
+  * @param[in] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[in] suffix - added to the name of each input file to make the basename of its output.
+  * @param[in] files - the names of the input files.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --batch --thumbnail 256 --binary _small a.ppm b.ppm c.ppm
+    runBatch(ops, "--binary", "_small", files);
+
+    //a_small.ppm, b_small.ppm, and c_small.ppm are written
+
+    @endverbatim
+
+  ***********************************************************************/
+void runBatch(vector<operation> ops, string opType, string suffix, const vector<string>& files)
+{
+    //loop variable
+    int w = 0;
+
+    jobQueue decoded;
+    jobQueue finished;
+
+    int region[4] = { 0, 0, 0, 0 };
+    bool hasRegion = decodeRegion(ops, region);
+    int reduce = decodeReduce(ops);
+    string cacheDir;
+    bool cached = takeCacheDir(ops, cacheDir);
+    bool checksum = takeChecksum(ops);
+    vector<operation> keyOps = ops;
+    int decodeOrient = fuseDecodeOrientation(ops);
+    int encodeOrient = fuseEncodeOrientation(ops);
+
+    vector<thread> workers;
+
+    finished.producers = PIPELINE_WORKERS;
+
+    //reading stage
+    thread reader([&]()
+    {
+        size_t f = 0;
+        ifstream fin;
+        ofstream copy;
+        pipelineJob job;
+
+        setChecksum(copy, checksum);
+
+        for (f = 0; f < files.size(); f++)
+        {
+            job.basename = batchBasename(files[f], suffix);
+            job.cacheKey = cached ? cacheKey(files[f], keyOps, opType, job.basename) : "";
+
+            //an output from an earlier run is copied out of the cache, not made again
+            if (!job.cacheKey.empty() && cacheFetch(cacheDir, job.cacheKey, job.basename, copy))
+            {
+                continue;
+            }
+
+            if (!(openInputFile(fin, files[f])))
+            {
+                cout << "Unable to open input file: " << files[f] << endl;
+                continue;
+            }
+
+            job.img = image();
+
+            if (hasRegion)
+            {
+                readRegion(fin, job.img, job.maxValue, region, reduce, decodeOrient);
+            }
+
+            else
+            {
+                readMagicNum(fin, job.img, job.maxValue, reduce, decodeOrient);
+            }
+
+            fin.clear();
+            fin.close();
+
+            job.grayOutput = job.img.magicNumber == "P2" || job.img.magicNumber == "P5" || isBilevel(job.img);
+
+            queuePush(decoded, job);
+        }
+
+        queueDone(decoded);
+    });
+
+    //manipulating stage
+    for (w = 0; w < PIPELINE_WORKERS; w++)
+    {
+        workers.emplace_back([&]()
+        {
+            pipelineJob job;
+
+            while (queuePop(decoded, job))
+            {
+                applyOperations(job.img, ops, job.grayOutput);
+                queuePush(finished, job);
+            }
+
+            queueDone(finished);
+        });
+    }
+
+    //writing stage, on this thread
+    pipelineJob job;
+    ofstream fout;
+
+    setChecksum(fout, checksum);
+
+    while (queuePop(finished, job))
+    {
+        outputImage(fout, job.img, opType, job.basename, job.maxValue, job.grayOutput, encodeOrient);
+
+        if (!job.cacheKey.empty())
+        {
+            cacheStore(cacheDir, job.cacheKey, job.basename, fout);
+        }
+
+        free2D(job.img.redGray, job.img.rows);
+        free2D(job.img.green, job.img.rows);
+        free2D(job.img.blue, job.img.rows);
+        free2D(job.img.alpha, job.img.rows);
+    }
+
+    reader.join();
+
+    for (w = 0; w < PIPELINE_WORKERS; w++)
+    {
+        workers[w].join();
+    }
+}
@@ -0,0 +1,557 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains a streaming encoder and decoder for the lossless QOI image format
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of bytes of a QOI header: "qoif", the width, the height, the channels, and the colorspace.
+ */
+const int QOI_HEADER_BYTES = 14;
+
+/**
+ * @brief Number of bytes read from a QOI file at a time.
+ */
+const size_t QOI_CHUNK = 1 << 20;
+
+/**
+ * @brief The tags of the QOI chunks.
+ */
+const unsigned char QOI_OP_INDEX = 0x00;
+const unsigned char QOI_OP_DIFF = 0x40;
+const unsigned char QOI_OP_LUMA = 0x80;
+const unsigned char QOI_OP_RUN = 0xc0;
+const unsigned char QOI_OP_RGB = 0xfe;
+const unsigned char QOI_OP_RGBA = 0xff;
+const unsigned char QOI_MASK = 0xc0;
+
+/**
+ * @brief Longest run of one QOI_OP_RUN chunk.
+ */
+const int QOI_MAX_RUN = 62;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the position of a pixel in the table of recently seen pixels.
+  *
+  * @param[in] px - the pixel as red, green, blue, and alpha.
+  *
+  * @returns the position, 0 to 63
+  *
+  * @par Example:
+    @verbatim
+
+    unsigned char px[4] = { 0, 0, 0, 255 };
+
+    int k = qoiHash(px);
+
+    //k is 53
+
+    @endverbatim
+
+  ***********************************************************************/
+static int qoiHash(const unsigned char px[4])
+{
+    return (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Sets the state to the start of an image: the previous pixel is opaque black, the table of recently
+  * seen pixels is empty, and there is no run.
+  *
+  * @param[out] state - the state of the encoder or decoder.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    qoiState state;
+
+    qoiReset(state);
+
+    @endverbatim
+
+  ***********************************************************************/
+void qoiReset(qoiState& state)
+{
+    memset(state.index, 0, sizeof(state.index));
+
+    state.px[0] = state.px[1] = state.px[2] = 0;
+    state.px[3] = 255;
+    state.run = 0;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes the 14 byte header of a QOI file: "qoif", the width and height as 32 bit big endian numbers,
+  * 3 channels, and the sRGB colorspace.
+  *
+  * @param[in,out] out - the stream to write to.
+  * @param[in] cols - width of the image.
+  * @param[in] rows - height of the image.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    writeQoiHeader(fout, img.cols, img.rows);
+
+    @endverbatim
+
+  ***********************************************************************/
+void writeQoiHeader(ostream& out, int cols, int rows)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned char header[QOI_HEADER_BYTES] = { 'q', 'o', 'i', 'f' };
+
+    for (k = 0; k < 4; k++)
+    {
+        header[4 + k] = (unsigned char)((unsigned int)cols >> (24 - 8 * k));
+        header[8 + k] = (unsigned char)((unsigned int)rows >> (24 - 8 * k));
+    }
+
+    header[12] = 3;
+    header[13] = 0;
+
+    out.write((char*)header, QOI_HEADER_BYTES);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads the header of a QOI file from the start of the stream. If the file is a QOI file, the width and
+  * height are stored in img, the image is marked as a color image with the magic number P6 and no
+  * comment, the maximum pixel value is 255, and the stream is left at the first chunk. Otherwise the stream
+  * is put back at the start and false is returned, so the file can be read as a netPBM file. If alpha is
+  * given, it is set to true when the header says the file has 4 channels, red, green, blue, and alpha.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[out] img - a strucutre of type image.
+  * @param[out] max_pix_val - maximum value of a pixel.
+  * @param[out] alpha - set to true if the pixels have an alpha channel, or nullptr.
+  *
+  * @returns true if the file is a QOI file
+  * @returns false otherwise
+  *
+  * @par Example:
+    @verbatim
+
+    if (readQoiHeader(fin, img, max_pix_val))
+    {
+        //fin is at the first chunk of the pixels
+    }
+
+    @endverbatim
+
+  ***********************************************************************/
+bool readQoiHeader(ifstream& bfin, image& img, int& max_pix_val, bool* alpha)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned char header[QOI_HEADER_BYTES];
+    unsigned int cols = 0;
+    unsigned int rows = 0;
+
+    bfin.clear();
+    bfin.seekg(0, ios::beg);
+    bfin.read((char*)header, QOI_HEADER_BYTES);
+
+    if (bfin.gcount() < QOI_HEADER_BYTES || memcmp(header, "qoif", 4) != 0)
+    {
+        bfin.clear();
+        bfin.seekg(0, ios::beg);
+        return false;
+    }
+
+    for (k = 0; k < 4; k++)
+    {
+        cols = (cols << 8) | header[4 + k];
+        rows = (rows << 8) | header[8 + k];
+    }
+
+    if (cols == 0 || rows == 0 || cols > INT_MAX || rows > INT_MAX)
+    {
+        cout << "Invalid QOI Header" << endl;
+        exit(0);
+    }
+
+    img.magicNumber = "P6";
+    img.comment = "";
+    img.cols = (int)cols;
+    img.rows = (int)rows;
+    max_pix_val = 255;
+
+    if (alpha != nullptr)
+    {
+        *alpha = header[12] == 4;
+    }
+
+    return true;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Encodes count pixels, given as red, green, and blue values, and adds the chunks to out. Each pixel
+  * becomes the shortest chunk that describes it from the pixels before it:
+  *
+  * - a run of the previous pixel, up to 62 pixels in one byte,
+  * - the position of the pixel in the table of recently seen pixels, one byte,
+  * - a small difference from the previous pixel in each channel, one byte,
+  * - a difference in green with the red and blue differences relative to it, two bytes,
+  * - or the pixel itself, four bytes.
+  *
+  * The state carries over between calls, so an image can be encoded a band at a time and the output is
+  * the same as encoding it all at once. A run that is still open is written by qoiFinish.
+  *
+  * @param[in,out] state - the state of the encoder.
+  * @param[in] rgb - the pixels, three values each.
+  * @param[in] count - the number of pixels.
+  * @param[in,out] out - the chunks are added to the end.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    qoiReset(state);
+
+    qoiEncode(state, row.data(), img.cols, out);
+    ...
+    qoiFinish(state, out);
+
+    @endverbatim
+
+  ***********************************************************************/
+void qoiEncode(qoiState& state, const pixel* rgb, size_t count, vector<unsigned char>& out)
+{
+    //loop variable
+    size_t p = 0;
+
+    int k = 0;
+    int vr = 0;
+    int vg = 0;
+    int vb = 0;
+    int dr = 0;
+    int db = 0;
+
+    unsigned char* index = nullptr;
+
+    for (p = 0; p < count; p++, rgb += 3)
+    {
+        //the same pixel again
+        if (rgb[0] == state.px[0] && rgb[1] == state.px[1] && rgb[2] == state.px[2])
+        {
+            state.run++;
+
+            if (state.run == QOI_MAX_RUN)
+            {
+                out.push_back((unsigned char)(QOI_OP_RUN | (state.run - 1)));
+                state.run = 0;
+            }
+
+            continue;
+        }
+
+        if (state.run > 0)
+        {
+            out.push_back((unsigned char)(QOI_OP_RUN | (state.run - 1)));
+            state.run = 0;
+        }
+
+        //differences from the previous pixel, wrapping around
+        vr = (signed char)(rgb[0] - state.px[0]);
+        vg = (signed char)(rgb[1] - state.px[1]);
+        vb = (signed char)(rgb[2] - state.px[2]);
+
+        state.px[0] = rgb[0];
+        state.px[1] = rgb[1];
+        state.px[2] = rgb[2];
+
+        k = qoiHash(state.px);
+        index = state.index[k];
+
+        //seen recently
+        if (memcmp(index, state.px, 4) == 0)
+        {
+            out.push_back((unsigned char)(QOI_OP_INDEX | k));
+            continue;
+        }
+
+        memcpy(index, state.px, 4);
+
+        dr = vr - vg;
+        db = vb - vg;
+
+        if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1)
+        {
+            out.push_back((unsigned char)(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+        }
+
+        else if (vg >= -32 && vg <= 31 && dr >= -8 && dr <= 7 && db >= -8 && db <= 7)
+        {
+            out.push_back((unsigned char)(QOI_OP_LUMA | (vg + 32)));
+            out.push_back((unsigned char)((dr + 8) << 4 | (db + 8)));
+        }
+
+        else
+        {
+            out.push_back(QOI_OP_RGB);
+            out.push_back(rgb[0]);
+            out.push_back(rgb[1]);
+            out.push_back(rgb[2]);
+        }
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Ends an image: writes the run that is still open, if any, and the 8 byte end marker of a QOI file.
+  *
+  * @param[in,out] state - the state of the encoder.
+  * @param[in,out] out - the chunks are added to the end.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    qoiFinish(state, out);
+
+    fout.write((char*)out.data(), out.size());
+
+    @endverbatim
+
+  ***********************************************************************/
+void qoiFinish(qoiState& state, vector<unsigned char>& out)
+{
+    //loop variable
+    int k = 0;
+
+    if (state.run > 0)
+    {
+        out.push_back((unsigned char)(QOI_OP_RUN | (state.run - 1)));
+        state.run = 0;
+    }
+
+    for (k = 0; k < 7; k++)
+    {
+        out.push_back(0);
+    }
+
+    out.push_back(1);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Decodes up to count pixels from length bytes of chunks into rgb, three values per pixel, or four with
+  * the alpha of the pixel last when channels is 4. Only whole chunks are decoded, so when the bytes run
+  * out in the middle of a chunk, used tells the caller where to continue once more bytes have been read.
+  * A run that is longer than count carries over in the state to the next call.
+  *
+  * @param[in,out] state - the state of the decoder.
+  * @param[in] in - the chunks.
+  * @param[in] length - the number of bytes in.
+  * @param[out] used - the number of bytes of in that were decoded.
+  * @param[out] rgb - the pixels.
+  * @param[in] count - the most pixels to decode.
+  * @param[in] channels - 3 for red, green, and blue, 4 to add alpha.
+  *
+  * @returns the number of pixels decoded
+  *
+  * @par Example:
+    @verbatim
+
+    n = qoiDecode(state, bytes.data(), length, used, rgb.data(), img.cols);
+
+    //rgb holds n pixels, and bytes from used onwards still have to be decoded
+
+    @endverbatim
+
+  ***********************************************************************/
+size_t qoiDecode(qoiState& state, const unsigned char* in, size_t length, size_t& used, pixel* rgb, size_t count, int channels)
+{
+    size_t n = 0;
+    size_t p = 0;
+    size_t need = 0;
+
+    unsigned char b1 = 0;
+    unsigned char b2 = 0;
+    int vg = 0;
+
+    while (n < count)
+    {
+        //inside a run
+        if (state.run > 0)
+        {
+            state.run--;
+
+            memcpy(rgb, state.px, channels);
+            rgb += channels;
+            n++;
+
+            continue;
+        }
+
+        if (p >= length)
+        {
+            break;
+        }
+
+        //the whole chunk has to be there
+        b1 = in[p];
+        need = b1 == QOI_OP_RGB ? 4 : b1 == QOI_OP_RGBA ? 5 : (b1 & QOI_MASK) == QOI_OP_LUMA ? 2 : 1;
+
+        if (p + need > length)
+        {
+            break;
+        }
+
+        if (b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA)
+        {
+            memcpy(state.px, in + p + 1, need - 1);
+        }
+
+        else if ((b1 & QOI_MASK) == QOI_OP_INDEX)
+        {
+            memcpy(state.px, state.index[b1], 4);
+        }
+
+        else if ((b1 & QOI_MASK) == QOI_OP_DIFF)
+        {
+            state.px[0] += ((b1 >> 4) & 3) - 2;
+            state.px[1] += ((b1 >> 2) & 3) - 2;
+            state.px[2] += (b1 & 3) - 2;
+        }
+
+        else if ((b1 & QOI_MASK) == QOI_OP_LUMA)
+        {
+            b2 = in[p + 1];
+            vg = (b1 & 0x3f) - 32;
+
+            state.px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+            state.px[1] += vg;
+            state.px[2] += vg - 8 + (b2 & 0x0f);
+        }
+
+        else
+        {
+            state.run = (b1 & 0x3f) + 1;
+        }
+
+        p += need;
+        memcpy(state.index[qoiHash(state.px)], state.px, 4);
+
+        //a run is handed out at the top of the loop
+        if (state.run == 0)
+        {
+            memcpy(rgb, state.px, channels);
+            rgb += channels;
+            n++;
+        }
+    }
+
+    used = p;
+    return n;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Decodes the pixels of a QOI file and hands them to consume in order, a batch at a time, as red,
+  * green, and blue values, followed by alpha when channels is 4. The chunks are read QOI_CHUNK bytes at a time, and the bytes of a chunk cut
+  * off at the end of a read are moved to the front for the next one, so only one batch of the file is
+  * kept in memory. If the file ends early the missing values are handed over as 0.
+  *
+  * @param[in,out] bfin - the input file stream, at the first chunk.
+  * @param[in] pixels - the number of pixels to decode.
+  * @param[in] consume - called with each batch of values and the number of values in it.
+  * @param[in] channels - 3 for red, green, and blue, 4 to add alpha.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readQoiHeader(fin, img, max_pix_val);
+
+    streamQoiSamples(fin, (unsigned long long)img.rows * img.cols, [&](const pixel* samples, size_t count)
+    {
+        fout.write((const char*)samples, count);
+    });
+
+    //the pixels of a QOI file are written as the data of a P6 file
+
+    @endverbatim
+
+  ***********************************************************************/
+void streamQoiSamples(ifstream& bfin, unsigned long long pixels, const function<void(const pixel*, size_t)>& consume, int channels)
+{
+    unsigned long long done = 0;
+    size_t length = 0;
+    size_t used = 0;
+    size_t count = 0;
+    bool more = true;
+
+    qoiState state;
+    vector<unsigned char> bytes(QOI_CHUNK);
+    vector<pixel> samples((size_t)channels * QOI_CHUNK);
+
+    qoiReset(state);
+
+    while (done < pixels)
+    {
+        //topping up the bytes after the chunk that was cut off
+        if (more && length < QOI_CHUNK)
+        {
+            bfin.read((char*)bytes.data() + length, QOI_CHUNK - length);
+            length += (size_t)bfin.gcount();
+            more = (bool)bfin;
+        }
+
+        count = qoiDecode(state, bytes.data(), length, used,
+            samples.data(), (size_t)min<unsigned long long>(QOI_CHUNK, pixels - done), channels);
+
+        //the file ended early
+        if (count == 0 && !more)
+        {
+            count = (size_t)min<unsigned long long>(QOI_CHUNK, pixels - done);
+            fill(samples.begin(), samples.begin() + channels * count, 0);
+        }
+
+        memmove(bytes.data(), bytes.data() + used, length - used);
+        length -= used;
+
+        consume(samples.data(), channels * count);
+        done += count;
+    }
+}
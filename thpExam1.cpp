@@ -1,388 +1,536 @@
-/** *********************************************************************
- * @file
- *
- * @brief manipulates and outputs image data to a binary file. Contains function main.
- *        
- ***********************************************************************/
-
- /** ********************************************************************
-  *
-  * @mainpage Take Home Programming Exam 1
-  *
-  * @section course_section Course Information
-  *
-  * @authors Jonathan Mascarenhas
-  *
-  * @date Feburary 7, 2022
-  *
-  * @par Instructor:
-  *         Prof. Schrader
-  *
-  * @par Course:
-  *         CSC 215 - Section 2 - 2:00 pm 
-  *
-  * @par Location:
-  *         Classroom Building - Room 329
-  *
-  * @section program_section Program Information
-  *
-  * @details This program takes a binary file with ascii data or binary data as input
-  * and outputs the data in binary or ascii format to a binary file. The files contain 
-  * data that can be used to display an image in an image processing application like GIMP.
-  * 
-  * The main function provides the entry into the function. Arugments are passed to it through a command line terminal.
-  * After initialising all the required variables, a check for the correct number of arguments is made.
-  * If the number of arguments specified are greater than five or less than four, the program displays 
-  * a usage statement and exits. If the option or the output type is not entered correctly, a message is outputted
-  * to the terminal which specifies the valid options and the valid output types, and the program exits. 
-  * 
-  * The program has a file imageFileIO.cpp which has function definitions that handle all the input and output for 
-  * the program. Below is a brief description of what each function in imageFileIO.cpp does: <br>
-  * 
-  * <b>openInputFile</b> - opens the file passed to the function as a binary file. Returns true or false depending on 
-  * whether the file opened. <br>
-  * 
-  * <b>readMagicNum</b> - reads the magic number at the top of the file. Calls the functions readFileP3 or readFileP6 for the 
-  * magic numbers P3 and P6 respectively. If it is none of the above numbers, then a message for invalid magic number is 
-  * outputted and we exit the program. <br>
-  * 
-  * <b>readFileP3</b> - reads all the image data from the input file in ascii and stores it into the structure passed to 
-  * the function. <br>
-  * 
-  * <b>readFileP6</b> - reads all the image data from the input file in binary and stores it into the structure passed to 
-  * the function. <br> 
-  * 
-  * <b>outputP3</b> - outputs the image data stored in the structure in ascii format to the output file "basename.ppm". <br> 
-  * 
-  * <b>outputP6</b> - outputs the image data stored in the structure in binary format to the output file "basename.ppm". <br>
-  * 
-  * <b>outputGrayP2</b> - outputs the image data stored in the structure in ascii format to the output file "basename.pgm". <br>
-  * 
-  * <b>outputGrayP5</b> - outputs the image data stored in the structure in binary format to the output file "basename.pgm" <br>
-  * 
-  * <b>outputUsage</b> - outputs the usage statement to the terminal if there are incorrect arugments, wrong options, or wrong <br>
-  *                      output type that was was specified.
-  * 
-  * If there are only four arguments, input and output is performed using above functions. The ".ppm" extension specifies that 
-  * the file being read is in a binary format. <br>
-  * 
-  * However, if the number of arugments is five, that means an option was specified in the command line arguments. This is where 
-  * we use the functions in imageOperations.cpp to make changes to the <br>image data stored in the structure. Below is a brief 
-  * description of what each function in imageOperations.cpp does: <br>
-  * 
-  * <b>rotateClockwise</b> - rotates the image clockwise.  
-  * 
-  * <b>rotateCounterClockwise</b> - rotates the image counter clockwise. 
-  * 
-  * <b>flipX</b> - flips the image on the X axis. 
-  * 
-  * <b>flipY</b> - flips the image on the Y axis. 
-  * 
-  * <b>convertGrayScale</b> - converts the image to grayscale.
-  * 
-  * <b>convertSepia</b> - antiques an image.
-  * 
-  * We can only supply one option at a time. These functions rely heavily on dynamic memory allocation and freeing up memory
-  * that is allocated to temporary arrays. <br>To handle functions that deal with memory, a file called memory.cpp has been 
-  * created. Below are the functions defined in memory.cpp: 
-  * 
-  * <b>alloc2D</b> - allocates 2D dynamic arrays and returns the pointer to these arrays. Returns nullptr if memory failed 
-  * to allocate. 
-  * 
-  * <b>free2D</b> - frees up the memory that was allocated to a pointer. 
-  * 
-  * <b>copy2D</b> - has two 2D dynamic arrays passed to the function as arguments. 
-  * The function copies each element from the second array into the first array.
-  * 
-  * Once the conversion to the image is applied (if specified), then the same procedure to output the image is followed. 
-  * If the --grayscale option was specified as the second argument, then the outputGrayP2 or outputGrayP5 functions are
-  * called which output the image data in ascii and binary respectively. A P2 magic number for a grayscale means that it
-  * contains ascii image data and a P5 magic number for a grayscale means that it contains binary image data. <br>
-  * 
-  * After the data is ouputted to the file, the free2D function is called to free up the memory allocated to the pointers 
-  * img.redGray, img.green, and img.blue of the image structure. Both the input files and the output files are cleared 
-  * for any error flags and then closed. The main function returns a zero to end the program.
-  * 
-  * 
-  *
-  * @section compile_section Compiling and Usage
-  *
-  * @par Compiling Instructions:
-  *      None
-  *
-  * @par Usage:
-    @verbatim
-    c:\> thpExam1.exe [option] --outputtype basename image.ppm
-    d:\> c:\bin\thpExam1.exe [option] --outputtype basename image.ppm
-
-         Output Type 
-             --ascii                integer text numbers will be written for the data
-             --binary               integer numbers will be written in binary form
-
-         Option Code                Option Description
-             --flipX                Flip the image on the X axis
-             --flipY                Flip the image on the Y axis
-             --rotateCW             Rotate the image clockwise
-             --rotateCCW            Rotate the image counterclockwise
-             --grayscale            Convert the image to grayscale
-             --sepia                Antique a color image
-
-    @endverbatim
-  *
-  * @section todo_bugs_modification_section Todo, Bugs, and Modifications
-  *
-  * @bug Unsure how the program may respond to a failed memory allocation.
-  *      I have written the code to free up the memory and exit the program.
-  *
-  * 
-  * @todo 
-  *
-  * @par Modifications and Development Timeline:
-    
-    Gitlab commit log, <a href = "https://gitlab.cse.sdsmt.edu/101066570/
-    csc215s22programs/-/commits/main" target =_blank>
-    Click Here.</a>
-  *
-  ***********************************************************************/
-
-
-#include "netPBM.h"
-
-  /** *********************************************************************
-   * @author Jonathan Mascarenhas
-   *
-   * @par Description:
-   * The main function is the starting point for the program. It will take either four 
-   * or five arguments to execute the program. If there are four arguments, the first one 
-   * is the command required to execute the program, the second is the output type, the 
-   * third is the basename for the resulting image, and the fourth is the name of the 
-   * binary input file. --ascii and --binary are the two possibilities for the output type.
-   * 
-   * If there are five arguments, then the second argument is called option. It specifies 
-   * any modifications that can be made to the image before outputting it. --flipX, --flipY,
-   * --rotateCW, --rotateCCW, --grayscale, and --sepia are the allowed options.
-   * 
-   * Main calls a function called readMagicNum which extracts the magic number of the file. This 
-   * function calls more functions which end up storing the image data in the structure img of type
-   * image. If there are four arguments, the output is stored as either ascii and binary as specified.
-   * If there are five arguments, it means an option was specified. Main checks which option was specified
-   * and accordingly applies one of the functions in imageOperations.cpp on the image data as required. 
-   * Then the image is outputted in ascii or binary. outputGrayP2 and outputGrayP5 write to a .pgm file
-   * which stores data in ascii and binary respectively. 
-   * 
-   * The memory allocated to the 2D arrays in the structure is freed up using the free2D function. Following
-   * that, the input and output files are cleared of any error flags and then closed. Then the main function 
-   * returns a zero to end the program.
-   *
-   *
-   * @param[in] argc - the number of arguments from the command prompt.
-   * @param[in] argv - a 2d array of characters containing the arguments.
-   *
-   * @returns 0 after successful completion of the program
-   *
-   * @verbatim
-     see usage statement above.
-     @endverbatim
-   *
-   ***********************************************************************/
-
-int main(int argc, char** argv)
-{
-    //define all the variables here
-    string filename;
-    string option;
-    string opType;
-    ifstream fin;
-    ofstream fout;
-    string basename;
-
-    //maximum pixel value
-    int max_pix_val = 0;
-
-    //strucutre to store information
-    image img;
-
-        
-    //checking command line arguments
-    if (argc != 4 && argc != 5)
-    {
-        outputUsage();
-        exit(0);
-    }
-
-    //checking for valid command line options
-
-    //valid command line options for five arguments
-    if (argc == 5)
-    {
-        filename = argv[4];
-        option = argv[1];
-
-        //checking for valid options
-        if (option != "--flipX" && option != "--flipY" && option != "--rotateCW" && option != "--rotateCCW" && option != "--grayscale" && option != "--sepia")
-        {
-            outputUsage();
-
-            exit(0);
-        }
-
-        opType = argv[2];
-
-        //checking for valid output types
-        if (opType != "--ascii" && opType != "--binary")
-        {
-
-            outputUsage();
-            exit(0);
-        }
-
-    }
-
-    //valid command line arguments for four options
-    else 
-    {
-        filename = argv[3];
-
-        opType = argv[1];
-
-        if (opType != "--ascii" && opType != "--binary")
-        {
-
-            outputUsage();
-
-            exit(0);
-        }
-    }
-
-    //getting the basename 
-    if (argc == 4)
-    {
-        basename = argv[2];
-    }
-
-    else 
-    {
-        basename = argv[3];
-    }
-
-    
-    //check file opening 
-    if (!(openInputFile(fin, filename)))
-    {
-        cout << "Unable to open input file: " << filename << endl;
-        exit(0);
-    }
-
-
-    //reading through the file
-    readMagicNum(fin, img, max_pix_val);
-
-    //outputing to required file
-    if (argc == 4)
-    {
-        if (strcmp(argv[1], "--ascii") == 0)
-        {
-            
-            outputP3(fout, img, basename, max_pix_val);
-        }
-
-        else
-        {
-            
-            outputP6(fout, img, basename, max_pix_val);
-        }
-    }
-
-    else 
-    {
-        //Applying the image operations
-
-        //rotating clockwise
-        if (strcmp(argv[1], "--rotateCW") == 0)
-        {
-            
-            rotateClockWise(img);
-        }
-
-        //rotate counter clockwise
-        else if (strcmp(argv[1], "--rotateCCW") == 0)
-        {
-            
-            rotateCounterClockWise(img);
-        }
-
-        // flipX
-        else if (strcmp(argv[1], "--flipX") == 0)
-        {
-           
-            flipAxisX(img);
-        }
-
-        //flipY
-        else if (strcmp(argv[1], "--flipY") == 0)
-        {
-            
-            flipAxisY(img);
-        }
-
-        //sepia
-        else if (strcmp(argv[1], "--sepia") == 0)
-        {
-            
-            convertSepia(img);
-        }
-
-        //grayscale the only option left
-        else
-        {
-            convertGrayScale(img);
-
-        }
-
-        //outputting
-        // 
-        //outputting to grayscale and ascii speciied 
-        if (strcmp(argv[1], "--grayscale") == 0 && strcmp(argv[2], "--ascii") == 0)
-        {
-            
-            outputGrayP2(fout, img, basename, max_pix_val);
-        }
-
-        //grayscale and binary is specified
-        else if (strcmp(argv[1], "--grayscale") == 0 && strcmp(argv[2], "--binary") == 0)
-        {
-
-            
-            outputGrayP5(fout, img, basename, max_pix_val);
-        }        
-
-        //just output ascii
-        else if (strcmp(argv[2], "--ascii") == 0)
-        {
-            
-            outputP3(fout, img, basename, max_pix_val);
-        }
-
-        //just output image as itself in binary
-        else
-        {
-            
-            outputP6(fout, img, basename, max_pix_val);
-        }
-    }
-
-        
-    //freeing up the memory
-    free2D(img.redGray, img.rows);
-    free2D(img.green, img.rows);
-    free2D(img.blue, img.rows);
-
-    //clear files and close
-    fin.clear();
-    fin.close();
-    
-    fout.clear();
-    fout.close();
-
-    return 0;
-}
+/** *********************************************************************
+ * @file
+ *
+ * @brief manipulates and outputs image data to a binary file. Contains function main.
+ *        
+ ***********************************************************************/
+
+ /** ********************************************************************
+  *
+  * @mainpage Take Home Programming Exam 1
+  *
+  * @section course_section Course Information
+  *
+  * @authors Jonathan Mascarenhas
+  *
+  * @date Feburary 7, 2022
+  *
+  * @par Instructor:
+  *         Prof. Schrader
+  *
+  * @par Course:
+  *         CSC 215 - Section 2 - 2:00 pm 
+  *
+  * @par Location:
+  *         Classroom Building - Room 329
+  *
+  * @section program_section Program Information
+  *
+  * @details This program takes a binary file with ascii data or binary data as input
+  * and outputs the data in binary or ascii format to a binary file. The files contain 
+  * data that can be used to display an image in an image processing application like GIMP.
+  * 
+  * The main function provides the entry into the function. Arugments are passed to it through a command line terminal.
+  * After initialising all the required variables, a check for the correct number of arguments is made.
+  * If the number of arguments specified are greater than five or less than four, the program displays 
+  * a usage statement and exits. If the option or the output type is not entered correctly, a message is outputted
+  * to the terminal which specifies the valid options and the valid output types, and the program exits. 
+  * 
+  * The program has a file imageFileIO.cpp which has function definitions that handle all the input and output for 
+  * the program. Below is a brief description of what each function in imageFileIO.cpp does: <br>
+  * 
+  * <b>openInputFile</b> - opens the file passed to the function as a binary file. Returns true or false depending on 
+  * whether the file opened. <br>
+  * 
+  * <b>readMagicNum</b> - reads the magic number at the top of the file. Calls the functions readFileP3, readFileP6, 
+  * readFileP2, or readFileP5 for the magic numbers P3, P6, P2, and P5 respectively. If it is none of the above 
+  * numbers, then a message for invalid magic number is outputted and we exit the program. <br>
+  * 
+  * <b>readFileP3</b> - reads all the image data from the input file in ascii and stores it into the structure passed to 
+  * the function. <br>
+  * 
+  * <b>readFileP6</b> - reads all the image data from the input file in binary and stores it into the structure passed to 
+  * the function. <br> 
+  * 
+  * <b>readFileP2</b> and <b>readFileP5</b> - read grayscale ascii and binary files. All four readers can shrink the 
+  * image by an integer factor while it is read, which is used by the --reduce option to make previews. <br> 
+  * 
+  * <b>readRegion</b> - reads only a region of a binary file by seeking to the bytes of the region in each row. 
+  * Used by the --region option. <br> 
+  * 
+  * <b>outputP3</b> - outputs the image data stored in the structure in ascii format to the output file "basename.ppm". <br> 
+  * 
+  * <b>outputP6</b> - outputs the image data stored in the structure in binary format to the output file "basename.ppm". <br>
+  * 
+  * <b>outputGrayP2</b> - outputs the image data stored in the structure in ascii format to the output file "basename.pgm". <br>
+  * 
+  * <b>outputGrayP5</b> - outputs the image data stored in the structure in binary format to the output file "basename.pgm" <br>
+  * 
+  * <b>outputUsage</b> - outputs the usage statement to the terminal if there are incorrect arugments, wrong options, or wrong <br>
+  *                      output type that was was specified.
+  * 
+  * If there are only four arguments, input and output is performed using above functions. The ".ppm" extension specifies that 
+  * the file being read is in a binary format. <br>
+  * 
+  * However, if the number of arugments is five, that means an option was specified in the command line arguments. This is where 
+  * we use the functions in imageOperations.cpp to make changes to the <br>image data stored in the structure. Below is a brief 
+  * description of what each function in imageOperations.cpp does: <br>
+  * 
+  * <b>rotateClockwise</b> - rotates the image clockwise.  
+  * 
+  * <b>rotateCounterClockwise</b> - rotates the image counter clockwise. 
+  * 
+  * <b>flipX</b> - flips the image on the X axis. 
+  * 
+  * <b>flipY</b> - flips the image on the Y axis. 
+  * 
+  * <b>convertGrayScale</b> - converts the image to grayscale.
+  * 
+  * <b>convertSepia</b> - antiques an image.
+  * 
+  * More than one option can be supplied and they are applied from left to right.
+  * 
+  * The file imageResize.cpp adds resizing with a box, bilinear, or Lanczos-3 filter, integer factor
+  * downscaling, and thumbnails. The file imageWarp.cpp rotates images by any angle and applies affine
+  * warps with bilinear sampling.
+  * 
+  * The file imageView.cpp creates views into an image, which point at a region of the image with a row
+  * and column stride instead of copying it. Views are used to crop, and to limit an operation to a region
+  * of the image with --roi.
+  * 
+  * The file imageStats.cpp computes histograms, the minimum, maximum, and mean of each channel, and uses
+  * them for auto levels and histogram equalization. With --stats-only the statistics of a file are computed
+  * while it is read and no image is written. With --probe only the header of each file is read by
+  * probeHeader, and printed as a line of JSON by outputProbeJson.
+  * 
+  * The file imageTiled.cpp stores an image in tiles of 64 x 64 pixels, so that rotations and flips read
+  * and write memory that is close together. With --tiled the image is converted to tiles for the
+  * operations that have a tiled version, and back to rows before it is outputted. With --benchmark the
+  * operations in imageOperations.cpp are timed in both layouts by benchmark.cpp.
+  * 
+  * With --compare two files are read at the same time and compare.cpp reports the largest difference,
+  * the number of pixels that differ, and the PSNR and SSIM of each channel.
+  * 
+  * With --cache the output of every run is kept in a directory by cache.cpp, keyed by the xxHash64 of the
+  * input file from hash.cpp and the options, and a later run with the same key copies it out without
+  * reading the image; --cache-stats prints its hits and misses. With --checksum the CRC-32C of every
+  * output file is computed by hash.cpp while the file is written, and saved beside it in a file with
+  * .crc32c added.
+  * 
+  * With --fanout the file is read once and several outputs, each with its own options, output type, and
+  * basename, are written from it in parallel by fanout.cpp. With --batch the same options are applied to
+  * several files by pipeline.cpp, which reads the next file and writes the last one while the current one
+  * is manipulated.
+  * 
+  * When no options are given the file is only converted between ascii and binary, which transcode.cpp
+  * does by streaming the pixel values straight from the input file to the output file without storing
+  * the image, reading the next batch of values while the current one is written.
+  * 
+  * The output type --qoi writes the lossless compressed QOI format with the streaming encoder in qoi.cpp,
+  * and QOI files can be read anywhere a netPBM file can.
+  * 
+  * The output type --pam writes PAM files, and PAM files with an alpha channel can be read anywhere a
+  * netPBM file can, with the alpha channel moved along with the pixels by every operation. With --overlay
+  * an image is stamped onto the rows it covers by pam.cpp, blended by its alpha channel with SSE2.
+  * 
+  * With --threshold the image is made black and white by bilevel.cpp and written as P4 with 8 pixels to
+  * a byte, or as P1 for ascii, and P1 and P4 files can be read anywhere a netPBM file can.
+  * 
+  * With --palette, --ditherBayer, and --ditherFloyd the image is reduced to a few colors by
+  * imageQuantize.cpp, which picks the palette by median cut and k-means and dithers with the Bayer matrix
+  * or by error diffusion.
+  * 
+  * With --sobel and --scharr the image is replaced by the gradient magnitude of its edges, and with
+  * --sobelX and --sobelY by one signed gradient, by imageEdges.cpp, which slides a three row window down
+  * each strip with SSE2.
+  * 
+  * With --median, --erode, and --dilate each pixel is replaced by the median, minimum, or maximum of the
+  * square window around it by imageFilter.cpp, in a time per pixel that does not depend on the size of
+  * the window.
+  * 
+  * Files compressed with gzip are decompressed by gzip.cpp as they are read, and a basename ending in .gz
+  * writes a compressed file, with blocks of the output compressed in parallel.
+  * 
+  * The work in these functions is split into strips of rows by parallelFor in threads.cpp. These
+  * functions rely heavily on dynamic memory allocation and freeing up memory that is allocated to
+  * temporary arrays. <br>To handle functions that deal with memory, a file called memory.cpp has been
+  * created. Below are the functions defined in memory.cpp: 
+  * 
+  * <b>alloc2D</b> - allocates 2D dynamic arrays and returns the pointer to these arrays. Returns nullptr if memory failed 
+  * to allocate. 
+  * 
+  * <b>free2D</b> - frees up the memory that was allocated to a pointer. 
+  * 
+  * <b>copy2D</b> - has two 2D dynamic arrays passed to the function as arguments. 
+  * The function copies each element from the second array into the first array.
+  * 
+  * Once the conversion to the image is applied (if specified), then the same procedure to output the image is followed. 
+  * If the --grayscale option was specified as the second argument, then the outputGrayP2 or outputGrayP5 functions are
+  * called which output the image data in ascii and binary respectively. A P2 magic number for a grayscale means that it
+  * contains ascii image data and a P5 magic number for a grayscale means that it contains binary image data. <br>
+  * 
+  * After the data is ouputted to the file, the free2D function is called to free up the memory allocated to the pointers 
+  * img.redGray, img.green, and img.blue of the image structure. Both the input files and the output files are cleared 
+  * for any error flags and then closed. The main function returns a zero to end the program.
+  * 
+  * 
+  *
+  * @section compile_section Compiling and Usage
+  *
+  * @par Compiling Instructions:
+  *      None
+  *
+  * @par Usage:
+    @verbatim
+    c:\> thpExam1.exe [option]... --outputtype basename image.ppm
+    d:\> c:\bin\thpExam1.exe [option]... --outputtype basename image.ppm
+    c:\> thpExam1.exe --stats-only image.ppm
+    c:\> thpExam1.exe --probe image.ppm...
+    c:\> thpExam1.exe --benchmark image.ppm
+    c:\> thpExam1.exe --compare image.ppm other.ppm
+    c:\> thpExam1.exe --cache-stats dir
+    c:\> thpExam1.exe --fanout image.ppm [[option]... --outputtype basename]...
+    c:\> thpExam1.exe --batch [option]... --outputtype suffix image.ppm...
+
+         Output Type 
+             --ascii                integer text numbers will be written for the data
+             --binary               integer numbers will be written in binary form
+             --qoi                  lossless compressed pixels will be written to a .qoi file
+             --pam                  pixels and alpha will be written to a .pam file
+
+         Option Code                Option Description
+             --flipX                Flip the image on the X axis
+             --flipY                Flip the image on the Y axis
+             --rotateCW             Rotate the image clockwise
+             --rotateCCW            Rotate the image counterclockwise
+             --grayscale            Convert the image to grayscale
+             --sepia                Antique a color image
+             --resize WxH           Resize to W x H with the Lanczos-3 filter
+             --resizeBilinear WxH   Resize to W x H with the bilinear filter
+             --resizeBox WxH        Resize to W x H with the box filter
+             --thumbnail N          Shrink so the longest side is N pixels
+             --downscale N          Shrink by an integer factor N
+             --reduce N             Shrink by N while the file is read
+             --rotate DEG           Rotate clockwise by any angle in degrees
+             --affine a,b,c,d,e,f   Warp with the affine matrix [a b c; d e f]
+             --crop x,y,w,h         Keep only the w x h region at column x, row y
+             --roi x,y,w,h          Apply the next option to the region only
+             --region x,y,w,h       Read only the region from the file
+             --stats                Print the histogram and statistics of the image
+             --autoLevels           Stretch each channel to the full range
+             --equalize             Equalize the histogram of each channel
+             --tiled                Apply rotations, flips, and colors in 64 x 64 tiles
+             --threshold N          Black and white, with N and above white
+             --palette K            Reduce to K colors
+             --ditherBayer K        Reduce to K colors with ordered dithering
+             --ditherFloyd K        Reduce to K colors with error diffusion
+             --overlay F x,y        Stamp image F with its alpha at column x, row y
+             --sobel                Edges by gradient magnitude, Sobel kernel
+             --scharr               Edges by gradient magnitude, Scharr kernel
+             --sobelX               Horizontal gradient, 128 is flat
+             --sobelY               Vertical gradient, 128 is flat
+             --median R             Median of the (2R+1)x(2R+1) window
+             --erode R              Minimum of the (2R+1)x(2R+1) window
+             --dilate R             Maximum of the (2R+1)x(2R+1) window
+             --cache DIR            Reuse the output of the same run from DIR
+             --checksum             Write a CRC-32C of each output file beside it
+
+    @endverbatim
+  *
+  * @section todo_bugs_modification_section Todo, Bugs, and Modifications
+  *
+  * @bug Unsure how the program may respond to a failed memory allocation.
+  *      I have written the code to free up the memory and exit the program.
+  *
+  * 
+  * @todo 
+  *
+  * @par Modifications and Development Timeline:
+    
+    Gitlab commit log, <a href = "https://gitlab.cse.sdsmt.edu/101066570/
+    csc215s22programs/-/commits/main" target =_blank>
+    Click Here.</a>
+  *
+  ***********************************************************************/
+
+
+#include "netPBM.h"
+
+  /** *********************************************************************
+   * @author Jonathan Mascarenhas
+   *
+   * @par Description:
+   * The main function is the starting point for the program. The last three arguments are
+   * always the output type, the basename for the resulting image, and the name of the binary
+   * input file. --ascii and --binary are the two possibilities for the output type.
+   * 
+   * Any arguments before the output type are options. They specify modifications that are made
+   * to the image before outputting it, and are applied in the order they were given. Options
+   * such as --resize are followed by their own argument. The command line is checked by
+   * parseCommandLine.
+   * 
+   * Flips and rotations at the start of the options are handed to the reader, which stores each row of
+   * the file straight into its rotated or flipped place, and those at the end are handed to the writer,
+   * which outputs the pixels in rotated or flipped order.
+   * 
+   * Main calls a function called readMagicNum which extracts the magic number of the file. This 
+   * function calls more functions which end up storing the image data in the structure img of type
+   * image. The options are then applied with applyOperations, which calls the matching function in
+   * imageOperations.cpp, imageResize.cpp, imageWarp.cpp, or imageView.cpp. Then the image is outputted in ascii or binary. If the
+   * image was converted to grayscale, outputGrayP2 and outputGrayP5 write to a .pgm file which
+   * stores data in ascii and binary respectively. 
+   * 
+   * The memory allocated to the 2D arrays in the structure is freed up using the free2D function. Following
+   * that, the input and output files are cleared of any error flags and then closed. Then the main function 
+   * returns a zero to end the program.
+   *
+   *
+   * @param[in] argc - the number of arguments from the command prompt.
+   * @param[in] argv - a 2d array of characters containing the arguments.
+   *
+   * @returns 0 after successful completion of the program
+   *
+   * @verbatim
+     see usage statement above.
+     @endverbatim
+   *
+   ***********************************************************************/
+
+int main(int argc, char** argv)
+{
+    //define all the variables here
+    string filename;
+    string opType;
+    ifstream fin;
+    ofstream fout;
+    string basename;
+
+    //the options in the order they were given
+    vector<operation> ops;
+
+    //region of the file to read, x,y,w,h
+    int region[4] = { 0, 0, 0, 0 };
+
+    //set once the image has been converted to grayscale
+    bool grayOutput = false;
+
+    //flips and rotations done by the reader and by the writer
+    int decodeOrient = ORIENT_NONE;
+    int encodeOrient = ORIENT_NONE;
+
+    //maximum pixel value
+    int max_pix_val = 0;
+
+    //strucutre to store information
+    image img;
+
+    //statistics for --stats-only
+    imageStats stats;
+
+    //outputs of --fanout
+    vector<outputBranch> branches;
+
+    //suffix and input files of --batch
+    string suffix;
+    vector<string> files;
+
+    //header for --probe and its loop variable
+    imageHeader header;
+    int k = 0;
+
+    //directory and key of --cache
+    string cacheDir;
+    string key;
+
+        
+    //header only, for each file
+    if (argc >= 3 && string(argv[1]) == "--probe")
+    {
+        for (k = 2; k < argc; k++)
+        {
+            probeHeader(argv[k], header);
+            outputProbeJson(argv[k], header);
+        }
+
+        return 0;
+    }
+
+    //several outputs from one read of the file
+    if (argc >= 3 && string(argv[1]) == "--fanout")
+    {
+        if (!parseFanout(argc, argv, filename, branches))
+        {
+            outputUsage();
+            exit(0);
+        }
+
+        if (!(openInputFile(fin, filename)))
+        {
+            cout << "Unable to open input file: " << filename << endl;
+            exit(0);
+        }
+
+        readMagicNum(fin, img, max_pix_val);
+
+        runFanout(img, max_pix_val, img.magicNumber == "P2" || img.magicNumber == "P5" || isBilevel(img), branches);
+
+        fin.clear();
+        fin.close();
+
+        return 0;
+    }
+
+    //the same options for several files, read, manipulated, and written at the same time
+    if (argc >= 3 && string(argv[1]) == "--batch")
+    {
+        if (!parseBatch(argc, argv, ops, opType, suffix, files))
+        {
+            outputUsage();
+            exit(0);
+        }
+
+        runBatch(ops, opType, suffix, files);
+
+        return 0;
+    }
+
+    //timing the operations on rows and on tiles
+    if (argc == 3 && string(argv[1]) == "--benchmark")
+    {
+        runBenchmark(argv[2]);
+
+        return 0;
+    }
+
+    //how far apart two images are
+    if (argc == 4 && string(argv[1]) == "--compare")
+    {
+        runCompare(argv[2], argv[3]);
+
+        return 0;
+    }
+
+    //the counters of a cache directory
+    if (argc == 3 && string(argv[1]) == "--cache-stats")
+    {
+        printCacheStats(argv[2]);
+
+        return 0;
+    }
+
+    //statistics only, no image is written
+    if (argc == 3 && string(argv[1]) == "--stats-only")
+    {
+        filename = argv[2];
+
+        if (!(openInputFile(fin, filename)))
+        {
+            cout << "Unable to open input file: " << filename << endl;
+            exit(0);
+        }
+
+        streamStats(fin, stats);
+        printStats(stats);
+
+        fin.clear();
+        fin.close();
+
+        return 0;
+    }
+
+    //checking command line arguments, options, and output type
+    if (!parseCommandLine(argc, argv, ops, opType, basename, filename))
+    {
+        outputUsage();
+        exit(0);
+    }
+
+    //writing the checksum of the output file beside it
+    setChecksum(fout, takeChecksum(ops));
+
+    //copying the output of an earlier run with the same file, options, and output type
+    if (takeCacheDir(ops, cacheDir))
+    {
+        key = cacheKey(filename, ops, opType, basename);
+
+        if (!key.empty() && cacheFetch(cacheDir, key, basename, fout))
+        {
+            return 0;
+        }
+    }
+
+    //leading and trailing flips and rotations need no pass of their own
+    decodeOrient = fuseDecodeOrientation(ops);
+    encodeOrient = fuseEncodeOrientation(ops);
+
+    
+    //check file opening 
+    if (!(openInputFile(fin, filename)))
+    {
+        cout << "Unable to open input file: " << filename << endl;
+        exit(0);
+    }
+
+    //only converting between ascii and binary, no need to store the image
+    if (ops.empty() && decodeOrient == ORIENT_NONE && encodeOrient == ORIENT_NONE)
+    {
+        transcodeImage(fin, fout, opType, basename);
+
+        fin.clear();
+        fin.close();
+
+        if (!key.empty())
+        {
+            cacheStore(cacheDir, key, basename, fout);
+        }
+
+        return 0;
+    }
+
+
+    //reading only a region of the file if --region was given
+    if (decodeRegion(ops, region))
+    {
+        readRegion(fin, img, max_pix_val, region, decodeReduce(ops), decodeOrient);
+    }
+
+    //reading through the file, shrinking it while it is read if --reduce was given
+    else
+    {
+        readMagicNum(fin, img, max_pix_val, decodeReduce(ops), decodeOrient);
+    }
+
+    //grayscale and black and white files stay that way
+    if (img.magicNumber == "P2" || img.magicNumber == "P5" || isBilevel(img))
+    {
+        grayOutput = true;
+    }
+
+    //Applying the image operations in order
+    applyOperations(img, ops, grayOutput);
+
+    //outputting to a .pgm file if grayscale, a .ppm file otherwise
+    outputImage(fout, img, opType, basename, max_pix_val, grayOutput, encodeOrient);
+
+    //keeping the output for the next run with the same file, options, and output type
+    if (!key.empty())
+    {
+        cacheStore(cacheDir, key, basename, fout);
+    }
+
+        
+    //freeing up the memory
+    free2D(img.redGray, img.rows);
+    free2D(img.green, img.rows);
+    free2D(img.blue, img.rows);
+    free2D(img.alpha, img.rows);
+
+    //clear files and close
+    fin.clear();
+    fin.close();
+    
+    fout.clear();
+    fout.close();
+
+    return 0;
+}
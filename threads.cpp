@@ -0,0 +1,126 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   Splits image work into strips that run on multiple threads.
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Returns the number of threads that the image operations should use. This is the number
+  * of hardware threads reported by the system. If the system cannot report it, one is returned
+  * so that the work simply runs on the calling thread.
+  *
+  * @returns the number of worker threads to use
+  *
+  * @par Example:
+    @verbatim
+
+    int n = threadCount();
+
+    //n is 8 on a machine with 8 hardware threads
+
+    @endverbatim
+
+  ***********************************************************************/
+int threadCount()
+{
+    unsigned int count = thread::hardware_concurrency();
+
+    if (count == 0)
+    {
+        return 1;
+    }
+
+    return (int)count;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Splits the range [first, last) into one contiguous strip per thread and calls body on each
+  * strip with the first and one past the last index of that strip. The last strip is run on the
+  * calling thread while the others run on new threads, and the function returns once every strip
+  * is done. Strips never overlap, so a body that only writes to its own rows needs no locking.
+  * If the range is small or only one thread is available, body is called once with the whole range.
+  *
+  * @param[in] first - first index of the range.
+  * @param[in] last - one past the last index of the range.
+  * @param[in] body - function called with the bounds of each strip.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //invert every row of the red channel in parallel
+    parallelFor(0, img.rows, [&](int rowStart, int rowEnd)
+    {
+        for (int i = rowStart; i < rowEnd; i++)
+        {
+            for (int j = 0; j < img.cols; j++)
+            {
+                img.redGray[i][j] = 255 - img.redGray[i][j];
+            }
+        }
+    });
+
+    @endverbatim
+
+  ***********************************************************************/
+void parallelFor(int first, int last, const function<void(int, int)>& body)
+{
+    //loop variable
+    int i = 0;
+
+    //number of strips and their size
+    int count = 0;
+    int total = last - first;
+    int start = 0;
+    int end = 0;
+
+    vector<thread> workers;
+
+    if (total <= 0)
+    {
+        return;
+    }
+
+    count = threadCount();
+
+    if (count > total)
+    {
+        count = total;
+    }
+
+    //nothing to split
+    if (count <= 1)
+    {
+        body(first, last);
+        return;
+    }
+
+    //start all but the last strip on their own threads
+    for (i = 0; i < count - 1; i++)
+    {
+        start = first + (int)((long long)total * i / count);
+        end = first + (int)((long long)total * (i + 1) / count);
+
+        workers.emplace_back(body, start, end);
+    }
+
+    //the calling thread does the last strip
+    start = first + (int)((long long)total * (count - 1) / count);
+    body(start, last);
+
+    for (i = 0; i < (int)workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
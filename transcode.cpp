@@ -0,0 +1,699 @@
+/** *********************************************************************
+ * @file
+ *
+ * @brief   contains functions that convert between the ascii and binary formats without decoding the image
+ ***********************************************************************/
+
+#include "netPBM.h"
+
+/**
+ * @brief Number of bytes of the input file that each thread handles per batch of a transcode.
+ */
+const int TRANSCODE_CHUNK = 1 << 20;
+
+
+ /** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Counts the ascii numbers between text and end without converting them. A number starts at
+  * every digit that does not follow another digit. This is the fast first pass of a parallel parse,
+  * which tells each strip where its values go in the output.
+  *
+  * @param[in] text - the first character of the text. The character before it must be readable.
+  * @param[in] end - just after the last character of the text.
+  *
+  * @returns the number of numbers in the text
+  *
+  * @par Example:
+    @verbatim
+
+    const char text[] = " 255 0\n17\n";
+
+    size_t n = countSamples(text + 1, text + 10);
+
+    //n is 3
+
+    @endverbatim
+
+  ***********************************************************************/
+static size_t countSamples(const char* text, const char* end)
+{
+    size_t count = 0;
+    bool digit = false;
+    bool before = text[-1] >= '0' && text[-1] <= '9';
+
+    for (; text < end; text++)
+    {
+        digit = *text >= '0' && *text <= '9';
+
+        if (digit && !before)
+        {
+            count++;
+        }
+
+        before = digit;
+    }
+
+    return count;
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts the ascii numbers between text and end into pixel values and stores them one after
+  * another starting at samples, which must have room for countSamples of the same text. Anything
+  * that is not a digit separates the numbers. A minus sign right before a number makes it negative,
+  * which is then cast to a pixel the same way the ascii readers do it.
+  *
+  * @param[in] text - the first character of the text. The character before it must be readable.
+  * @param[in] end - just after the last character of the text.
+  * @param[out] samples - where the first pixel value is stored.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    const char text[] = " 255 0\n17\n";
+    pixel samples[3];
+
+    parseSamples(text + 1, text + 10, samples);
+
+    //samples contains 255, 0, and 17
+
+    @endverbatim
+
+  ***********************************************************************/
+static void parseSamples(const char* text, const char* end, pixel* samples)
+{
+    unsigned int value = 0;
+    bool negative = false;
+
+    while (text < end)
+    {
+        //skip to the next number
+        if (*text < '0' || *text > '9')
+        {
+            text++;
+            continue;
+        }
+
+        negative = text[-1] == '-';
+        value = 0;
+
+        while (text < end && *text >= '0' && *text <= '9')
+        {
+            value = value * 10 + (unsigned int)(*text - '0');
+            text++;
+        }
+
+        *samples++ = (pixel)(negative ? 0u - value : value);
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts pixel values into ascii text with one number per line, the same way outputP3 and
+  * outputGrayP2 write them.
+  *
+  * @param[in] samples - the first pixel value.
+  * @param[in] count - the number of pixel values.
+  * @param[out] text - the text.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    pixel samples[3] = { 255, 0, 17 };
+    string text;
+
+    formatSamples(samples, 3, text);
+
+    //text is "255\n0\n17\n"
+
+    @endverbatim
+
+  ***********************************************************************/
+static void formatSamples(const pixel* samples, size_t count, string& text)
+{
+    //loop variable
+    size_t i = 0;
+
+    char* out = nullptr;
+    int value = 0;
+
+    text.resize(count * 4);
+    out = &text[0];
+
+    for (i = 0; i < count; i++)
+    {
+        value = samples[i];
+
+        if (value >= 100)
+        {
+            *out++ = (char)('0' + value / 100);
+        }
+
+        if (value >= 10)
+        {
+            *out++ = (char)('0' + value / 10 % 10);
+        }
+
+        *out++ = (char)('0' + value % 10);
+        *out++ = '\n';
+    }
+
+    text.resize(out - &text[0]);
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Writes pixel values to the output file, as bytes for a binary file or as text for an ascii file.
+  * For an ascii file the values are split into one strip per thread, each strip is formatted in
+  * parallel, and the strips are written in order.
+  *
+  * @param[in,out] fout - the output file stream.
+  * @param[in] samples - the first pixel value.
+  * @param[in] count - the number of pixel values.
+  * @param[in] ascii - true to write text, false to write bytes.
+  * @param[in,out] texts - one buffer per strip, kept between calls so they are only allocated once.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    vector<string> texts(threadCount());
+
+    writeSamples(fout, samples.data(), samples.size(), true, texts);
+
+    //the samples are written one per line
+
+    @endverbatim
+
+  ***********************************************************************/
+static void writeSamples(ofstream& fout, const pixel* samples, size_t count, bool ascii, vector<string>& texts)
+{
+    //loop variable
+    size_t k = 0;
+
+    size_t strips = texts.size();
+
+    if (!ascii)
+    {
+        fout.write((const char*)samples, count);
+        return;
+    }
+
+    parallelFor(0, (int)strips, [&](int stripStart, int stripEnd)
+    {
+        int s = 0;
+        size_t first, last;
+
+        for (s = stripStart; s < stripEnd; s++)
+        {
+            first = count * s / strips;
+            last = count * (s + 1) / strips;
+
+            formatSamples(samples + first, last - first, texts[s]);
+        }
+    });
+
+    for (k = 0; k < strips; k++)
+    {
+        fout.write(texts[k].data(), texts[k].size());
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Reads total ascii pixel values from the stream and hands them to consume in order, a batch at a
+  * time, so only one batch of text is kept in memory. Each batch is TRANSCODE_CHUNK bytes of text per
+  * thread. The partial number at the end of a batch is carried over to the next one, and the rest is
+  * parsed in parallel in two passes:
+  *
+  * - The text is split into one strip per thread at whitespace, so no number is cut in two, and each
+  *   thread counts the numbers in its strip with countSamples.
+  * - The counts are added up to give the offset of each strip in the batch, and each thread parses its
+  *   strip with parseSamples straight into its offset.
+  *
+  * The next batch is read on its own thread while the current one is parsed and consumed, into a second
+  * buffer, so the disk and the processors are busy at the same time. Values past total are ignored. If
+  * the stream ends early the missing values are handed over as 0.
+  *
+  * @param[in,out] bfin - the input file stream, at the start of the image data.
+  * @param[in] total - the number of values to read.
+  * @param[in] consume - called with each batch of values and the number of values in it.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    readHeader(fin, img, max_pix_val);
+
+    streamAsciiSamples(fin, 3ull * img.rows * img.cols, [&](const pixel* samples, size_t count)
+    {
+        fout.write((const char*)samples, count);
+    });
+
+    //the pixel values of a P3 file are written as bytes
+
+    @endverbatim
+
+  ***********************************************************************/
+void streamAsciiSamples(ifstream& bfin, unsigned long long total, const function<void(const pixel*, size_t)>& consume)
+{
+    //loop variable
+    int k = 0;
+
+    unsigned long long done = 0;
+    size_t count = 0;
+    size_t length = 0;
+    size_t nextLength = 0;
+    size_t carry = 0;
+    size_t cut = 0;
+
+    int strips = threadCount();
+    size_t capacity = (size_t)TRANSCODE_CHUNK * strips;
+
+    //one batch is parsed while the next is read into the other buffer
+    int current = 0;
+    bool more = false;
+    bool nextMore = false;
+    bool reading = done < total && bfin;
+    thread reader;
+
+    //the text, with a space in front so every strip can look one character back
+    vector<char> text[2];
+    vector<pixel> samples;
+    vector<size_t> bounds(strips + 1);
+    vector<size_t> offsets(strips + 1);
+
+    //reads a batch into a buffer after the partial number carried over
+    auto readBatch = [&](vector<char>& buffer, size_t carried, size_t& filled, bool& good)
+    {
+        buffer.resize(carried + capacity + 1);
+        buffer[0] = ' ';
+        bfin.read(buffer.data() + 1 + carried, capacity);
+        filled = 1 + carried + (size_t)bfin.gcount();
+        good = (bool)bfin;
+    };
+
+    if (reading)
+    {
+        readBatch(text[current], 0, length, more);
+    }
+
+    while (reading)
+    {
+        vector<char>& batch = text[current];
+        vector<char>& next = text[1 - current];
+
+        //keep the partial number at the end for the next batch
+        cut = length;
+
+        if (more)
+        {
+            while (cut > 1 && !isspace((unsigned char)batch[cut - 1]))
+            {
+                cut--;
+            }
+
+            if (cut == 1)
+            {
+                cut = length;
+            }
+        }
+
+        //the partial number comes first in the next batch, which is read while this one is parsed
+        carry = length - cut;
+        next.resize(carry + 1);
+        memcpy(next.data() + 1, batch.data() + cut, carry);
+
+        if (more)
+        {
+            reader = thread(readBatch, ref(next), carry, ref(nextLength), ref(nextMore));
+        }
+
+        //split at whitespace, one strip per thread
+        bounds[0] = 1;
+        bounds[strips] = cut;
+
+        for (k = 1; k < strips; k++)
+        {
+            bounds[k] = max(bounds[k - 1], 1 + (cut - 1) * k / strips);
+
+            while (bounds[k] < cut && !isspace((unsigned char)batch[bounds[k]]))
+            {
+                bounds[k]++;
+            }
+        }
+
+        //first pass, count the numbers in each strip
+        parallelFor(0, strips, [&](int stripStart, int stripEnd)
+        {
+            int s = 0;
+
+            for (s = stripStart; s < stripEnd; s++)
+            {
+                offsets[s + 1] = countSamples(batch.data() + bounds[s], batch.data() + bounds[s + 1]);
+            }
+        });
+
+        offsets[0] = 0;
+
+        for (k = 0; k < strips; k++)
+        {
+            offsets[k + 1] += offsets[k];
+        }
+
+        //second pass, parse each strip into its place
+        samples.resize(offsets[strips]);
+
+        parallelFor(0, strips, [&](int stripStart, int stripEnd)
+        {
+            int s = 0;
+
+            for (s = stripStart; s < stripEnd; s++)
+            {
+                parseSamples(batch.data() + bounds[s], batch.data() + bounds[s + 1], samples.data() + offsets[s]);
+            }
+        });
+
+        //without going past the end of the image
+        count = (size_t)min<unsigned long long>(samples.size(), total - done);
+
+        if (count > 0)
+        {
+            consume(samples.data(), count);
+            done += count;
+        }
+
+        if (more)
+        {
+            reader.join();
+        }
+
+        reading = more && done < total;
+        length = nextLength;
+        more = nextMore;
+        current = 1 - current;
+    }
+
+    //the stream ended early
+    samples.assign(TRANSCODE_CHUNK, 0);
+
+    while (done < total)
+    {
+        count = (size_t)min<unsigned long long>(TRANSCODE_CHUNK, total - done);
+
+        consume(samples.data(), count);
+        done += count;
+    }
+}
+
+
+/** *********************************************************************
+  * @author Jonathan Mascarenhas
+  *
+  * @par Description:
+  * Converts a file between ascii, binary, and QOI without storing the image. This is what the command
+  * line with no options does, for example P3 to P6. The header is read with readQoiHeader or readHeader
+  * and written the same way the output functions write it. Color files become .ppm files and grayscale
+  * files .pgm files, or .qoi files for the output type --qoi. The pixel values are then streamed through
+  * two buffers of TRANSCODE_CHUNK bytes per thread, so the memory used does not depend on the size of
+  * the image:
+  *
+  * - Binary data is read a batch of bytes at a time, and either written as it is or formatted into text
+  *   in parallel strips.
+  * - Ascii data is read and parsed in parallel a batch at a time by streamAsciiSamples, and each batch
+  *   is written as bytes or formatted again.
+  * - QOI data is decoded a batch at a time by streamQoiSamples.
+  * - Black and white P1 and P4 data is read a batch of rows at a time by streamBilevelRows, and written
+  *   as P4 or P1 by writeBilevelRows, or as gray pixels to a QOI file.
+  *
+  * Batches written to a QOI file are encoded by qoiEncode, and the values of a pixel cut off at the end
+  * of a batch wait for the next one. For binary and ascii data the next batch is read into a second
+  * buffer on its own thread while the current one is converted and written, so reading and writing
+  * overlap. If the file ends early the missing values are written as 0. PAM files and the output type
+  * --pam are not streamed: the image is read with readMagicNum and written with outputImage, so the
+  * alpha channel is kept. If the magic number is not valid, a message is outputted and the program exits.
+  *
+  * @param[in,out] bfin - the input file stream.
+  * @param[out] fout - the output file stream.
+  * @param[in] opType - the output type, --ascii, --binary, --qoi, or --pam.
+  * @param[in] basename - name of the output file.
+  *
+  * @returns none
+  *
+  * @par Example:
+    @verbatim
+
+    //thpExam1.exe --binary catsBinary cats.ppm, where cats.ppm is a P3 file
+    transcodeImage(fin, fout, "--binary", "catsBinary");
+
+    //catsBinary.ppm is written as a P6 file
+
+    @endverbatim
+
+  ***********************************************************************/
+void transcodeImage(ifstream& bfin, ofstream& fout, string opType, string basename)
+{
+    //loop variable
+    size_t k = 0;
+
+    image img;
+    int max_pix_val = 0;
+    int channels = 0;
+    bool asciiIn = false;
+    bool qoiIn = false;
+    bool bilevel = false;
+    bool asciiOut = opType == "--ascii";
+    bool qoiOut = opType == "--qoi";
+
+    unsigned long long total = 0;
+    unsigned long long done = 0;
+    size_t count = 0;
+
+    int strips = threadCount();
+    size_t capacity = (size_t)TRANSCODE_CHUNK * strips;
+
+    //one batch is written while the next is read into the other buffer
+    int current = 0;
+    size_t nextCount = 0;
+    thread reader;
+
+    vector<pixel> bytes[2];
+    vector<string> texts(strips);
+
+    //QOI output, the values of pixels cut off at the end of a batch wait in pending
+    qoiState state;
+    vector<pixel> pending;
+    vector<unsigned char> chunks;
+    pixel scale[256];
+
+    //reads a batch of bytes, 0 past the end of the file
+    auto readBytes = [&](vector<pixel>& buffer, size_t n)
+    {
+        buffer.assign(n, 0);
+        bfin.read((char*)buffer.data(), n);
+    };
+
+    //writes a batch of values in the output type
+    auto emit = [&](const pixel* samples, size_t n)
+    {
+        size_t have = pending.size();
+        size_t whole = 0;
+
+        if (!qoiOut)
+        {
+            writeSamples(fout, samples, n, asciiOut, texts);
+            return;
+        }
+
+        pending.resize(have + n * (4 - channels));
+
+        for (k = 0; k < n; k++)
+        {
+            if (channels == 1)
+            {
+                pending[have + 3 * k] = pending[have + 3 * k + 1] = pending[have + 3 * k + 2] = scale[samples[k]];
+            }
+
+            else
+            {
+                pending[have + k] = scale[samples[k]];
+            }
+        }
+
+        whole = pending.size() / 3;
+        qoiEncode(state, pending.data(), whole, chunks);
+        pending.erase(pending.begin(), pending.begin() + 3 * whole);
+
+        if (chunks.size() >= TRANSCODE_CHUNK)
+        {
+            fout.write((char*)chunks.data(), chunks.size());
+            chunks.clear();
+        }
+    };
+
+    //PAM files and PAM output keep the alpha channel, so the image is read whole
+    bfin >> img.magicNumber;
+    bfin.clear();
+    bfin.seekg(0, ios::beg);
+
+    if (opType == "--pam" || img.magicNumber == "P7")
+    {
+        readMagicNum(bfin, img, max_pix_val);
+        outputImage(fout, img, opType, basename, max_pix_val, img.magicNumber == "P2" || img.magicNumber == "P5" || isBilevel(img),
+            ORIENT_NONE);
+
+        free2D(img.redGray, img.rows);
+        free2D(img.green, img.rows);
+        free2D(img.blue, img.rows);
+        free2D(img.alpha, img.rows);
+        return;
+    }
+
+    //reading in image header
+    qoiIn = readQoiHeader(bfin, img, max_pix_val);
+
+    if (!qoiIn)
+    {
+        readHeader(bfin, img, max_pix_val);
+    }
+
+    if (img.magicNumber == "P3" || img.magicNumber == "P6")
+    {
+        channels = 3;
+    }
+
+    else if (img.magicNumber == "P2" || img.magicNumber == "P5" || isBilevel(img))
+    {
+        channels = 1;
+    }
+
+    else
+    {
+        cout << "Invalid Magic Number" << endl;
+        exit(0);
+    }
+
+    bilevel = isBilevel(img);
+    asciiIn = img.magicNumber == "P3" || img.magicNumber == "P2" || img.magicNumber == "P1";
+    total = (unsigned long long)img.rows * img.cols * channels;
+
+    //opening the output file and writing the header
+    if (qoiOut)
+    {
+        openOutputFile(fout, basename, ".qoi", true);
+        writeQoiHeader(fout, img.cols, img.rows);
+
+        //values on a scale of 0 to 255
+        for (k = 0; k < 256; k++)
+        {
+            scale[k] = max_pix_val == 255 || max_pix_val <= 0 ? (pixel)k : (pixel)min<size_t>(255, (k * 255 + max_pix_val / 2) / max_pix_val);
+        }
+
+        qoiReset(state);
+    }
+
+    else if (bilevel)
+    {
+        openOutputFile(fout, basename, ".pbm", !asciiOut);
+
+        fout << (asciiOut ? "P1" : "P4") << "\n";
+        fout << img.comment;
+        fout << img.cols << " " << img.rows << "\n";
+    }
+
+    else
+    {
+        openOutputFile(fout, basename, channels == 3 ? ".ppm" : ".pgm", !asciiOut);
+
+        fout << (channels == 3 ? (asciiOut ? "P3" : "P6") : (asciiOut ? "P2" : "P5")) << "\n";
+        fout << img.comment;
+        fout << img.cols << " " << img.rows << "\n";
+        fout << max_pix_val << "\n";
+    }
+
+    //black and white data, a batch of rows at a time
+    if (bilevel)
+    {
+        streamBilevelRows(bfin, img, asciiIn, [&](const pixel* rows, int n)
+        {
+            if (qoiOut)
+            {
+                emit(rows, (size_t)n * img.cols);
+            }
+
+            else
+            {
+                writeBilevelRows(fout, rows, img.cols, n, asciiOut);
+            }
+        });
+    }
+
+    //QOI data, decoded a batch at a time
+    else if (qoiIn)
+    {
+        streamQoiSamples(bfin, (unsigned long long)img.rows * img.cols, emit);
+    }
+
+    //ascii data, parsed in parallel a batch at a time
+    else if (asciiIn)
+    {
+        streamAsciiSamples(bfin, total, emit);
+    }
+
+    //binary data, a batch of bytes at a time, 0 past the end of a short file
+    else
+    {
+        count = (size_t)min<unsigned long long>(capacity, total - done);
+        readBytes(bytes[current], count);
+
+        while (done < total)
+        {
+            //the next batch is read while this one is written
+            nextCount = (size_t)min<unsigned long long>(capacity, total - done - count);
+
+            if (nextCount > 0)
+            {
+                reader = thread(readBytes, ref(bytes[1 - current]), nextCount);
+            }
+
+            emit(bytes[current].data(), count);
+            done += count;
+
+            if (nextCount > 0)
+            {
+                reader.join();
+            }
+
+            count = nextCount;
+            current = 1 - current;
+        }
+    }
+
+    if (qoiOut)
+    {
+        qoiFinish(state, chunks);
+        fout.write((char*)chunks.data(), chunks.size());
+    }
+
+    closeOutputFile(fout);
+}